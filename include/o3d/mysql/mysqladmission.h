@@ -0,0 +1,154 @@
+/**
+ * @file mysqladmission.h
+ * @brief Adaptive concurrency limits of the statements per query.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#ifndef _O3D_MYSQLADMISSION_H
+#define _O3D_MYSQLADMISSION_H
+
+#include "mysql.h"
+
+#include <o3d/core/base.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+
+namespace o3d {
+namespace mysql {
+
+/**
+ * @brief MySqlAdmission limit the running statements of each query class (the name
+ * of the registered query) over every connection using it (see
+ * MySqlDb::setAdmission). The limit adapts by AIMD on the latency: increased by
+ * one per window of limit statements while the latency stays below tolerance
+ * times its baseline (the lowest latency seen, slowly following the changes),
+ * decreased by the backoff factor once above or on a timeout.
+ * A call over the limit waits in a bounded queue for at most maxWait, else it
+ * fails fast with E_MySqlOverload.
+ * Thread-safe.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ */
+class O3D_MYSQL_API MySqlAdmission
+{
+public:
+
+    struct Stats
+    {
+        Float limit;
+        UInt32 inFlight;
+        UInt32 queued;
+        Float latency;      //!< Smoothed latency in milliseconds
+        Float baseline;     //!< Baseline latency in milliseconds
+        UInt64 admitted;
+        UInt64 rejected;
+    };
+
+    /**
+     * @brief Admission of a statement for a scope. Without success the statement
+     * doesn't give a latency sample (error of the query itself).
+     */
+    class O3D_MYSQL_API Permit
+    {
+    public:
+
+        //! Wait for the admission, or raise E_MySqlOverload. A null admission admits.
+        Permit(MySqlAdmission *admission, const String &name);
+
+        ~Permit();
+
+        Permit(const Permit&) = delete;
+        Permit& operator= (const Permit&) = delete;
+
+        //! The statement succeeded, giving its latency.
+        void succeeded();
+
+        //! The statement timed out, the server being overloaded.
+        void overloaded();
+
+    private:
+
+        MySqlAdmission *m_admission;
+        const String &m_name;
+        std::chrono::steady_clock::time_point m_start;
+        Bool m_released;
+    };
+
+    /**
+     * @brief Admission control.
+     * @param initialLimit Initial limit of each class.
+     * @param maxLimit Max limit of each class.
+     * @param maxQueue Max waiting calls per class, 0 to never wait.
+     * @param maxWait Max wait in milliseconds.
+     */
+    MySqlAdmission(
+            UInt32 initialLimit = 8,
+            UInt32 maxLimit = 256,
+            UInt32 maxQueue = 64,
+            UInt32 maxWait = 50);
+
+    //! Min limit of each class (default 1).
+    void setMinLimit(UInt32 limit);
+
+    //! Latency over baseline ratio decreasing the limit (default 2).
+    void setTolerance(Float tolerance);
+
+    //! Factor applied to a decreased limit in ]0..1[ (default 0.9).
+    void setBackoff(Float backoff);
+
+    //! Get the state of a class.
+    Stats getStats(const String &name) const;
+
+private:
+
+    struct Class
+    {
+        Float limit;
+        UInt32 inFlight;
+        UInt32 queued;
+        UInt32 sinceDecrease;   //!< Completions since the last decrease
+
+        Float latency;
+        Float baseline;
+
+        UInt64 admitted;
+        UInt64 rejected;
+
+        std::condition_variable condition;
+    };
+
+    Float m_initialLimit;
+    Float m_minLimit;
+    Float m_maxLimit;
+
+    UInt32 m_maxQueue;
+    std::chrono::milliseconds m_maxWait;
+
+    Float m_tolerance;
+    Float m_backoff;
+
+    std::map<String, Class> m_classes;
+    mutable std::mutex m_mutex;
+
+    //! Get or create a class, the mutex being locked.
+    Class& getClass(const String &name);
+
+    void acquire(const String &name);
+
+    //! Release a slot, with a latency sample if positive, or as a timeout.
+    void release(const String &name, Float latency, Bool overloaded);
+
+    //! Decrease the limit, at most once per window.
+    void decrease(Class &c);
+};
+
+} // namespace mysql
+} // namespace o3d
+
+#endif // _O3D_MYSQLADMISSION_H
@@ -0,0 +1,88 @@
+/**
+ * @file mysqlarena.h
+ * @brief Bump allocator for the fetched row data.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#ifndef _O3D_MYSQLARENA_H
+#define _O3D_MYSQLARENA_H
+
+#include "mysql.h"
+
+#include <o3d/core/base.h>
+
+#include <vector>
+
+namespace o3d {
+namespace mysql {
+
+/**
+ * @brief MySqlArena allocates from a list of large blocks by moving a pointer.
+ * Nothing is freed individually: reset() makes the whole memory available again,
+ * keeping the blocks for the next use.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ */
+class O3D_MYSQL_API MySqlArena
+{
+public:
+
+    //! Default block size in bytes.
+    static const UInt32 DEFAULT_BLOCK_SIZE = 65536;
+
+    MySqlArena(UInt32 blockSize = DEFAULT_BLOCK_SIZE);
+
+    //! Release every block.
+    ~MySqlArena();
+
+    MySqlArena(const MySqlArena&) = delete;
+    MySqlArena& operator= (const MySqlArena&) = delete;
+
+    /**
+     * @brief Allocate a memory area valid until the next reset.
+     * @param size Size in bytes. A larger block than the default one is created
+     * for a bigger size.
+     * @param alignment Power of two.
+     */
+    UInt8* allocate(UInt32 size, UInt32 alignment = 1);
+
+    //! Make all the memory available again, without releasing the blocks.
+    void reset();
+
+    //! Release the blocks, except the first one.
+    void shrink();
+
+    //! Get the number of bytes allocated since the last reset.
+    inline UInt64 getUsedSize() const { return m_usedSize; }
+
+    //! Get the total size of the blocks.
+    inline UInt64 getReservedSize() const { return m_reservedSize; }
+
+    //! Get the default block size.
+    inline UInt32 getBlockSize() const { return m_blockSize; }
+
+private:
+
+    struct Block
+    {
+        UInt8 *data;
+        UInt32 size;
+        UInt32 used;
+    };
+
+    std::vector<Block> m_blocks;
+    size_t m_current;          //!< Index of the block used to allocate
+
+    UInt32 m_blockSize;
+
+    UInt64 m_usedSize;
+    UInt64 m_reservedSize;
+};
+
+} // namespace mysql
+} // namespace o3d
+
+#endif // _O3D_MYSQLARENA_H
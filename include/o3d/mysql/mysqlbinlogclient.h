@@ -0,0 +1,221 @@
+/**
+ * @file mysqlbinlogclient.h
+ * @brief Row changes read from the binary log, for cache invalidation.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#ifndef _O3D_MYSQLBINLOGCLIENT_H
+#define _O3D_MYSQLBINLOGCLIENT_H
+
+#include "mysql.h"
+#include "mysqlparams.h"
+
+#include <o3d/core/base.h>
+
+#include <mysql/mysql.h>
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace o3d {
+namespace mysql {
+
+class MySqlDb;
+
+/**
+ * @brief MySqlBinlogClient connect as a replica (mysql_binlog_open) and decode the
+ * row events of the binary log into changes (table, primary key, operation) given
+ * to the subscribers of the table, as soon as the server writes them.
+ * Needs binlog_format=ROW, the REPLICATION SLAVE privilege, and a server id
+ * unique among the replicas of the server. The key columns are given by their
+ * position in the table, the binary log not naming the columns. The signedness
+ * of the integer keys is read from the table map (binlog_row_metadata MINIMAL
+ * or FULL), else they are decoded as signed.
+ * The key columns must be in the before image of the rows: any column with
+ * binlog_row_image FULL, not a blob with NOBLOB, and only the primary key with
+ * MINIMAL. An unchanged key is absent from a minimal after image, the new key of
+ * an update is then the one of the before image.
+ * The rows of a table whose table map has not been read, as at the start of a
+ * stream opened in the middle of a transaction, are ignored.
+ * The connection is owned by the client, reading the stream from run or poll,
+ * while subscribe, unsubscribe and stop can be called from any thread. The
+ * callbacks are called by the thread reading the stream.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ */
+class O3D_MYSQL_API MySqlBinlogClient
+{
+public:
+
+    enum Operation
+    {
+        OP_INSERT = 0,
+        OP_UPDATE,
+        OP_DELETE
+    };
+
+    struct Change
+    {
+        Operation operation;
+        CString database;
+        CString table;
+        MySqlParams key;        //!< Key columns, in the order given at subscribe
+        MySqlParams newKey;     //!< Key after an update, same as key if unchanged
+    };
+
+    typedef std::function<void(const Change&)> Callback;
+
+    //! Position in the binary log.
+    struct Position
+    {
+        CString file;
+        UInt64 offset;
+    };
+
+    /**
+     * @brief Client over a connection.
+     * @param db Dedicated connection, with the password kept for stop.
+     * @param serverId Replica server id.
+     */
+    MySqlBinlogClient(MySqlDb *db, UInt32 serverId);
+
+    //! Close the stream if open.
+    ~MySqlBinlogClient();
+
+    MySqlBinlogClient(const MySqlBinlogClient&) = delete;
+    MySqlBinlogClient& operator= (const MySqlBinlogClient&) = delete;
+
+    /**
+     * @brief Call a function for each change of the rows of a table.
+     * @param keyColumns Positions (from 0) of the primary key columns in the table.
+     * @return Identifier of the subscription.
+     */
+    UInt32 subscribe(
+            const CString &database,
+            const CString &table,
+            const std::vector<UInt32> &keyColumns,
+            const Callback &callback);
+
+    //! Remove a subscription.
+    void unsubscribe(UInt32 id);
+
+    //! Heartbeat period in milliseconds while there is no event (default 1000).
+    inline void setHeartbeatPeriod(UInt32 ms) { m_heartbeatPeriod = ms; }
+
+    /**
+     * @brief Open the stream at a position, or at the current end of the binary
+     * log for an empty file name. Raises E_InvalidPrecondition if the binlog_format
+     * of the server is not ROW.
+     */
+    void open(const CString &file = "", UInt64 offset = 4);
+
+    //! Close the stream.
+    void close();
+
+    //! Is the stream open.
+    inline Bool isOpen() const { return m_open; }
+
+    /**
+     * @brief Read and dispatch the next event, waiting for it at most the
+     * heartbeat period.
+     * @return False once the stream ended (stop, server shutdown).
+     */
+    Bool poll();
+
+    //! Read and dispatch the events until stop.
+    void run();
+
+    //! Make run return, from any thread, cancelling the pending read.
+    void stop();
+
+    //! Get the position after the last event read.
+    Position getPosition() const;
+
+    /**
+     * @brief Decode and dispatch an event, header included, as read from the
+     * stream or from a binary log file.
+     */
+    void processEvent(const UInt8 *data, size_t size);
+
+    /**
+     * @brief Size of a value of a column in a row image.
+     * @param metadata Metadata of the column in its table map.
+     * @param pos Value, of which the length prefix is read.
+     * @param end End of the event, raising E_InvalidFormat if the value goes beyond.
+     */
+    static size_t valueSize(UInt8 type, UInt16 metadata, const UInt8 *pos, const UInt8 *end);
+
+private:
+
+    struct Subscription
+    {
+        CString database;
+        CString table;
+        std::vector<UInt32> keyColumns;
+        Callback callback;
+    };
+
+    //! Columns of a table, from its table map event.
+    struct TableMap
+    {
+        CString database;
+        CString table;
+        std::vector<UInt8> types;
+        std::vector<UInt16> metadata;
+        std::vector<Bool> unsignedColumns;
+    };
+
+    MySqlDb *m_db;
+    UInt32 m_serverId;
+    UInt32 m_heartbeatPeriod;
+
+    MYSQL_RPL m_rpl;
+    Bool m_open;
+    Bool m_stopping;
+
+    std::string m_file;
+    UInt64 m_offset;
+    UInt32 m_checksumSize;   //!< 4 with CRC32 event checksums
+    Bool m_minimalImage;     //!< binlog_row_image MINIMAL, only the primary key before
+
+    std::map<UInt64, TableMap> m_tables;    //!< Per table id
+
+    std::map<UInt32, Subscription> m_subscriptions;
+    UInt32 m_nextId;
+    mutable std::mutex m_mutex;
+
+    void readFormatDescription(const UInt8 *data, size_t size);
+    void readRotate(const UInt8 *data, size_t size);
+    void readTableMap(const UInt8 *data, size_t size);
+    void readRows(UInt8 type, const UInt8 *data, size_t size);
+
+    /**
+     * @brief Locate the values of a row image, null for the null or absent columns.
+     * @return Position after the image.
+     */
+    const UInt8* readImage(
+            const TableMap &table,
+            const std::vector<Bool> &present,
+            const UInt8 *pos,
+            const UInt8 *end,
+            std::vector<const UInt8*> &values) const;
+
+    //! Decode the key columns of a subscription from the located values.
+    void readKey(
+            const TableMap &table,
+            const std::vector<const UInt8*> &values,
+            const UInt8 *end,
+            const std::vector<UInt32> &keyColumns,
+            MySqlParams &key) const;
+};
+
+} // namespace mysql
+} // namespace o3d
+
+#endif // _O3D_MYSQLBINLOGCLIENT_H
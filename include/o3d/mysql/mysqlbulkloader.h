@@ -0,0 +1,182 @@
+/**
+ * @file mysqlbulkloader.h
+ * @brief LOAD DATA LOCAL INFILE fed by rows produced in memory.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#ifndef _O3D_MYSQLBULKLOADER_H
+#define _O3D_MYSQLBULKLOADER_H
+
+#include "mysql.h"
+
+#include <o3d/core/base.h>
+#include <o3d/core/date.h>
+#include <o3d/core/datetime.h>
+
+#include <mysql/mysql.h>
+
+#include <exception>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace o3d {
+namespace mysql {
+
+class MySqlDb;
+
+/**
+ * @brief MySqlBulkRow encode the fields of a row, in the order of the columns,
+ * to the text format of the loader.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ */
+class O3D_MYSQL_API MySqlBulkRow
+{
+public:
+
+    /**
+     * @brief Encode the fields of a row at the end of a buffer, without the line
+     * terminator. Any terminator found in a value is escaped.
+     */
+    MySqlBulkRow(std::string &buffer, Char fieldTerminator, Char lineTerminator);
+
+    void addNull();
+    void addBool(Bool v);
+    void addInt32(Int32 v);
+    void addUInt32(UInt32 v);
+    void addInt64(Int64 v);
+    void addUInt64(UInt64 v);
+    void addFloat(Float v);
+    void addDouble(Double v);
+    void addCString(const CString &v);
+    void addData(const UInt8 *data, UInt32 length);
+    void addDate(const Date &date);
+    void addTimestamp(const DateTime &date);
+
+    //! Get the number of fields of the current row.
+    inline UInt32 getNumFields() const { return m_numFields; }
+
+private:
+
+    std::string &m_buffer;
+
+    Char m_fieldTerminator;
+    Char m_lineTerminator;
+
+    UInt32 m_numFields;
+
+    void separator();
+    void addText(const Char *text, size_t length);
+    void addEscaped(const UInt8 *data, size_t length);
+};
+
+/**
+ * @brief MySqlBulkLoader load rows into a table using LOAD DATA LOCAL INFILE,
+ * without any file: a local infile handler streams the rows encoded on demand
+ * from a producer callback. Fields are escaped with a backslash.
+ * The connection must allow local infile (see MySqlConnectOptions::setLocalInfile)
+ * and the server too (local_infile=ON).
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ */
+class O3D_MYSQL_API MySqlBulkLoader
+{
+    friend class MySqlDb;
+
+public:
+
+    /**
+     * @brief Called for each row, add the fields of the row.
+     * @return False once there is no more row (any field added is then ignored).
+     */
+    typedef std::function<Bool(MySqlBulkRow&)> Producer;
+
+    enum Duplicates
+    {
+        DUPLICATES_ERROR = 0,   //!< Default for a local infile: ignored with a warning
+        DUPLICATES_REPLACE,     //!< REPLACE the existing rows
+        DUPLICATES_IGNORE       //!< IGNORE the new rows
+    };
+
+    struct Stats
+    {
+        UInt64 producedRows;    //!< Rows given by the producer
+        UInt64 loadedRows;      //!< Rows affected on the server
+        UInt32 warnings;        //!< Warnings count (skipped rows, truncated values...)
+        UInt64 bytes;           //!< Bytes sent
+        Double seconds;         //!< Duration of the load
+        Double rowsPerSecond;
+        CString info;           //!< Server info string (Records, Deleted, Skipped, Warnings)
+    };
+
+    /**
+     * @brief Loader into a table.
+     * @param columns Columns in the order of the fields, or empty for all in order.
+     */
+    MySqlBulkLoader(const CString &table, const std::vector<CString> &columns = std::vector<CString>());
+
+    //! Set the field terminator (tabulation by default).
+    inline void setFieldTerminator(Char c) { m_fieldTerminator = c; }
+
+    //! Set the line terminator (new line by default).
+    inline void setLineTerminator(Char c) { m_lineTerminator = c; }
+
+    //! Set the handling of the duplicate keys.
+    inline void setDuplicates(Duplicates duplicates) { m_duplicates = duplicates; }
+
+    //! Set the character set of the data (utf8mb4 by default).
+    inline void setCharset(const CString &charset) { m_charset = charset; }
+
+    //! Set the size of the chunks given to the client library.
+    inline void setChunkSize(UInt32 size) { m_chunkSize = size; }
+
+    //! Build the LOAD DATA statement.
+    CString getStatement() const;
+
+private:
+
+    CString m_table;
+    std::vector<CString> m_columns;
+
+    Char m_fieldTerminator;
+    Char m_lineTerminator;
+
+    Duplicates m_duplicates;
+    CString m_charset;
+
+    UInt32 m_chunkSize;
+
+    //! State of a running load, given to the infile handler.
+    struct Context
+    {
+        const MySqlBulkLoader *loader;
+        const Producer *producer;
+
+        std::string buffer;
+        size_t pos;
+        Bool eof;
+
+        UInt64 rows;
+        UInt64 bytes;
+
+        std::exception_ptr error;
+        std::string errorMessage;
+    };
+
+    //! Run the load on a connection.
+    Stats run(MYSQL *pDb, const Producer &producer) const;
+
+    static int infileInit(void **ptr, const char *filename, void *userdata);
+    static int infileRead(void *ptr, char *buf, unsigned int length);
+    static void infileEnd(void *ptr);
+    static int infileError(void *ptr, char *msg, unsigned int length);
+};
+
+} // namespace mysql
+} // namespace o3d
+
+#endif // _O3D_MYSQLBULKLOADER_H
@@ -0,0 +1,153 @@
+/**
+ * @file mysqlconnectoptions.h
+ * @brief Connection options profile of a MySqlDb.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#ifndef _O3D_MYSQLCONNECTOPTIONS_H
+#define _O3D_MYSQLCONNECTOPTIONS_H
+
+#include "mysql.h"
+
+#include <o3d/core/base.h>
+
+#include <mysql/mysql.h>
+
+namespace o3d {
+namespace mysql {
+
+/**
+ * @brief MySqlConnectOptions transport, compression, timeouts and buffers used
+ * by MySqlDb::connect. Zero values keep the defaults of the client library.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ */
+class O3D_MYSQL_API MySqlConnectOptions
+{
+public:
+
+    enum Transport
+    {
+        TRANSPORT_DEFAULT = 0,  //!< Unix socket for localhost, else TCP
+        TRANSPORT_TCP,          //!< Always TCP
+        TRANSPORT_SOCKET        //!< Unix socket (named pipe on Windows)
+    };
+
+    enum Compression
+    {
+        COMPRESSION_NONE = 0,
+        COMPRESSION_ZLIB,
+        COMPRESSION_ZSTD        //!< Needs a client and a server 8.0.18 or later, else zlib
+    };
+
+    //! Default options.
+    MySqlConnectOptions();
+
+    //! Set the transport.
+    inline void setTransport(Transport transport) { m_transport = transport; }
+
+    //! Get the transport.
+    inline Transport getTransport() const { return m_transport; }
+
+    //! Set the unix socket path, and the transport to TRANSPORT_SOCKET if not empty.
+    void setUnixSocket(const CString &path);
+
+    //! Get the unix socket path.
+    inline const CString& getUnixSocket() const { return m_unixSocket; }
+
+    /**
+     * @brief Set the protocol compression.
+     * @param level Compression level, only for zstd (1..22), 0 for default.
+     */
+    void setCompression(Compression compression, UInt32 level = 0);
+
+    //! Get the protocol compression.
+    inline Compression getCompression() const { return m_compression; }
+
+    //! Get the protocol compression level.
+    inline UInt32 getCompressionLevel() const { return m_compressionLevel; }
+
+    //! Set the connect timeout in seconds.
+    inline void setConnectTimeout(UInt32 seconds) { m_connectTimeout = seconds; }
+
+    //! Get the connect timeout in seconds.
+    inline UInt32 getConnectTimeout() const { return m_connectTimeout; }
+
+    //! Set the read timeout of each attempt in seconds (the client retries it up to 3 times).
+    inline void setReadTimeout(UInt32 seconds) { m_readTimeout = seconds; }
+
+    //! Get the read timeout in seconds.
+    inline UInt32 getReadTimeout() const { return m_readTimeout; }
+
+    //! Set the write timeout of each attempt in seconds (the client retries it up to 2 times).
+    inline void setWriteTimeout(UInt32 seconds) { m_writeTimeout = seconds; }
+
+    //! Get the write timeout in seconds.
+    inline UInt32 getWriteTimeout() const { return m_writeTimeout; }
+
+    //! Set the client flags (CLIENT_FOUND_ROWS, CLIENT_MULTI_STATEMENTS...).
+    //! Default to CLIENT_MULTI_RESULTS | CLIENT_PS_MULTI_RESULTS, required by CALL.
+    inline void setClientFlags(UInt32 flags) { m_clientFlags = flags; }
+
+    //! Get the client flags.
+    inline UInt32 getClientFlags() const { return m_clientFlags; }
+
+    //! Allow many statements in a single query string (CLIENT_MULTI_STATEMENTS).
+    void setMultiStatements(Bool enable);
+
+    //! Set the max size of a packet in bytes (max_allowed_packet).
+    inline void setMaxAllowedPacket(UInt32 size) { m_maxAllowedPacket = size; }
+
+    //! Get the max size of a packet in bytes.
+    inline UInt32 getMaxAllowedPacket() const { return m_maxAllowedPacket; }
+
+    //! Set the size of the network buffer in bytes (net_buffer_length).
+    inline void setNetBufferLength(UInt32 size) { m_netBufferLength = size; }
+
+    //! Get the size of the network buffer in bytes.
+    inline UInt32 getNetBufferLength() const { return m_netBufferLength; }
+
+    //! Set the connection character set (ie utf8mb4).
+    inline void setCharset(const CString &charset) { m_charset = charset; }
+
+    //! Get the connection character set.
+    inline const CString& getCharset() const { return m_charset; }
+
+    //! Allow LOAD DATA LOCAL INFILE, needed by MySqlDb::bulkLoad (the server must allow it too).
+    inline void setLocalInfile(Bool enable) { m_localInfile = enable; }
+
+    //! Is LOAD DATA LOCAL INFILE allowed.
+    inline Bool isLocalInfile() const { return m_localInfile; }
+
+    //! Set the options to a handle initialized by mysql_init, before connecting.
+    void apply(MYSQL *mysql) const;
+
+private:
+
+    Transport m_transport;
+    CString m_unixSocket;
+
+    Compression m_compression;
+    UInt32 m_compressionLevel;
+
+    UInt32 m_connectTimeout;
+    UInt32 m_readTimeout;
+    UInt32 m_writeTimeout;
+
+    UInt32 m_clientFlags;
+
+    UInt32 m_maxAllowedPacket;
+    UInt32 m_netBufferLength;
+
+    CString m_charset;
+
+    Bool m_localInfile;
+};
+
+} // namespace mysql
+} // namespace o3d
+
+#endif // _O3D_MYSQLCONNECTOPTIONS_H
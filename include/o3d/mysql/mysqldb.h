@@ -11,6 +11,13 @@
 #define _O3D_MYSQLDB_H
 
 #include "mysql.h"
+#include "mysqlconnectoptions.h"
+#include "mysqlresult.h"
+#include "mysqlarena.h"
+#include "mysqlrowset.h"
+#include "mysqlrowblock.h"
+#include "mysqlbulkloader.h"
+#include "mysqladmission.h"
 
 #include <o3d/core/database.h>
 #include <o3d/core/date.h>
@@ -19,6 +26,10 @@
 
 #include <mysql/mysql.h>
 
+#include <chrono>
+#include <mutex>
+#include <vector>
+
 namespace o3d {
 namespace mysql {
 
@@ -45,6 +56,10 @@ public:
  */
 class O3D_MYSQL_API MySqlDb : public Database
 {
+    friend class MySqlQuery;
+    friend class MySqlBinlogClient;
+    friend class MySqlReactor;
+
 public:
 
 	//! Default ctor
@@ -62,18 +77,122 @@ public:
         const String &password = "",
         Bool keepPassord = True);
 
+    //! Connect to a database using a specific options profile
+    Bool connect(
+        const String &host,
+        o3d::UInt32 port,
+        const String &database,
+        const String &user,
+        const String &password,
+        const MySqlConnectOptions &options,
+        Bool keepPassord = True);
+
+    //! Set the options profile used by the next connect.
+    inline void setConnectOptions(const MySqlConnectOptions &options) { m_options = options; }
+
+    //! Get the options profile.
+    inline const MySqlConnectOptions& getConnectOptions() const { return m_options; }
+
 	//! Disconnect from the database server
     virtual void disconnect();
 
 	//! Try to maintain the connection established
     virtual void pingConnection();
 
+    //! Ping the server. Return False if the connection is lost.
+    Bool ping();
+
+    /**
+     * @brief Return the connection to a clean state (mysql_reset_connection) without
+     * a new connection: rollback, temporary tables, locks and session variables
+     * are released, the charset being set again. The server closes the prepared
+     * statements, which are prepared again on their next execute.
+     */
+    void resetSession();
+
+    /**
+     * @brief Cancel the running query of this connection, from any thread, with
+     * a KILL QUERY sent over a side connection opened on the first cancel. The
+     * cancelled call fails and the connection remains usable. Needs the password
+     * to have been kept at connect, else raises E_InvalidPrecondition.
+     */
+    void cancel();
+
+    //! Is the password kept at connect, as needed by cancel and the query timeouts.
+    inline Bool isPasswordKept() const { return m_passwordKept; }
+
+    /**
+     * @brief Limit the concurrent statements of the queries of this connection,
+     * per query name, with an admission control shared by many connections.
+     * Not owned, null to disable (default).
+     */
+    inline void setAdmission(MySqlAdmission *admission) { m_admission = admission; }
+
+    //! Get the admission control, or null.
+    inline MySqlAdmission* getAdmission() const { return m_admission; }
+
+    /**
+     * @brief Get the replication delay of the server, when it is a replica.
+     * @return Delay in seconds, 0 if the server is not a replica, and -1 if the
+     * replication is not running.
+     */
+    Int32 getReplicationLag();
+
+    /**
+     * @brief Run a statement using the text protocol, without preparation.
+     * Costs a single round trip, for the one-off statements (DDL, admin, report).
+     * With CLIENT_MULTI_STATEMENTS (see MySqlConnectOptions::setMultiStatements)
+     * several statements separated by ';' are sent at once, and their results are
+     * iterated using MySqlResult::nextResult.
+     * @param sql Statement, with any value already escaped.
+     * @param buffered True to fetch every row at once (mysql_store_result), False
+     * to receive them while fetching (mysql_use_result).
+     * @return A new result to be deleted by the caller.
+     */
+    MySqlResult* executeDirect(const CString &sql, Bool buffered = True);
+
+    /**
+     * @brief Load rows into a table with LOAD DATA LOCAL INFILE, streamed from a
+     * producer without any temporary file. Needs the local infile option.
+     * @return Number of rows loaded, warnings and throughput.
+     */
+    MySqlBulkLoader::Stats bulkLoad(const MySqlBulkLoader &loader, const MySqlBulkLoader::Producer &producer);
+
 protected:
 
 	//! Instanciate a new DbQuery object
     virtual DbQuery* newDbQuery(const String &name, const CString &query);
 
+    /**
+     * @brief Set the connection parameters and initialize the handle with the
+     * options, before the connection.
+     * @return The port, given in the host or defaulted.
+     */
+    UInt32 prepareConnect(
+        const String &host,
+        o3d::UInt32 port,
+        const String &database,
+        const String &user,
+        const String &password,
+        Bool keepPassord);
+
+    //! Set the state of an established connection.
+    void connected(UInt32 port);
+
 	MYSQL *m_pDB;
+
+    MySqlConnectOptions m_options;
+
+    UInt32 m_sessionId;  //!< Incremented at each session reset
+
+    UInt32 m_port;
+    unsigned long m_threadId;   //!< Server thread of the connection
+
+    Bool m_passwordKept;        //!< For the side connection of cancel
+    MYSQL *m_cancelDB;          //!< Side connection of cancel
+    std::mutex m_cancelMutex;
+
+    MySqlAdmission *m_admission;
 };
 
 /**
@@ -84,12 +203,49 @@ protected:
 class O3D_MYSQL_API MySqlQuery : public DbQuery
 {
 	friend class MySqlDb;
+    friend class MySqlResult;
 
 public:
 
+    //! How the rows of a result set are received.
+    enum ExecuteMode
+    {
+        EXEC_STORE = 0,   //!< Whole result set read at execute (mysql_stmt_store_result), with seek
+        EXEC_STREAM,      //!< Rows read from the network at each fetch, without seek nor row count
+        EXEC_CURSOR       //!< Read only server side cursor, rows read by batches, without seek nor row count
+    };
+
 	//! Virtual destructor
 	virtual ~MySqlQuery();
 
+    /**
+     * @brief Set how the rows are received, for the next execute. In stream mode
+     * the connection can't be used by any other query until every row has been
+     * fetched, and the arena is reset at each fetch.
+     * In cursor mode the rows are kept by the server and sent by batches of the
+     * prefetch rows, other queries being able to use the connection between two
+     * fetches. The arena is also reset at each fetch. Only for a single SELECT.
+     */
+    inline void setExecuteMode(ExecuteMode mode) { m_executeMode = mode; }
+
+    //! Get how the rows are received.
+    inline ExecuteMode getExecuteMode() const { return m_executeMode; }
+
+    //! Set the number of rows read by batch in cursor mode (256 by default).
+    void setPrefetchRows(UInt32 rows);
+
+    //! Get the number of rows read by batch in cursor mode.
+    inline UInt32 getPrefetchRows() const { return m_prefetchRows; }
+
+    //! Get the name of the query.
+    inline const String& getName() const { return m_name; }
+
+    //! Get the number of outputs of the current result set.
+    inline UInt32 getNumOutputs() const { return (UInt32)m_outputs.getSize(); }
+
+    //! Get the name of an output.
+    CString getOutName(UInt32 attr) const;
+
     //! Set an input variable as ArrayUInt8. The array is duplicated.
     virtual void setArrayUInt8(UInt32 attr, const ArrayUInt8 &v);
 
@@ -129,6 +285,42 @@ public:
 	//! Set an input variable as Timestamp.
     virtual void setTimestamp(UInt32 attr, const DateTime &date);
 
+    /**
+     * @brief Bind an input to bytes of the caller, without copy. They must stay
+     * valid and unchanged until the next execute or update returned.
+     */
+    void bindArrayUInt8Ref(UInt32 attr, const UInt8 *data, UInt32 size);
+
+    //! Bind an input to an ArrayUInt8 of the caller, without copy.
+    inline void bindArrayUInt8Ref(UInt32 attr, const ArrayUInt8 &v) {
+        bindArrayUInt8Ref(attr, v.getData(), (UInt32)v.getSize());
+    }
+
+    //! A temporary would be destroyed before the execute.
+    void bindArrayUInt8Ref(UInt32 attr, ArrayUInt8 &&v) = delete;
+
+    //! Bind an input to a SmartArrayUInt8 of the caller, without copy.
+    inline void bindSmartArrayUInt8Ref(UInt32 attr, const SmartArrayUInt8 &v) {
+        bindArrayUInt8Ref(attr, v.getData(), v.getSizeInBytes());
+    }
+
+    //! A temporary would be destroyed before the execute.
+    void bindSmartArrayUInt8Ref(UInt32 attr, SmartArrayUInt8 &&v) = delete;
+
+    /**
+     * @brief Bind an input to a string of the caller, without copy. It must stay
+     * valid and unchanged until the next execute or update returned.
+     */
+    void bindCStringRef(UInt32 attr, const Char *data, UInt32 length);
+
+    //! Bind an input to a CString of the caller, without copy.
+    inline void bindCStringRef(UInt32 attr, const CString &v) {
+        bindCStringRef(attr, v.getData(), v.length());
+    }
+
+    //! A temporary would be destroyed before the execute.
+    void bindCStringRef(UInt32 attr, CString &&v) = delete;
+
     //! Get an output attribute id by its name.
     virtual UInt32 getOutAttr(const CString &name);
 
@@ -138,13 +330,98 @@ public:
     //! Get an output variable by its index.
     const DbVariable& getOut(UInt32 attr) const;
 
+    /**
+     * @brief Get the data of a string or blob output of the current row, without copy.
+     * In arena mode the data is complete, zero terminated for the strings, and
+     * remains valid until the next execute. Else it is valid until the next fetch,
+     * and truncated to the size of the bound buffer.
+     * @param length Receive the length in bytes, at most the size of the bound
+     * buffer out of arena mode.
+     * @return Null for a NULL value.
+     */
+    const UInt8* getOutData(UInt32 attr, UInt32 &length) const;
+
+    /**
+     * @brief Get the number of decimals of a DECIMAL output, 0 for any other type.
+     * A DECIMAL is returned as an Int64 fixed point value, scaled by 10^decimals.
+     */
+    UInt32 getOutDecimals(UInt32 attr) const;
+
+    /**
+     * @brief Decode the digits of a DECIMAL into a fixed point integer of the given
+     * scale, the decimals beyond the scale being truncated.
+     * @return False if not a number or out of the Int64 range.
+     */
+    static Bool decodeDecimal(const Char *text, size_t length, UInt32 scale, Int64 &value);
+
+    //! Decode the big endian bytes of a BIT value, keeping the last 64 bits.
+    static UInt64 decodeBit(const UInt8 *data, size_t length);
+
+    /**
+     * @brief Pack a date or a date time on 8 bytes, in the order of the dates, as
+     * stored by MySqlRowBlock, MySqlRowSet and the columnar export:
+     * year << 40 | month << 32 | day << 24 | hour << 16 | minute << 8 | second.
+     * A TIME duration (negative, or from 24 hours) raises E_InvalidResult.
+     */
+    static UInt64 packTime(const MYSQL_TIME &t);
+
+    /**
+     * @brief Enable or disable the arena mode. The strings and blobs of the result
+     * sets are then fetched at their full length into a single arena, reset at each
+     * execute, rather than each output resizing its own storage for each row.
+     * Their output variables are only filled when accessed with getOut.
+     * Must be set before execute.
+     * @param blockSize Size of the blocks of the arena.
+     */
+    void setArenaMode(Bool enable, UInt32 blockSize = MySqlArena::DEFAULT_BLOCK_SIZE);
+
+    //! Is the arena mode enabled.
+    inline Bool isArenaMode() const { return m_arena != nullptr; }
+
+    //! Get the arena or null if not in arena mode.
+    inline const MySqlArena* getArena() const { return m_arena; }
+
+    /**
+     * @brief Enable or disable the lazy conversion. The outputs needing a conversion
+     * after the fetch (strings, arrays, dates, DECIMAL and BIT) are then converted on
+     * their first access with getOut, rather than at each fetch.
+     */
+    inline void setLazyConversion(Bool lazy) { m_lazyConversion = lazy; }
+
+    //! Is the lazy conversion enabled.
+    inline Bool isLazyConversion() const { return m_lazyConversion; }
+
     //! Execute the query for a SELECT.
     virtual void execute();
 
     //! Execute the query for an UPDATE, INSERT, or DELETE.
     virtual void update();
 
+    /**
+     * @brief Execute the query for a SELECT, cancelled if still running after
+     * timeout milliseconds (0 for none), raising E_MySqlTimeout. A timeout raises
+     * E_InvalidPrecondition if the password of the connection has not been kept.
+     * The timeout covers the reading of the rows too: in stream mode the query is
+     * cancelled if its last row has not been fetched in time, and in cursor mode,
+     * the connection being shared between two fetches, a fetch past the timeout
+     * raises E_MySqlTimeout without cancelling.
+     */
+    void execute(UInt32 timeout);
+
+    //! Execute the query for an UPDATE, INSERT, or DELETE, with a timeout.
+    void update(UInt32 timeout);
+
+    //! Set the default timeout in milliseconds of execute and update (0 for none).
+    inline void setTimeout(UInt32 timeout) { m_timeout = timeout; }
+
+    //! Get the default timeout in milliseconds.
+    inline UInt32 getTimeout() const { return m_timeout; }
+
+    //! Cancel the running execute or update, from another thread.
+    void cancel();
+
     //! Get the number of affected or result rows after an execute or update.
+    //! Always 0 for a result set in stream mode.
     virtual UInt32 getNumRows();
 
     //! Get the result variable (ie for an auto increment).
@@ -157,6 +434,17 @@ public:
      */
     virtual Bool fetch();
 
+    /**
+     * @brief Fetch up to maxRows rows of the current result set at once into a block,
+     * cleared before. The values are read from the bound buffers, without going
+     * through the output variables, which are undefined after a batch.
+     * @return The number of rows read, 0 once every row has been read.
+     */
+    UInt32 fetchBatch(UInt32 maxRows, MySqlRowBlock &block);
+
+    //! Range over the batches of the remaining rows, for a range-for.
+    inline MySqlBatchRange batches(UInt32 batchSize) { return MySqlBatchRange(*this, batchSize); }
+
     //! Get the row position when fetching.
     virtual UInt32 tellRow();
 
@@ -166,17 +454,114 @@ public:
     //! Unbind the current input attributes.
     virtual void unbind();
 
+    /**
+     * @brief Pack the whole current result set into a new immutable rowset,
+     * independent of this query, which can be shared between threads and kept
+     * after the next execute. The fetch position is at the end once done.
+     * In stream mode only the remaining rows are packed.
+     */
+    std::shared_ptr<const MySqlRowSet> materialize();
+
+    /**
+     * @brief Append the columns and the rows of the current result set to a
+     * builder without columns, as materialize does, without build. With a builder
+     * in stream mode the rows go to its stream as they are fetched.
+     */
+    void materialize(MySqlRowSetBuilder &builder);
+
+    /**
+     * @brief Move to the next result set of a stored procedure CALL.
+     * The outputs are bound again to the shape of the new result set, and the
+     * previous one is released. The last result of a CALL only carries the
+     * status, without any column.
+     * @return False when there is no more result.
+     */
+    Bool nextResult();
+
+    //! Is the current result contains columns.
+    inline Bool hasResultSet() const { return m_outputs.getSize() > 0; }
+
+    //! Is the current result set contains the OUT and INOUT parameters of a CALL.
+    inline Bool isOutParams() const { return m_outParams; }
+
 protected:
 
 	//! Default ctor
 	MySqlQuery(
 		MYSQL *pDb,
 		const String &name,
-        const CString &query);
+        const CString &query,
+        MySqlDb *db = nullptr);
 
 	//! Prepare the query. Can do nothing if not preparation is needed
 	void prepareQuery();
 
+    //! Prepare again the statement closed by a session reset, keeping the inputs.
+    void reprepare();
+
+    //! Execute without timeout.
+    void executeStatement();
+
+    //! Update without timeout.
+    void updateStatement();
+
+    //! Bind the outputs to the current result set metadata.
+    void bindResult();
+
+    //! Bind and store the current result set, once executed.
+    void storeResult();
+
+    //! Read and discard the remaining results of the previous execution.
+    void drainResults();
+
+    //! Fetch the next row into the bound buffers, without any conversion.
+    Bool fetchRow();
+
+    //! Disarm the deadline of the current result. Return True if it passed.
+    Bool endDeadline();
+
+    //! Fetch the strings and blobs of the current row into the arena.
+    void fetchToArena();
+
+    struct Conversion;
+
+    //! Convert an output of the current row after its fetch.
+    typedef void (MySqlQuery::*Converter)(const Conversion &conversion) const;
+
+    //! Output needing a conversion after the fetch.
+    struct Conversion
+    {
+        UInt32 attr;
+        Converter convert;
+        Int32 decoded;     //!< Index of the decoded output or -1
+        Bool onAccess;     //!< Only converted on access, even if not lazy
+    };
+
+    //! Build the conversion plan of the bound outputs.
+    void buildConversionPlan();
+
+    //! Convert an output of the current row, if not already done.
+    inline void convertOutput(UInt32 attr) const
+    {
+        Int32 index = m_conversionIndex[attr];
+        if (index >= 0 && m_convertedStamp[attr] != m_rowStamp) {
+            runConversion(m_conversions[index]);
+        }
+    }
+
+    void runConversion(const Conversion &conversion) const;
+
+    void convertString(const Conversion &conversion) const;
+    void convertArray(const Conversion &conversion) const;
+    void convertDate(const Conversion &conversion) const;
+    void convertDateTime(const Conversion &conversion) const;
+    void convertDecimal(const Conversion &conversion) const;
+    void convertBit(const Conversion &conversion) const;
+    void convertFromArena(const Conversion &conversion) const;
+
+    //! Copy a string or blob of the current row from the arena to its output variable.
+    void copyFromArena(UInt32 attr) const;
+
     String m_name;
     CString m_query;
 
@@ -196,17 +581,59 @@ protected:
 	TemplateArray<MYSQL_BIND> m_result_bind;
 
     Bool m_needBind;
+    Bool m_outParams;        //!< Current result set contains the OUT parameters
+    Bool m_pendingResults;   //!< More results follow the current one
+    UInt32 m_resultIndex;    //!< Index of the current result set
+
+    ExecuteMode m_executeMode;
+    UInt32 m_prefetchRows;   //!< Rows per batch in cursor mode
+
+    MySqlArena *m_arena;                   //!< Non null in arena mode
+    std::vector<const UInt8*> m_arenaData; //!< Arena data of the current row, per output
+    UInt32 m_rowStamp;                     //!< Incremented at each fetched row
+
+    //! Output received as raw bytes and decoded after each fetch (DECIMAL, BIT).
+    struct DecodedOutput
+    {
+        UInt32 attr;
+        enum_field_types type;
+        UInt32 decimals;
+        unsigned long length;
+        Char buffer[72];     //!< Up to 65 digits, sign and point
+    };
+
+    std::vector<DecodedOutput> m_decodedOutputs;
+
+    Bool m_lazyConversion;
+    std::vector<Conversion> m_conversions;          //!< Only the outputs needing a conversion
+    std::vector<Int32> m_conversionIndex;           //!< Conversion of each output or -1
+    mutable std::vector<UInt32> m_convertedStamp;   //!< Row stamp of the last conversion, per output
 
     //MYSQL_RES *m_prepareMetaParam;
     MYSQL_RES *m_prepareMetaResult;
 
-    void mapType(DbVariable::VarType type, enum_field_types &mysqltype, unsigned long &mysqlsize);
+    MySqlDb *m_db;              //!< Connection, or null
+    UInt32 m_timeout;           //!< Default timeout of execute and update
+
+    UInt64 m_deadlineId;        //!< Watchdog deadline of a streamed result
+    Bool m_deadlineArmed;       //!< Until the last row of a streamed result
+    Bool m_cursorTimeout;       //!< Fetches of a cursor checked against m_cursorDeadline
+    std::chrono::steady_clock::time_point m_cursorDeadline;
+
+    const UInt32 *m_sessionId;  //!< Session of the connection, or null
+    UInt32 m_preparedSession;   //!< Session of the statement
+
+    //! Bind an input to the memory of the caller.
+    void bindRef(UInt32 attr, enum_field_types type, const void *data, UInt32 size);
+
+    static void mapType(DbVariable::VarType type, enum_field_types &mysqltype, unsigned long &mysqlsize);
 
-    void unmapType(
+    static void unmapType(
             enum_field_types mysqltype,
             UInt32 &maxSize,
             DbVariable::IntType &intType,
-            DbVariable::VarType &varType);
+            DbVariable::VarType &varType,
+            Bool isUnsigned = False);
 };
 
 } // namespace mysql
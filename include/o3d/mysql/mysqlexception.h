@@ -26,6 +26,26 @@ class O3D_MYSQL_API E_MySqlError : public E_BaseException
         O3D_E_DEF(E_MySqlError,"MySql error")
 };
 
+//! @class E_MySqlTimeout Query interrupted once its deadline passed
+class O3D_MYSQL_API E_MySqlTimeout : public E_MySqlError
+{
+    O3D_E_DEF_CLASS(E_MySqlTimeout)
+
+    //! Ctor
+    E_MySqlTimeout(const String& msg) : E_MySqlError(msg)
+        O3D_E_DEF(E_MySqlTimeout,"MySql query timeout")
+};
+
+//! @class E_MySqlOverload Call rejected by the admission control
+class O3D_MYSQL_API E_MySqlOverload : public E_MySqlError
+{
+    O3D_E_DEF_CLASS(E_MySqlOverload)
+
+    //! Ctor
+    E_MySqlOverload(const String& msg) : E_MySqlError(msg)
+        O3D_E_DEF(E_MySqlOverload,"MySql overload")
+};
+
 } // namespace mysql
 } // namespace o3d
 
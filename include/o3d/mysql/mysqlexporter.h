@@ -0,0 +1,171 @@
+/**
+ * @file mysqlexporter.h
+ * @brief Export of a query result to a CSV or a binary columnar file.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#ifndef _O3D_MYSQLEXPORTER_H
+#define _O3D_MYSQLEXPORTER_H
+
+#include "mysql.h"
+
+#include <o3d/core/base.h>
+#include <o3d/core/dbvariable.h>
+
+#include <ostream>
+#include <vector>
+
+namespace o3d {
+namespace mysql {
+
+class MySqlQuery;
+
+/**
+ * @brief MySqlExporter write the rows of a query as they are received from the
+ * server (stream mode, strings and blobs in arena mode) into a large buffer,
+ * flushed to the output when full. Values are formatted without any allocation.
+ *
+ * The columnar format is made of a header followed by row groups:
+ * - header: "O3DCOL" magic (8 bytes), version (u32), number of columns (u32),
+ *   and per column its DbVariable::IntType (u8), its decimals (u8, the scale of a
+ *   DECIMAL stored as a fixed point Int64) and its name (u32 length + bytes).
+ * - row group: number of rows (u32, 0 ends the file), and per column a null
+ *   bitmap ((rows + 7) / 8 bytes) followed by the values: fixed width little endian
+ *   values (1, 2, 4 or 8 bytes, dates packed on 8 bytes) or, for strings and blobs,
+ *   rows + 1 offsets (u32) and the data.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ */
+class O3D_MYSQL_API MySqlExporter
+{
+public:
+
+    enum Format
+    {
+        FORMAT_CSV = 0,     //!< RFC 4180 CSV, blobs as hexadecimal
+        FORMAT_COLUMNAR     //!< Typed binary row groups
+    };
+
+    struct Stats
+    {
+        UInt64 rows;
+        UInt64 bytes;
+        Double seconds;
+    };
+
+    /**
+     * @brief Rows to export, read one after the other. A query is exported through
+     * a source reading its outputs, another reader can give its own.
+     */
+    class O3D_MYSQL_API Source
+    {
+    public:
+
+        virtual ~Source() {}
+
+        //! Get the number of columns.
+        virtual UInt32 getNumColumns() const = 0;
+
+        //! Get the name of a column.
+        virtual CString getColumnName(UInt32 col) const = 0;
+
+        //! Get the scale of a DECIMAL column, given as a fixed point Int64.
+        virtual UInt32 getColumnDecimals(UInt32 col) const = 0;
+
+        //! Move to the next row. @return False after the last one.
+        virtual Bool next() = 0;
+
+        /**
+         * @brief Get the variable of a column, giving its type before the first
+         * row, and the value of the fixed size columns of the current row.
+         */
+        virtual const DbVariable& getOut(UInt32 col) const = 0;
+
+        //! Get a string or blob value of the current row, null for a NULL value.
+        virtual const UInt8* getOutData(UInt32 col, UInt32 &length) const = 0;
+    };
+
+    MySqlExporter(Format format = FORMAT_CSV);
+
+    //! Set the CSV field delimiter (comma by default).
+    inline void setDelimiter(Char delimiter) { m_delimiter = delimiter; }
+
+    //! Write the column names as first CSV line (default true).
+    inline void setHeader(Bool header) { m_header = header; }
+
+    //! Set the CSV text of a NULL value (empty by default).
+    inline void setNullText(const CString &text) { m_nullText = text; }
+
+    //! Set the size of the write buffer (1MB by default).
+    inline void setBufferSize(UInt32 size) { m_bufferSize = size; }
+
+    //! Set the number of rows per columnar row group (65536 by default).
+    inline void setRowGroupSize(UInt32 rows) { m_rowGroupSize = rows; }
+
+    /**
+     * @brief Execute the query, its parameters being set, and write its rows.
+     * The execute and arena modes of the query are restored once done.
+     */
+    Stats exportQuery(MySqlQuery &query, std::ostream &out);
+
+    //! Execute the query and write its rows into a new file.
+    Stats exportQuery(MySqlQuery &query, const String &filename);
+
+    //! Write the rows of a source, read from its first one, as for a query.
+    Stats exportSource(Source &source, std::ostream &out);
+
+    /**
+     * @brief Write a text as a CSV field, quoted if it contains the delimiter, a
+     * quote or a line break, the quotes being doubled.
+     */
+    void writeCsvField(const Char *text, size_t length, std::ostream &out);
+
+private:
+
+    Format m_format;
+
+    Char m_delimiter;
+    Bool m_header;
+    CString m_nullText;
+
+    UInt32 m_bufferSize;
+    UInt32 m_rowGroupSize;
+
+    std::ostream *m_out;
+    std::vector<Char> m_buffer;
+    UInt64 m_bytes;
+
+    //! Values of a column for the current row group.
+    struct ColumnData
+    {
+        UInt32 intType;
+        UInt32 width;               //!< 0 for strings and blobs
+        UInt32 decimals;            //!< Scale of a DECIMAL
+        std::vector<UInt8> nulls;
+        std::vector<UInt8> values;
+        std::vector<UInt32> offsets;
+    };
+
+    std::vector<ColumnData> m_columns;
+    UInt32 m_groupRows;
+
+    void write(const void *data, size_t size);
+    inline void put(Char c) { if (m_buffer.size() >= m_bufferSize) flush(); m_buffer.push_back(c); }
+    void flush();
+
+    UInt64 writeCsv(Source &source);
+    UInt64 writeColumnar(Source &source);
+
+    void csvText(const Char *text, size_t length);
+    void csvValue(const Source &source, UInt32 attr);
+
+    void flushRowGroup();
+};
+
+} // namespace mysql
+} // namespace o3d
+
+#endif // _O3D_MYSQLEXPORTER_H
@@ -0,0 +1,116 @@
+/**
+ * @file mysqlkeepalive.h
+ * @brief Background ping of the idle connections.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#ifndef _O3D_MYSQLKEEPALIVE_H
+#define _O3D_MYSQLKEEPALIVE_H
+
+#include "mysql.h"
+
+#include <o3d/core/base.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <random>
+#include <thread>
+
+namespace o3d {
+namespace mysql {
+
+class MySqlDb;
+
+/**
+ * @brief MySqlKeepAlive ping from a background thread the connections given while
+ * they are idle, so the server never drops them (wait_timeout) and the first
+ * query after an idle period doesn't pay a new connection.
+ * The interval of each connection is randomized by the jitter, to spread the
+ * pings of many connections added at once.
+ * A connection is owned by the keep alive between add and remove, and must not
+ * be used meanwhile.
+ * The thread is registered to the client library (mysql_thread_init) for its
+ * whole life.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ */
+class O3D_MYSQL_API MySqlKeepAlive
+{
+public:
+
+    struct Stats
+    {
+        UInt64 pings;
+        UInt64 failures;
+    };
+
+    /**
+     * @brief Start the thread.
+     * @param interval Delay in milliseconds between two pings of a connection,
+     * to be lower than the wait_timeout of the server.
+     * @param jitter Fraction of the interval randomly added or removed (0 to 1).
+     */
+    MySqlKeepAlive(UInt32 interval = 60000, Float jitter = 0.2f);
+
+    //! Stop the thread. The remaining connections are neither closed nor deleted.
+    ~MySqlKeepAlive();
+
+    MySqlKeepAlive(const MySqlKeepAlive&) = delete;
+    MySqlKeepAlive& operator= (const MySqlKeepAlive&) = delete;
+
+    //! Give an idle connection, pinged until it is removed.
+    void add(MySqlDb *db);
+
+    /**
+     * @brief Take back a connection, waiting for its ping if one is running.
+     * @return False if its last ping failed, the connection being lost.
+     */
+    Bool remove(MySqlDb *db);
+
+    //! Get the number of idle connections.
+    UInt32 getNumConnections() const;
+
+    //! Get the number of pings done and failed.
+    Stats getStats() const;
+
+private:
+
+    typedef std::chrono::steady_clock Clock;
+
+    struct Entry
+    {
+        Clock::time_point nextPing;
+        Bool busy;      //!< Ping running
+        Bool alive;     //!< Result of the last ping
+    };
+
+    std::chrono::milliseconds m_interval;
+    Float m_jitter;
+
+    std::map<MySqlDb*, Entry> m_connections;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;
+
+    std::thread m_thread;
+    Bool m_running;
+
+    std::mt19937 m_random;
+
+    Stats m_stats;
+
+    //! Next ping time from now, randomized.
+    Clock::time_point nextPing();
+
+    void run();
+};
+
+} // namespace mysql
+} // namespace o3d
+
+#endif // _O3D_MYSQLKEEPALIVE_H
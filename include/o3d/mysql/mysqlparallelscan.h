@@ -0,0 +1,110 @@
+/**
+ * @file mysqlparallelscan.h
+ * @brief Table scan split into primary key ranges read over many connections.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#ifndef _O3D_MYSQLPARALLELSCAN_H
+#define _O3D_MYSQLPARALLELSCAN_H
+
+#include "mysqlrowset.h"
+#include "mysqlworkerpool.h"
+
+#include <functional>
+#include <vector>
+
+namespace o3d {
+namespace mysql {
+
+class MySqlDb;
+
+/**
+ * @brief MySqlParallelScan read a whole table by ranges of its integer primary key.
+ * The range between the min and max keys is split into chunks, read concurrently,
+ * one connection per worker, each chunk being streamed from the server into a
+ * rowset, without a client side copy of its whole result set.
+ * Chunks are delivered to the consumer from the calling thread, as soon as they are
+ * ready, or in primary key order when ordered.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ */
+class O3D_MYSQL_API MySqlParallelScan
+{
+public:
+
+    /**
+     * @brief Receive the rows of a chunk.
+     * @param chunk Index of the chunk, in primary key order.
+     */
+    typedef std::function<void(UInt32 chunk, const MySqlRowSet &rows)> Consumer;
+
+    struct Stats
+    {
+        Int64 minKey;
+        Int64 maxKey;
+        UInt32 numChunks;
+        UInt64 numRows;
+        Double seconds;
+    };
+
+    /**
+     * @brief Scan using a set of connections, none of them being used elsewhere
+     * during the scan.
+     * @param pool Workers to use, or null to create a pool of one thread per connection.
+     */
+    MySqlParallelScan(const std::vector<MySqlDb*> &connections, MySqlWorkerPool *pool = nullptr);
+
+    ~MySqlParallelScan();
+
+    /**
+     * @brief Define the table to scan.
+     * @param primaryKey Integer column used to split the ranges.
+     * @param columns Columns to read, or empty for all.
+     */
+    void setTable(const CString &table, const CString &primaryKey, const std::vector<CString> &columns);
+
+    //! Optional additional condition (SQL expression).
+    inline void setCondition(const CString &condition) { m_condition = condition; }
+
+    //! Number of chunks, by default 4 per connection.
+    inline void setNumChunks(UInt32 numChunks) { m_numChunks = numChunks; }
+
+    //! Deliver the chunks in primary key order, each being sorted.
+    inline void setOrdered(Bool ordered) { m_ordered = ordered; }
+
+    //! Max number of read chunks waiting for their delivery, by default 2 per connection.
+    inline void setMaxPending(UInt32 maxPending) { m_maxPending = maxPending; }
+
+    //! Run the scan. An error of a chunk or of the consumer stops it, and is raised.
+    Stats run(const Consumer &consumer);
+
+private:
+
+    std::vector<MySqlDb*> m_connections;
+
+    MySqlWorkerPool *m_pool;
+    Bool m_ownPool;
+
+    CString m_table;
+    CString m_primaryKey;
+    std::vector<CString> m_columns;
+    CString m_condition;
+
+    UInt32 m_numChunks;
+    UInt32 m_maxPending;
+    Bool m_ordered;
+
+    //! Query the min and max keys. Return False for an empty table.
+    Bool queryBounds(Int64 &minKey, Int64 &maxKey);
+
+    //! Build the query of a chunk.
+    CString chunkQuery() const;
+};
+
+} // namespace mysql
+} // namespace o3d
+
+#endif // _O3D_MYSQLPARALLELSCAN_H
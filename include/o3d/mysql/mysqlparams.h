@@ -0,0 +1,160 @@
+/**
+ * @file mysqlparams.h
+ * @brief Recorded set of query input parameters.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#ifndef _O3D_MYSQLPARAMS_H
+#define _O3D_MYSQLPARAMS_H
+
+#include "mysql.h"
+
+#include <o3d/core/database.h>
+#include <o3d/core/date.h>
+#include <o3d/core/datetime.h>
+
+#include <vector>
+
+namespace o3d {
+namespace mysql {
+
+/**
+ * @brief MySqlParams keep a copy of the input parameters of a query, in way to
+ * replay them later on one or many DbQuery (routing, retry...).
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ */
+class O3D_MYSQL_API MySqlParams
+{
+public:
+
+    enum Type
+    {
+        T_UNDEFINED = 0,
+        T_BOOL,
+        T_INT32,
+        T_UINT32,
+        T_INT64,
+        T_UINT64,
+        T_FLOAT,
+        T_DOUBLE,
+        T_CSTRING,
+        T_ARRAY_UINT8,
+        T_DATE,
+        T_TIMESTAMP
+    };
+
+    MySqlParams();
+
+    //! Remove any parameter.
+    void clear();
+
+    //! Number of parameters (highest defined attribute + 1).
+    inline UInt32 getNumParams() const { return (UInt32)m_params.size(); }
+
+    //! Type of a parameter, T_UNDEFINED if not set.
+    Type getType(UInt32 attr) const;
+
+    //! Set a parameter as ArrayUInt8. The array is duplicated.
+    void setArrayUInt8(UInt32 attr, const ArrayUInt8 &v);
+
+    //! Set a parameter as SmartArrayUInt8. The array is duplicated.
+    void setSmartArrayUInt8(UInt32 attr, const SmartArrayUInt8 &v);
+
+    //! Set a parameter from raw bytes, as an ArrayUInt8. Data are duplicated.
+    void setBytes(UInt32 attr, const UInt8 *data, UInt32 size);
+
+    //! Set a parameter as Bool.
+    void setBool(UInt32 attr, Bool v);
+
+    //! Set a parameter as Int32.
+    void setInt32(UInt32 attr, Int32 v);
+
+    //! Set a parameter as UInt32.
+    void setUInt32(UInt32 attr, UInt32 v);
+
+    //! Set a parameter as Int64.
+    void setInt64(UInt32 attr, Int64 v);
+
+    //! Set a parameter as UInt64.
+    void setUInt64(UInt32 attr, UInt64 v);
+
+    //! Set a parameter as Float.
+    void setFloat(UInt32 attr, Float v);
+
+    //! Set a parameter as Double.
+    void setDouble(UInt32 attr, Double v);
+
+    //! Set a parameter as CString.
+    void setCString(UInt32 attr, const CString &v);
+
+    //! Set a parameter as Date.
+    void setDate(UInt32 attr, const Date &date);
+
+    //! Set a parameter as Timestamp.
+    void setTimestamp(UInt32 attr, const DateTime &date);
+
+    /**
+     * @brief Set the parameters to a query.
+     * @param query Destination query.
+     * @param offset Added to each attribute index (for multi-row statements).
+     */
+    void apply(DbQuery &query, UInt32 offset = 0) const;
+
+    /**
+     * @brief Hash (FNV-1a) of a parameter value. Integers are hashed as 64 bits
+     * values so an Int32 and an Int64 of same value give the same hash.
+     */
+    UInt64 hash(UInt32 attr) const;
+
+    /**
+     * @brief Compare a parameter with the same one of another set. Integers are
+     * compared as 64 bits values, as for the hash.
+     */
+    Bool equal(UInt32 attr, const MySqlParams &other) const;
+
+    /**
+     * @brief Hash (FNV-1a) of a text, a query or its name, combined with the hash
+     * of each parameter. Key of a query and its parameters (caches, coalescing).
+     */
+    UInt64 key(const CString &text) const;
+
+    /**
+     * @brief Add to a numeric parameter the same one of another set (counters).
+     * The type of this parameter is kept.
+     */
+    void add(UInt32 attr, const MySqlParams &other);
+
+private:
+
+    struct Param
+    {
+        Type type;
+
+        union {
+            Int64 i64;
+            UInt64 u64;
+            Double f64;
+        };
+
+        CString string;
+        ArrayUInt8 array;
+
+        Date date;
+        DateTime dateTime;
+
+        Param() : type(T_UNDEFINED), u64(0) {}
+    };
+
+    std::vector<Param> m_params;
+
+    Param& param(UInt32 attr, Type type);
+};
+
+} // namespace mysql
+} // namespace o3d
+
+#endif // _O3D_MYSQLPARAMS_H
@@ -0,0 +1,355 @@
+/**
+ * @file mysqlreactor.h
+ * @brief Event loop driving many connections with the non-blocking client API.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#ifndef _O3D_MYSQLREACTOR_H
+#define _O3D_MYSQLREACTOR_H
+
+#include "mysql.h"
+#include "mysqlresult.h"
+
+#include <o3d/core/base.h>
+
+#include <mysql/mysql.h>
+
+// the non-blocking API is given by libmysqlclient 8.0.16 and above, and epoll by Linux
+#if defined(__linux__) && MYSQL_VERSION_ID >= 80016 && !defined(MARIADB_BASE_VERSION)
+#define O3D_MYSQL_REACTOR 1
+#endif
+
+#ifdef O3D_MYSQL_REACTOR
+
+#include <deque>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#include <coroutine>
+#define O3D_MYSQL_COROUTINE 1
+#endif
+#endif
+
+namespace o3d {
+namespace mysql {
+
+class MySqlDb;
+
+/**
+ * @brief MySqlReactor drive the connections, the text protocol statements and the
+ * fetch of the rows of many MySqlDb from a single thread, using the non-blocking
+ * client API and an epoll instance. An operation is started by connect, execute
+ * or fetch, progresses each time its socket is ready, and its handler is called
+ * by poll once done, with the error raised by the operation if any.
+ * The prepared statements (MySqlQuery) having no non-blocking API, the statements
+ * are run as MySqlDb::executeDirect does, with values already escaped.
+ * A single operation at a time per connection. Not thread-safe: every call, and
+ * every use of the driven connections, must be done by the thread of poll. The
+ * pending operations are dropped at destruction, without call of their handler.
+ * Under C++20 the operations are also given as coroutine awaitables, compiled
+ * and run by the reactor test (test/reactor).
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ */
+class O3D_MYSQL_API MySqlReactor
+{
+public:
+
+    //! Called at the end of a connect, with the error if failed.
+    typedef std::function<void(std::exception_ptr error)> ConnectHandler;
+
+    //! Called at the end of an execute, with the new result to be deleted, or the error.
+    typedef std::function<void(MySqlResult *result, std::exception_ptr error)> ResultHandler;
+
+    //! Called at the end of a fetch, with False after the last row, or the error.
+    typedef std::function<void(Bool hasRow, std::exception_ptr error)> FetchHandler;
+
+    //! Create the epoll instance.
+    MySqlReactor();
+
+    //! Close the epoll instance, dropping the pending operations.
+    ~MySqlReactor();
+
+    MySqlReactor(const MySqlReactor&) = delete;
+    MySqlReactor& operator= (const MySqlReactor&) = delete;
+
+    /**
+     * @brief Start the connection of a database, with its connect options.
+     * @see MySqlDb::connect
+     */
+    void connect(
+            MySqlDb &db,
+            const String &host,
+            UInt32 port,
+            const String &database,
+            const String &user,
+            const String &password,
+            Bool keepPassord,
+            const ConnectHandler &handler);
+
+    /**
+     * @brief Start a statement using the text protocol.
+     * @param sql Statement, with any value already escaped.
+     * @param buffered True to receive every row before the handler, False to
+     * receive them by fetch. An unbuffered result must be fetched up to its end
+     * before its deletion, which would else read the remaining rows blocking.
+     * @see MySqlDb::executeDirect
+     */
+    void execute(MySqlDb &db, const CString &sql, Bool buffered, const ResultHandler &handler);
+
+    //! Start the fetch of the next row of an unbuffered result, given by execute.
+    void fetch(MySqlResult &result, const FetchHandler &handler);
+
+    /**
+     * @brief Progress the operations whose socket is ready, waiting at most timeout
+     * milliseconds (-1 for infinite) for one, and call the handler of the done ones.
+     * An error thrown by a handler leaves poll, the next poll going on.
+     * @return The number of done operations.
+     */
+    UInt32 poll(Int32 timeout = -1);
+
+    //! Poll until there is no pending operation.
+    void run();
+
+    //! Get the number of pending operations.
+    inline UInt32 getNumPending() const { return (UInt32)m_operations.size(); }
+
+#ifdef O3D_MYSQL_COROUTINE
+    //! Awaitable connect.
+    class ConnectAwaiter
+    {
+    public:
+
+        bool await_ready() const noexcept { return false; }
+
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            m_reactor.connect(m_db, m_host, m_port, m_database, m_user, m_password, m_keepPassword,
+                              [this, handle] (std::exception_ptr error) {
+                m_error = error;
+                handle.resume();
+            });
+        }
+
+        void await_resume()
+        {
+            if (m_error) {
+                std::rethrow_exception(m_error);
+            }
+        }
+
+    private:
+
+        friend class MySqlReactor;
+
+        ConnectAwaiter(MySqlReactor &reactor, MySqlDb &db) : m_reactor(reactor), m_db(db) {}
+
+        MySqlReactor &m_reactor;
+        MySqlDb &m_db;
+        String m_host, m_database, m_user, m_password;
+        UInt32 m_port = 0;
+        Bool m_keepPassword = True;
+        std::exception_ptr m_error;
+    };
+
+    //! Awaitable execute, giving the result.
+    class ExecuteAwaiter
+    {
+    public:
+
+        bool await_ready() const noexcept { return false; }
+
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            m_reactor.execute(m_db, m_sql, m_buffered,
+                              [this, handle] (MySqlResult *result, std::exception_ptr error) {
+                m_result.reset(result);
+                m_error = error;
+                handle.resume();
+            });
+        }
+
+        std::unique_ptr<MySqlResult> await_resume()
+        {
+            if (m_error) {
+                std::rethrow_exception(m_error);
+            }
+
+            return std::move(m_result);
+        }
+
+    protected:
+
+        friend class MySqlReactor;
+
+        ExecuteAwaiter(MySqlReactor &reactor, MySqlDb &db, const CString &sql, Bool buffered) :
+            m_reactor(reactor), m_db(db), m_sql(sql), m_buffered(buffered) {}
+
+        MySqlReactor &m_reactor;
+        MySqlDb &m_db;
+        CString m_sql;
+        Bool m_buffered;
+        std::unique_ptr<MySqlResult> m_result;
+        std::exception_ptr m_error;
+    };
+
+    //! Awaitable statement without result set, giving the number of affected rows.
+    class UpdateAwaiter : public ExecuteAwaiter
+    {
+    public:
+
+        UInt32 await_resume()
+        {
+            return ExecuteAwaiter::await_resume()->getNumRows();
+        }
+
+    private:
+
+        friend class MySqlReactor;
+
+        UpdateAwaiter(MySqlReactor &reactor, MySqlDb &db, const CString &sql) :
+            ExecuteAwaiter(reactor, db, sql, True) {}
+    };
+
+    //! Awaitable fetch, giving False after the last row.
+    class FetchAwaiter
+    {
+    public:
+
+        bool await_ready() const noexcept { return false; }
+
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            m_reactor.fetch(m_result, [this, handle] (Bool hasRow, std::exception_ptr error) {
+                m_hasRow = hasRow;
+                m_error = error;
+                handle.resume();
+            });
+        }
+
+        Bool await_resume()
+        {
+            if (m_error) {
+                std::rethrow_exception(m_error);
+            }
+
+            return m_hasRow;
+        }
+
+    private:
+
+        friend class MySqlReactor;
+
+        FetchAwaiter(MySqlReactor &reactor, MySqlResult &result) : m_reactor(reactor), m_result(result) {}
+
+        MySqlReactor &m_reactor;
+        MySqlResult &m_result;
+        Bool m_hasRow = False;
+        std::exception_ptr m_error;
+    };
+
+    //! co_await of connect.
+    ConnectAwaiter connectAsync(
+            MySqlDb &db,
+            const String &host,
+            UInt32 port,
+            const String &database,
+            const String &user = "",
+            const String &password = "",
+            Bool keepPassord = True)
+    {
+        ConnectAwaiter awaiter(*this, db);
+        awaiter.m_host = host;
+        awaiter.m_port = port;
+        awaiter.m_database = database;
+        awaiter.m_user = user;
+        awaiter.m_password = password;
+        awaiter.m_keepPassword = keepPassord;
+        return awaiter;
+    }
+
+    //! co_await of execute, giving a std::unique_ptr<MySqlResult>.
+    ExecuteAwaiter executeAsync(MySqlDb &db, const CString &sql, Bool buffered = True)
+    {
+        return ExecuteAwaiter(*this, db, sql, buffered);
+    }
+
+    //! co_await of execute for a statement without result set, giving the affected rows.
+    UpdateAwaiter updateAsync(MySqlDb &db, const CString &sql)
+    {
+        return UpdateAwaiter(*this, db, sql);
+    }
+
+    //! co_await of fetch, giving False after the last row.
+    FetchAwaiter fetchAsync(MySqlResult &result)
+    {
+        return FetchAwaiter(*this, result);
+    }
+#endif // O3D_MYSQL_COROUTINE
+
+private:
+
+    enum Step
+    {
+        STEP_CONNECT = 0,
+        STEP_QUERY,
+        STEP_STORE,
+        STEP_FETCH
+    };
+
+    struct Operation
+    {
+        Step step;
+        MYSQL *pDB;
+        MySqlDb *db;
+        MySqlResult *result;
+
+        CString host;
+        CString user;
+        CString password;
+        CString database;
+        CString sql;
+        UInt32 port;
+        Bool buffered;
+
+        Bool hasRow;
+        std::exception_ptr error;
+
+        Bool registered;    //!< Socket in the epoll instance
+        Bool queued;        //!< In the runnable queue
+
+        ConnectHandler onConnect;
+        ResultHandler onResult;
+        FetchHandler onFetch;
+    };
+
+    Int32 m_epoll;
+
+    std::map<MYSQL*, std::unique_ptr<Operation>> m_operations;   //!< Per connection
+    std::deque<Operation*> m_runnable;
+
+    //! Add an operation, runnable at once.
+    Operation& start(MYSQL *pDB, Step step);
+
+    //! Call the non-blocking function of the step of an operation.
+    //! @return True once done.
+    Bool progress(Operation &op);
+
+    //! Progress an operation, and once done remove it and call its handler.
+    //! @return True once done.
+    Bool dispatch(Operation *op);
+};
+
+} // namespace mysql
+} // namespace o3d
+
+#endif // O3D_MYSQL_REACTOR
+
+#endif // _O3D_MYSQLREACTOR_H
@@ -0,0 +1,151 @@
+/**
+ * @file mysqlresult.h
+ * @brief Result of a direct (text protocol) query.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#ifndef _O3D_MYSQLRESULT_H
+#define _O3D_MYSQLRESULT_H
+
+#include "mysql.h"
+
+#include <o3d/core/database.h>
+
+#include <mysql/mysql.h>
+
+#include <map>
+#include <vector>
+
+namespace o3d {
+namespace mysql {
+
+/**
+ * @brief MySqlResult row cursor over the result of MySqlDb::executeDirect.
+ * Values are received as text and only parsed when an output is accessed, once
+ * per row and column, into the same types as the outputs of a MySqlQuery (signed
+ * or unsigned integers, DECIMAL as scaled Int64, BIT as UInt64, dates). Must be deleted by the caller, and for an unbuffered
+ * result before any other query on the same connection.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ */
+class O3D_MYSQL_API MySqlResult
+{
+    friend class MySqlDb;
+    friend class MySqlReactor;
+
+public:
+
+    //! Virtual destructor. Release the result, reading the remaining rows if unbuffered.
+    virtual ~MySqlResult();
+
+    //! Is the statement returned a result set (SELECT, SHOW...).
+    inline Bool hasResultSet() const { return m_result != nullptr; }
+
+    //! Is the rows are buffered on the client side.
+    inline Bool isBuffered() const { return m_buffered; }
+
+    //! Number of columns.
+    inline UInt32 getNumColumns() const { return (UInt32)m_outputs.getSize(); }
+
+    //! Number of rows of a buffered result set, or affected rows of a statement.
+    UInt32 getNumRows() const;
+
+    //! Get the result variable (ie for an auto increment).
+    inline UInt64 getGeneratedKey() const { return m_generatedKey; }
+
+    /**
+     * @brief fetch Fetch the next row.
+     * @return True until there is results row
+     */
+    Bool fetch();
+
+    //! Get the row position when fetching.
+    inline UInt32 tellRow() const { return m_currRow; }
+
+    //! Set the row position when fetching (seek 0 for reset). Only for a buffered result.
+    void seekRow(UInt32 row);
+
+    //! Get an output attribute id by its name.
+    UInt32 getOutAttr(const CString &name) const;
+
+    //! Get an output variable by its name. Parsed on the first access for the row.
+    const DbVariable& getOut(const CString &name) const;
+
+    //! Get an output variable by its index. Parsed on the first access for the row.
+    const DbVariable& getOut(UInt32 attr) const;
+
+    /**
+     * @brief Move to the result of the next statement of a multi-statement batch
+     * or of a stored procedure CALL. The current result set is released.
+     * @return False when there is no more result.
+     */
+    Bool nextResult();
+
+    //! Is more results follow the current one.
+    Bool hasMoreResults() const;
+
+    /**
+     * @brief Get the text of an output of the current row, without any conversion.
+     * @param length Receive the length in bytes.
+     * @return Null for a NULL value.
+     */
+    const Char* getText(UInt32 attr, UInt32 &length) const;
+
+protected:
+
+    //! Read the result of the last statement run on the connection.
+    MySqlResult(MYSQL *pDb, Bool buffered);
+
+    //! Adopt a result already read (null for a statement without result set).
+    MySqlResult(MYSQL *pDb, MYSQL_RES *result, Bool buffered);
+
+    //! Read and setup the result of the current statement.
+    void readResult();
+
+    //! Setup the outputs, or the affected rows without result set.
+    void setupResult();
+
+    //! Make a fetched row the current one, null at the end of the rows.
+    Bool acceptRow(MYSQL_ROW row);
+
+    //! Release the current result set.
+    void freeResult();
+
+    //! Read and discard the remaining results.
+    void drainResults();
+
+    //! Convert the text of a column of the current row into its variable.
+    void parse(UInt32 attr) const;
+
+    MYSQL *m_pDB;
+    MYSQL_RES *m_result;
+
+    Bool m_buffered;
+
+    MYSQL_ROW m_row;
+    unsigned long *m_lengths;
+
+    UInt32 m_numRows;
+    UInt32 m_currRow;
+    UInt64 m_generatedKey;
+
+    std::map<CString, UInt32> m_outputNames;
+    TemplateArray<DbVariable*> m_outputs;
+
+    //! Incremented at each fetched row.
+    UInt32 m_rowStamp;
+
+    //! Row stamp of the last parse, per column.
+    mutable std::vector<UInt32> m_parsedStamp;
+
+    std::vector<enum_field_types> m_fieldTypes;     //!< Per column
+    std::vector<UInt32> m_decimals;                 //!< Per column, for DECIMAL
+};
+
+} // namespace mysql
+} // namespace o3d
+
+#endif // _O3D_MYSQLRESULT_H
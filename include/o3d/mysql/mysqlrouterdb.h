@@ -0,0 +1,361 @@
+/**
+ * @file mysqlrouterdb.h
+ * @brief Read/write splitting over a primary and many replicas.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#ifndef _O3D_MYSQLROUTERDB_H
+#define _O3D_MYSQLROUTERDB_H
+
+#include "mysqldb.h"
+#include "mysqlparams.h"
+#include "mysqlworkerpool.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace o3d {
+namespace mysql {
+
+class MySqlRoutedQuery;
+
+/**
+ * @brief MySqlRouterDb route the queries between a primary server and N replicas.
+ * The execute() of the read-only queries is sent to the replica with the lowest
+ * EWMA latency, skipping the replicas whose replication lag exceeds the bound.
+ * Any update() and any query not marked read-only goes to the primary. If no
+ * replica is eligible, the primary is used.
+ * The lag of a replica is measured by a blocking SHOW REPLICA STATUS, at most
+ * once per lag check interval, by the execute selecting a replica. To keep it
+ * off the execute path, disable the automatic check and call checkReplicas()
+ * periodically from the thread using the router.
+ * The read-only queries can be hedged (see MySqlRoutedQuery::setHedgeBudget).
+ * As MySqlDb it is not thread-safe, except for the hedges reaped in the background.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ */
+class O3D_MYSQL_API MySqlRouterDb : public Database
+{
+    friend class MySqlRoutedQuery;
+
+public:
+
+    //! Default ctor. MySql::init() must be called before.
+    MySqlRouterDb();
+
+    //! Virtual dtor. Delete the primary and the replicas.
+    virtual ~MySqlRouterDb();
+
+    //! Connect to the primary database.
+    virtual Bool connect(
+        const String &host,
+        o3d::UInt32 port,
+        const String &database,
+        const String &user = "",
+        const String &password = "",
+        Bool keepPassord = True);
+
+    //! Disconnect from the primary and the replicas.
+    virtual void disconnect();
+
+    //! Try to maintain the primary and the replicas connections established.
+    virtual void pingConnection();
+
+    /**
+     * @brief Add and connect a replica, using the database, user and password
+     * given to connect(). The password must have been kept.
+     */
+    void addReplica(const String &host, o3d::UInt32 port);
+
+    //! Add a connected replica. Its ownership is taken.
+    void addReplica(MySqlDb *replica);
+
+    //! Get the number of replicas.
+    inline UInt32 getNumReplicas() const { return (UInt32)m_replicas.size(); }
+
+    //! Get the primary database.
+    inline MySqlDb* getPrimary() { return m_primary; }
+
+    //! Get a replica database. Can be running the loser of a hedged read.
+    MySqlDb* getReplica(UInt32 index);
+
+    /**
+     * @brief Register a query whose execute() can be sent to a replica.
+     * Same as registerQuery() followed by MySqlRoutedQuery::setReadOnly().
+     */
+    DbQuery* registerReadOnlyQuery(const String &name, const CString &query);
+
+    //! Max accepted replication lag in seconds (default 5).
+    inline void setMaxReplicationLag(UInt32 seconds) { m_maxLag = seconds; }
+
+    //! Max accepted replication lag in seconds.
+    inline UInt32 getMaxReplicationLag() const { return m_maxLag; }
+
+    //! Delay between two lag measures of a replica in milliseconds (default 1000).
+    inline void setLagCheckInterval(UInt32 ms) { m_lagCheckInterval = ms; }
+
+    //! Delay between two lag measures of a replica in milliseconds.
+    inline UInt32 getLagCheckInterval() const { return m_lagCheckInterval; }
+
+    /**
+     * @brief Measure the lag from the execute selecting a replica (default true).
+     * If false the lag is only measured by checkReplicas.
+     */
+    inline void setAutoLagCheck(Bool autoCheck) { m_autoLagCheck = autoCheck; }
+
+    //! Is the lag measured from the execute.
+    inline Bool isAutoLagCheck() const { return m_autoLagCheck; }
+
+    /**
+     * @brief Measure the lag of the replicas whose last measure is older than the
+     * lag check interval. Blocking, a statement per measured replica.
+     */
+    void checkReplicas();
+
+    //! Smoothing factor of the latency EWMA in ]0..1] (default 0.2).
+    inline void setLatencySmoothing(Float alpha) { m_alpha = alpha; }
+
+    //! Percentile of the recent latencies of a query used as hedge delay (default 0.95).
+    inline void setHedgePercentile(Float percentile) { m_hedgePercentile = percentile; }
+
+    //! Get the percentile of the hedge delay.
+    inline Float getHedgePercentile() const { return m_hedgePercentile; }
+
+    //! Min hedge delay in milliseconds (default 2).
+    inline void setMinHedgeDelay(UInt32 ms) { m_minHedgeDelay = ms; }
+
+    //! Get the min hedge delay in milliseconds.
+    inline UInt32 getMinHedgeDelay() const { return m_minHedgeDelay; }
+
+protected:
+
+    struct Replica
+    {
+        MySqlDb *db;
+        Float latency;      //!< EWMA of the execute latency in ms
+        Int32 lag;          //!< Last measured lag in seconds, -1 if unknown or down
+        Int64 lastCheck;    //!< Time of the last lag measure in ms
+
+        //! Running a cancelled hedge in the background, not to be used meanwhile
+        std::shared_ptr<std::atomic<Bool>> busy;
+
+        Replica(MySqlDb *_db) :
+            db(_db), latency(0.f), lag(-1), lastCheck(0),
+            busy(std::make_shared<std::atomic<Bool>>(False)) {}
+    };
+
+    //! Instanciate a new MySqlRoutedQuery object
+    virtual DbQuery* newDbQuery(const String &name, const CString &query);
+
+    //! Select the replica for a read, or -1 for the primary.
+    Int32 selectReplica(Int32 exclude = -1);
+
+    //! Get the threads running the hedged reads, created once needed.
+    MySqlWorkerPool& hedgePool();
+
+    //! Wait for the end of the hedges reaped in the background.
+    void waitHedges();
+
+    //! Update the statistics of a replica after an execute.
+    void reportExecute(Int32 replica, Float latency, Bool failed);
+
+    MySqlDb *m_primary;
+    std::vector<Replica> m_replicas;
+
+    UInt32 m_maxLag;
+    UInt32 m_lagCheckInterval;
+    Bool m_autoLagCheck;
+    Float m_alpha;
+
+    Float m_hedgePercentile;
+    UInt32 m_minHedgeDelay;
+    MySqlWorkerPool *m_hedgePool;
+};
+
+/**
+ * @brief MySqlRoutedQuery query registered on a MySqlRouterDb.
+ * Inputs are recorded and replayed on the query of the selected server, and the
+ * outputs are read from it after the execute. Can't be deleted outside of the
+ * MySqlRouterDb.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ */
+class O3D_MYSQL_API MySqlRoutedQuery : public DbQuery
+{
+    friend class MySqlRouterDb;
+
+public:
+
+    //! Virtual destructor
+    virtual ~MySqlRoutedQuery();
+
+    //! Allow or not execute() to be sent to a replica.
+    inline void setReadOnly(Bool readOnly) { m_readOnly = readOnly; }
+
+    //! Is execute() can be sent to a replica.
+    inline Bool isReadOnly() const { return m_readOnly; }
+
+    //! Get the server used by the last execute or update, -1 for the primary.
+    inline Int32 getLastReplica() const { return m_currentReplica; }
+
+    /**
+     * @brief Hedge the execute of a read-only query. When its replica doesn't answer
+     * within the hedge percentile of the recent latencies of this query, a copy is
+     * sent to another replica, the first answer winning. The execute returns with
+     * the winner, the loser being cancelled and waited for in the background, its
+     * replica being skipped until then. The first cancel of a replica opens its
+     * side connection, also in the background. At most budget extra executes are
+     * sent per execute.
+     * @param budget Fraction of extra executes (0.05 for 5%), 0 to disable.
+     */
+    void setHedgeBudget(Float budget);
+
+    //! Get the hedge budget.
+    inline Float getHedgeBudget() const { return m_hedgeBudget; }
+
+    //! Get the number of sent hedges.
+    inline UInt32 getNumHedges() const { return m_numHedges; }
+
+    //! Get the number of hedges which answered first.
+    inline UInt32 getNumHedgeWins() const { return m_numHedgeWins; }
+
+    //! Set an input variable as ArrayUInt8. The array is duplicated.
+    virtual void setArrayUInt8(UInt32 attr, const ArrayUInt8 &v);
+
+    //! Set an input variable as SmartArrayUInt8. The array is duplicated.
+    virtual void setSmartArrayUInt8(UInt32 attr, const SmartArrayUInt8 &v);
+
+    //! Not supported, the stream could not be replayed.
+    virtual void setInStream(UInt32 attr, const InStream &v);
+
+    //! Set an input variable as Bool.
+    virtual void setBool(UInt32 attr, Bool v);
+
+    //! Set an input variable as Int32.
+    virtual void setInt32(UInt32 attr, Int32 v);
+
+    //! Set an input variable as UInt32.
+    virtual void setUInt32(UInt32 attr, UInt32 v);
+
+    //! Set an input variable as Int64.
+    virtual void setInt64(UInt32 attr, Int64 v);
+
+    //! Set an input variable as UInt64.
+    virtual void setUInt64(UInt32 attr, UInt64 v);
+
+    //! Set an input variable as Float.
+    virtual void setFloat(UInt32 attr, Float v);
+
+    //! Set an input variable as Double.
+    virtual void setDouble(UInt32 attr, Double v);
+
+    //! Set an input variable as CString.
+    virtual void setCString(UInt32 attr, const CString &v);
+
+    //! Set an input variable as Date.
+    virtual void setDate(UInt32 attr, const Date &date);
+
+    //! Set an input variable as Timestamp.
+    virtual void setTimestamp(UInt32 attr, const DateTime &date);
+
+    //! Get an output attribute id by its name.
+    virtual UInt32 getOutAttr(const CString &name);
+
+    //! Get an output variable by its name.
+    virtual const DbVariable& getOut(const CString &name) const;
+
+    //! Get an output variable by its index.
+    virtual const DbVariable& getOut(UInt32 attr) const;
+
+    //! Execute the query for a SELECT, on a replica if read-only.
+    virtual void execute();
+
+    //! Execute the query for an UPDATE, INSERT, or DELETE, always on the primary.
+    virtual void update();
+
+    //! Get the number of affected or result rows after an execute or update.
+    virtual UInt32 getNumRows();
+
+    //! Get the result variable (ie for an auto increment).
+    virtual UInt64 getGeneratedKey() const;
+
+    //! Fetch the next row of the result.
+    virtual Bool fetch();
+
+    //! Get the row position when fetching.
+    virtual UInt32 tellRow();
+
+    //! Set the row position when fetching (seek 0 for reset).
+    virtual void seekRow(UInt32 row);
+
+    //! Unbind the current input attributes.
+    virtual void unbind();
+
+protected:
+
+    //! Default ctor
+    MySqlRoutedQuery(
+        MySqlRouterDb *router,
+        const String &name,
+        const CString &query);
+
+    //! Get or register the query on the primary (-1) or on a replica.
+    DbQuery* backendQuery(Int32 replica);
+
+    //! Get the query of the last execute or update, or raise an error.
+    DbQuery* current() const;
+
+    //! Replay the inputs if necessary and make current the query of a server.
+    DbQuery* selectBackend(Int32 replica);
+
+    //! Replay the inputs on the query of a server if they changed.
+    DbQuery* prepareBackend(Int32 replica);
+
+    //! Record the latency of an execute, for the hedge delay.
+    void recordLatency(Float latency);
+
+    //! Hedge delay in ms, or -1 if not hedged.
+    Float hedgeDelay();
+
+    //! Execute on a replica, hedged on another one after a delay.
+    void executeHedged(Int32 replica, Float delay);
+
+    MySqlRouterDb *m_router;
+
+    String m_name;
+    CString m_query;
+
+    Bool m_readOnly;
+
+    MySqlParams m_params;
+    UInt32 m_paramsVersion;
+
+    DbQuery *m_primaryQuery;
+    UInt32 m_primaryVersion;
+
+    std::vector<DbQuery*> m_replicaQueries;
+    std::vector<UInt32> m_replicaVersions;
+
+    DbQuery *m_current;
+    Int32 m_currentReplica;
+
+    static const UInt32 NUM_LATENCIES = 128;  //!< Recent latencies of the hedge delay
+
+    Float m_hedgeBudget;
+    Float m_hedgeCredit;        //!< Hedges allowed, increased by the budget at each execute
+    UInt32 m_numHedges;
+    UInt32 m_numHedgeWins;
+
+    std::vector<Float> m_latencies;
+    UInt32 m_latencyPos;
+    std::vector<Float> m_sorted;
+};
+
+} // namespace mysql
+} // namespace o3d
+
+#endif // _O3D_MYSQLROUTERDB_H
@@ -0,0 +1,277 @@
+/**
+ * @file mysqlrowblock.h
+ * @brief Reusable block of rows filled by a batched fetch.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#ifndef _O3D_MYSQLROWBLOCK_H
+#define _O3D_MYSQLROWBLOCK_H
+
+#include "mysql.h"
+
+#include <o3d/core/database.h>
+#include <o3d/core/date.h>
+#include <o3d/core/datetime.h>
+
+#include <iterator>
+#include <vector>
+
+namespace o3d {
+namespace mysql {
+
+class MySqlQuery;
+
+/**
+ * @brief MySqlRowBlock rows of a result set read at once by MySqlQuery::fetchBatch.
+ * Values are stored into a 8 bytes slot per row and column (integers as Int64,
+ * reals as Double, dates packed), strings and blobs into a heap. The block is
+ * reused from a batch to the next, without any allocation once grown, and its
+ * values, as the pointers returned by getData, are valid until the next batch.
+ * Rows can be iterated with a range-for, each one having the typed accessors.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ */
+class O3D_MYSQL_API MySqlRowBlock
+{
+    friend class MySqlQuery;
+
+public:
+
+    //! A row of the block.
+    class Row
+    {
+    public:
+
+        Row(const MySqlRowBlock &block, UInt32 row) : m_block(&block), m_row(row) {}
+
+        //! Get the index of the row in its block.
+        inline UInt32 getIndex() const { return m_row; }
+
+        inline Bool isNull(UInt32 col) const { return m_block->isNull(m_row, col); }
+
+        inline Int64 asInt64(UInt32 col) const { return m_block->asInt64(m_row, col); }
+        inline UInt64 asUInt64(UInt32 col) const { return m_block->asUInt64(m_row, col); }
+        inline Int32 asInt32(UInt32 col) const { return m_block->asInt32(m_row, col); }
+        inline UInt32 asUInt32(UInt32 col) const { return m_block->asUInt32(m_row, col); }
+        inline Bool asBool(UInt32 col) const { return m_block->asBool(m_row, col); }
+        inline Double asDouble(UInt32 col) const { return m_block->asDouble(m_row, col); }
+        inline Float asFloat(UInt32 col) const { return m_block->asFloat(m_row, col); }
+
+        inline const UInt8* getData(UInt32 col, UInt32 *length = nullptr) const {
+            return m_block->getData(m_row, col, length);
+        }
+
+        inline const Char* asCString(UInt32 col) const { return m_block->asCString(m_row, col); }
+
+        inline Date asDate(UInt32 col) const { return m_block->asDate(m_row, col); }
+        inline DateTime asDateTime(UInt32 col) const { return m_block->asDateTime(m_row, col); }
+
+    private:
+
+        const MySqlRowBlock *m_block;
+        UInt32 m_row;
+    };
+
+    //! Iterator over the rows of the block.
+    class Iterator
+    {
+    public:
+
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Row value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const Row* pointer;
+        typedef Row reference;
+
+        Iterator(const MySqlRowBlock &block, UInt32 row) : m_block(&block), m_row(row) {}
+
+        inline Row operator* () const { return Row(*m_block, m_row); }
+        inline Iterator& operator++ () { ++m_row; return *this; }
+
+        inline Bool operator== (const Iterator &other) const { return m_row == other.m_row; }
+        inline Bool operator!= (const Iterator &other) const { return m_row != other.m_row; }
+
+    private:
+
+        const MySqlRowBlock *m_block;
+        UInt32 m_row;
+    };
+
+    MySqlRowBlock();
+
+    //! Get the number of rows of the last batch.
+    inline UInt32 getNumRows() const { return m_numRows; }
+
+    //! Get the number of columns.
+    inline UInt32 getNumColumns() const { return (UInt32)m_columns.size(); }
+
+    //! Get the type of a column.
+    DbVariable::IntType getColumnType(UInt32 col) const;
+
+    inline Row operator[] (UInt32 row) const { return Row(*this, row); }
+
+    inline Iterator begin() const { return Iterator(*this, 0); }
+    inline Iterator end() const { return Iterator(*this, m_numRows); }
+
+    //! Is a value null.
+    inline Bool isNull(UInt32 row, UInt32 col) const { return m_nulls[index(row, col)] != 0; }
+
+    //! Get an integer or a boolean value, or a real value truncated.
+    inline Int64 asInt64(UInt32 row, UInt32 col) const
+    {
+        size_t i = index(row, col);
+        if (m_columns[col].kind == KIND_INTEGER) {
+            return (Int64)m_slots[i];
+        } else {
+            return (Int64)asReal(i, col);
+        }
+    }
+
+    //! Get an unsigned integer value.
+    inline UInt64 asUInt64(UInt32 row, UInt32 col) const { return (UInt64)asInt64(row, col); }
+
+    inline Int32 asInt32(UInt32 row, UInt32 col) const { return (Int32)asInt64(row, col); }
+    inline UInt32 asUInt32(UInt32 row, UInt32 col) const { return (UInt32)asInt64(row, col); }
+    inline Bool asBool(UInt32 row, UInt32 col) const { return asInt64(row, col) != 0; }
+
+    //! Get a real value, or an integer value converted.
+    inline Double asDouble(UInt32 row, UInt32 col) const
+    {
+        size_t i = index(row, col);
+        if (m_columns[col].kind == KIND_INTEGER) {
+            return (Double)(Int64)m_slots[i];
+        } else {
+            return asReal(i, col);
+        }
+    }
+
+    inline Float asFloat(UInt32 row, UInt32 col) const { return (Float)asDouble(row, col); }
+
+    /**
+     * @brief Get a string or a blob value, without copy. Strings are zero terminated.
+     * @param length If non null receive the length in bytes.
+     * @return Null for a NULL value.
+     */
+    const UInt8* getData(UInt32 row, UInt32 col, UInt32 *length = nullptr) const;
+
+    //! Get a string value, or null.
+    inline const Char* asCString(UInt32 row, UInt32 col) const { return (const Char*)getData(row, col); }
+
+    //! Get a date value.
+    Date asDate(UInt32 row, UInt32 col) const;
+
+    //! Get a date time value.
+    DateTime asDateTime(UInt32 row, UInt32 col) const;
+
+private:
+
+    enum Kind
+    {
+        KIND_INTEGER = 0,
+        KIND_REAL,
+        KIND_DATA,
+        KIND_DATE
+    };
+
+    struct Column
+    {
+        DbVariable::IntType intType;
+        Kind kind;
+    };
+
+    std::vector<Column> m_columns;
+
+    UInt32 m_numRows;
+
+    std::vector<UInt64> m_slots;    //!< Row major, a slot per column
+    std::vector<UInt8> m_nulls;     //!< Row major, non zero for a NULL value
+    std::vector<UInt8> m_heap;      //!< Strings and blobs, zero terminated
+
+    inline size_t index(UInt32 row, UInt32 col) const
+    {
+        if (row >= m_numRows || col >= m_columns.size()) {
+            outOfRange();
+        }
+
+        return (size_t)row * m_columns.size() + col;
+    }
+
+    [[noreturn]] static void outOfRange();
+
+    Double asReal(size_t index, UInt32 col) const;
+
+    //! Clear the rows and define the columns, keeping the capacity.
+    void reset(UInt32 numColumns);
+    void setColumn(UInt32 col, DbVariable::IntType intType);
+
+    //! Append a row of non null values. Return its first slot.
+    UInt64* appendRow();
+
+    //! Reserve the space of a value in the heap, with its terminal zero.
+    UInt8* allocateData(UInt32 length, UInt64 &slot);
+};
+
+/**
+ * @brief MySqlBatchRange range over the batches of the current result set of a
+ * query, each one read by fetchBatch into the same block.
+ * @code
+ * for (const MySqlRowBlock &block : query->batches(1024)) {
+ *     for (MySqlRowBlock::Row row : block) {
+ *         sum += row.asInt64(0);
+ *     }
+ * }
+ * @endcode
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ */
+class O3D_MYSQL_API MySqlBatchRange
+{
+public:
+
+    class Iterator
+    {
+    public:
+
+        typedef std::input_iterator_tag iterator_category;
+        typedef MySqlRowBlock value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const MySqlRowBlock* pointer;
+        typedef const MySqlRowBlock& reference;
+
+        Iterator(MySqlBatchRange *range) : m_range(range) {}
+
+        inline const MySqlRowBlock& operator* () const { return m_range->m_block; }
+        inline Iterator& operator++ () { if (!m_range->next()) m_range = nullptr; return *this; }
+
+        inline Bool operator== (const Iterator &other) const { return m_range == other.m_range; }
+        inline Bool operator!= (const Iterator &other) const { return m_range != other.m_range; }
+
+    private:
+
+        MySqlBatchRange *m_range;
+    };
+
+    MySqlBatchRange(MySqlQuery &query, UInt32 batchSize);
+
+    //! Read the first batch.
+    Iterator begin();
+
+    inline Iterator end() { return Iterator(nullptr); }
+
+private:
+
+    MySqlQuery *m_query;
+    UInt32 m_batchSize;
+    MySqlRowBlock m_block;
+
+    //! Read the next batch. Return False once every row has been read.
+    Bool next();
+};
+
+} // namespace mysql
+} // namespace o3d
+
+#endif // _O3D_MYSQLROWBLOCK_H
@@ -0,0 +1,282 @@
+/**
+ * @file mysqlrowset.h
+ * @brief Compact immutable client side copy of a result set.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#ifndef _O3D_MYSQLROWSET_H
+#define _O3D_MYSQLROWSET_H
+
+#include "mysql.h"
+
+#include <o3d/core/database.h>
+#include <o3d/core/date.h>
+#include <o3d/core/datetime.h>
+
+#include <functional>
+#include <iosfwd>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace o3d {
+namespace mysql {
+
+class MySqlRowSetBuilder;
+
+/**
+ * @brief MySqlRowSet result set packed into a single contiguous buffer :
+ * a header, the columns, an array of fixed size rows (a null bitmap followed by
+ * a 8 bytes slot per column), and a heap for the strings and blobs.
+ * Rows are accessed in constant time. Being immutable it can be shared and read
+ * by many threads, and it doesn't depend on the statement it comes from.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ */
+class O3D_MYSQL_API MySqlRowSet
+{
+    friend class MySqlRowSetBuilder;
+
+public:
+
+    /**
+     * @brief Create a rowset over an external buffer (mapped file...) at the
+     * MySqlRowSet format, 8 bytes aligned. The buffer is checked but not copied :
+     * its ranges, and each column name and string or blob value within the heap.
+     * @param release Called at destruction, or if the buffer is invalid.
+     */
+    static std::shared_ptr<const MySqlRowSet> fromBuffer(
+            const UInt8 *data,
+            UInt64 size,
+            const std::function<void()> &release);
+
+    //! Release the buffer.
+    ~MySqlRowSet();
+
+    MySqlRowSet(const MySqlRowSet&) = delete;
+    MySqlRowSet& operator= (const MySqlRowSet&) = delete;
+
+    //! Get the number of rows.
+    inline UInt32 getNumRows() const { return m_header->numRows; }
+
+    //! Get the number of columns.
+    inline UInt32 getNumColumns() const { return m_header->numColumns; }
+
+    //! Get the name of a column.
+    CString getColumnName(UInt32 col) const;
+
+    //! Get the type of a column.
+    DbVariable::IntType getColumnType(UInt32 col) const;
+
+    //! Get the variable type of a column, telling the signedness of the integers.
+    DbVariable::VarType getColumnVarType(UInt32 col) const;
+
+    /**
+     * @brief Get the number of decimals of a column. A DECIMAL value is an Int64
+     * scaled by 10^decimals.
+     */
+    UInt32 getColumnDecimals(UInt32 col) const;
+
+    //! Get the index of a column by its name.
+    UInt32 getColumnIndex(const CString &name) const;
+
+    //! Is a value null.
+    Bool isNull(UInt32 row, UInt32 col) const;
+
+    //! Get an integer or a boolean value, or a real value truncated.
+    Int64 asInt64(UInt32 row, UInt32 col) const;
+
+    //! Get an unsigned integer value.
+    UInt64 asUInt64(UInt32 row, UInt32 col) const;
+
+    inline Int32 asInt32(UInt32 row, UInt32 col) const { return (Int32)asInt64(row, col); }
+    inline UInt32 asUInt32(UInt32 row, UInt32 col) const { return (UInt32)asUInt64(row, col); }
+    inline Bool asBool(UInt32 row, UInt32 col) const { return asInt64(row, col) != 0; }
+
+    //! Get a real value, or an integer value converted.
+    Double asDouble(UInt32 row, UInt32 col) const;
+
+    inline Float asFloat(UInt32 row, UInt32 col) const { return (Float)asDouble(row, col); }
+
+    /**
+     * @brief Get a string or a blob value, without copy. Strings are zero terminated.
+     * @param length If non null receive the length in bytes.
+     * @return Null for a NULL value.
+     */
+    const UInt8* getData(UInt32 row, UInt32 col, UInt32 *length = nullptr) const;
+
+    //! Get a string value, or null.
+    inline const Char* asCString(UInt32 row, UInt32 col) const { return (const Char*)getData(row, col); }
+
+    //! Get a date value.
+    Date asDate(UInt32 row, UInt32 col) const;
+
+    //! Get a date time value.
+    DateTime asDateTime(UInt32 row, UInt32 col) const;
+
+    //! Get the whole buffer.
+    inline const UInt8* getBuffer() const { return m_data; }
+
+    //! Get the size in bytes of the whole buffer.
+    inline UInt64 getBufferSize() const { return m_size; }
+
+private:
+
+    static const UInt32 MAGIC = 0x53524d4f;   // "OMRS"
+    static const UInt32 VERSION = 2;
+
+    struct Header
+    {
+        UInt32 magic;
+        UInt32 version;
+        UInt32 numRows;
+        UInt32 numColumns;
+        UInt32 rowSize;         //!< Null bitmap plus the slots, multiple of 8
+        UInt32 nullSize;        //!< Null bitmap size, multiple of 8
+        UInt64 columnsOffset;
+        UInt64 rowsOffset;
+        UInt64 heapOffset;
+        UInt64 heapSize;
+    };
+
+    struct ColumnDesc
+    {
+        UInt32 intType;
+        UInt32 varType;
+        UInt32 nameOffset;      //!< In the heap
+        UInt32 nameLength;
+        UInt32 decimals;        //!< Scale of a DECIMAL
+        UInt32 reserved;
+    };
+
+    //! Own the buffer.
+    MySqlRowSet(std::vector<UInt64> &&storage, UInt64 size);
+
+    //! External buffer.
+    MySqlRowSet(const UInt8 *data, UInt64 size, const std::function<void()> &release);
+
+    //! Setup the pointers and the names map.
+    void init();
+
+    inline const UInt8* rowPtr(UInt32 row) const { return m_rows + (UInt64)row * m_header->rowSize; }
+    const UInt8* slot(UInt32 row, UInt32 col) const;
+
+    std::vector<UInt64> m_storage;
+    std::function<void()> m_release;
+
+    const UInt8 *m_data;
+    UInt64 m_size;
+
+    const Header *m_header;
+    const ColumnDesc *m_columns;
+    const UInt8 *m_rows;
+    const UInt8 *m_heap;
+
+    std::map<CString, UInt32> m_columnNames;
+};
+
+/**
+ * @brief MySqlRowSetBuilder append rows one by one, and then pack them into a
+ * MySqlRowSet. Each new row starts with null values.
+ * In stream mode the rows are written to an output stream as they are appended,
+ * at the MySqlRowSet format, and the strings and blobs to a side stream, so the
+ * memory stays bounded whatever the number of rows.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ */
+class O3D_MYSQL_API MySqlRowSetBuilder
+{
+public:
+
+    MySqlRowSetBuilder();
+
+    /**
+     * @brief Declare a column. Must be done before the first row.
+     * @param decimals Scale of a DECIMAL column, given as a scaled Int64.
+     */
+    void addColumn(
+            const CString &name,
+            DbVariable::IntType intType,
+            DbVariable::VarType varType,
+            UInt32 decimals = 0);
+
+    //! Get the number of columns.
+    inline UInt32 getNumColumns() const { return (UInt32)m_columns.size(); }
+
+    //! Get the number of rows.
+    inline UInt32 getNumRows() const { return m_numRows; }
+
+    //! Append a new row, with null values.
+    void beginRow();
+
+    //! Set a value of the last row from a fetched output variable.
+    void setValue(UInt32 col, const DbVariable &var);
+
+    //! Set a string or blob value of the last row.
+    void setData(UInt32 col, const void *data, UInt32 length);
+
+    //! Pack the rows into a new rowset, and clear the builder.
+    std::shared_ptr<const MySqlRowSet> build();
+
+    /**
+     * @brief Write the rowset to a stream instead of memory. Must be done before
+     * the first row. The rowset starts at the current position of out, which
+     * must be 8 bytes aligned in the file to be mapped later.
+     * @param out Seekable output, receiving the rowset.
+     * @param heap Empty temporary stream, receiving the strings and blobs until
+     * they are copied to out by endStream.
+     */
+    void beginStream(std::ostream &out, std::iostream &heap);
+
+    /**
+     * @brief Complete the rowset written to the stream, and clear the builder.
+     * @return The size in bytes of the written rowset.
+     */
+    UInt64 endStream();
+
+    //! Clear the columns and the rows.
+    void clear();
+
+private:
+
+    struct Column
+    {
+        CString name;
+        DbVariable::IntType intType;
+        DbVariable::VarType varType;
+        UInt32 decimals;
+    };
+
+    std::vector<Column> m_columns;
+
+    std::vector<UInt8> m_rows;
+    std::vector<UInt8> m_heap;
+
+    UInt32 m_numRows;
+    UInt32 m_rowSize;
+    UInt32 m_nullSize;
+
+    std::ostream *m_out;            //!< Stream mode output, or null
+    std::iostream *m_heapOut;       //!< Stream mode heap
+    UInt64 m_streamStart;           //!< Position of the rowset in out
+    Bool m_streamStarted;           //!< Header and columns reserved
+    UInt32 m_flushedRows;           //!< Rows already written to out
+    UInt64 m_flushedHeap;           //!< Heap bytes already written to the heap stream
+
+    UInt8* lastSlot(UInt32 col);
+    UInt32 pushHeap(const void *data, UInt32 length);
+
+    //! Push the column names to the heap and fill the header for the rows.
+    void layout(MySqlRowSet::Header &header, std::vector<MySqlRowSet::ColumnDesc> &columns);
+
+    //! Write the pending rows and heap to the streams.
+    void flushStream();
+};
+
+} // namespace mysql
+} // namespace o3d
+
+#endif // _O3D_MYSQLROWSET_H
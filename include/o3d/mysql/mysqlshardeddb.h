@@ -0,0 +1,265 @@
+/**
+ * @file mysqlshardeddb.h
+ * @brief Hash sharded database over many MySqlDb.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#ifndef _O3D_MYSQLSHARDEDDB_H
+#define _O3D_MYSQLSHARDEDDB_H
+
+#include "mysqldb.h"
+#include "mysqlparams.h"
+#include "mysqlworkerpool.h"
+
+#include <vector>
+
+namespace o3d {
+namespace mysql {
+
+class MySqlShardedQuery;
+
+/**
+ * @brief MySqlShardedDb facade over many shards having the same schema.
+ * A query registered with a shard key is sent to the shard given by the hash of
+ * the bound value of this key. A query without shard key is sent to every shard
+ * in parallel, and the results are merged (optionally ordered and limited).
+ * As MySqlDb it is not thread-safe.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ */
+class O3D_MYSQL_API MySqlShardedDb : public Database
+{
+    friend class MySqlShardedQuery;
+
+public:
+
+    //! Default ctor. MySql::init() must be called before.
+    MySqlShardedDb();
+
+    //! Virtual dtor. Delete the shards.
+    virtual ~MySqlShardedDb();
+
+    //! Connect to the first shard. The others are added with addShard.
+    virtual Bool connect(
+        const String &host,
+        o3d::UInt32 port,
+        const String &database,
+        const String &user = "",
+        const String &password = "",
+        Bool keepPassord = True);
+
+    //! Disconnect from every shard.
+    virtual void disconnect();
+
+    //! Try to maintain the connections of every shard established.
+    virtual void pingConnection();
+
+    /**
+     * @brief Add and connect a shard, using the database, user and password
+     * given to connect(). The password must have been kept.
+     * @note The shard index is its order of insertion, and the set of shards must
+     * not change once data are distributed.
+     */
+    void addShard(const String &host, o3d::UInt32 port);
+
+    //! Add a connected shard. Its ownership is taken.
+    void addShard(MySqlDb *shard);
+
+    //! Get the number of shards.
+    inline UInt32 getNumShards() const { return (UInt32)m_shards.size(); }
+
+    //! Get a shard database.
+    MySqlDb* getShard(UInt32 index);
+
+    //! Get the shard index for a key hash.
+    inline UInt32 getShardIndex(UInt64 hash) const { return (UInt32)(hash % m_shards.size()); }
+
+    /**
+     * @brief Register a query routed by the value bound to an input attribute.
+     * @param shardKey Index of the input attribute containing the shard key.
+     */
+    DbQuery* registerShardedQuery(const String &name, const CString &query, UInt32 shardKey);
+
+protected:
+
+    //! Instanciate a new MySqlShardedQuery object, without shard key
+    virtual DbQuery* newDbQuery(const String &name, const CString &query);
+
+    //! Get the worker pool, created or grown to the number of shards.
+    MySqlWorkerPool* workerPool();
+
+    std::vector<MySqlDb*> m_shards;
+    MySqlWorkerPool *m_workerPool;
+};
+
+/**
+ * @brief MySqlShardedQuery query registered on a MySqlShardedDb.
+ * Inputs are recorded and replayed on the query of the target shards. Can't be
+ * deleted outside of the MySqlShardedDb.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ */
+class O3D_MYSQL_API MySqlShardedQuery : public DbQuery
+{
+    friend class MySqlShardedDb;
+
+public:
+
+    static const UInt32 NO_SHARD_KEY = 0xffffffff;
+
+    //! Virtual destructor
+    virtual ~MySqlShardedQuery();
+
+    //! Set the input attribute index of the shard key, or NO_SHARD_KEY.
+    inline void setShardKey(UInt32 attr) { m_shardKey = attr; }
+
+    //! Get the input attribute index of the shard key, or NO_SHARD_KEY.
+    inline UInt32 getShardKey() const { return m_shardKey; }
+
+    /**
+     * @brief Merge the results of a query without shard key ordered on a column.
+     * Each shard must return its rows already sorted on it (ORDER BY).
+     * Strings and blobs are compared byte per byte, so a string column must use a
+     * binary collation (utf8mb4_bin), the merge else being out of the order of the
+     * shards for a case or accent insensitive collation.
+     * @param column Output column name, empty for an unordered merge.
+     * @param descending True for a descending order.
+     */
+    void setMergeOrder(const CString &column, Bool descending = False);
+
+    //! Limit the number of merged rows (0 for no limit).
+    inline void setMergeLimit(UInt32 limit) { m_limit = limit; }
+
+    //! Set an input variable as ArrayUInt8. The array is duplicated.
+    virtual void setArrayUInt8(UInt32 attr, const ArrayUInt8 &v);
+
+    //! Set an input variable as SmartArrayUInt8. The array is duplicated.
+    virtual void setSmartArrayUInt8(UInt32 attr, const SmartArrayUInt8 &v);
+
+    //! Not supported, the stream could not be replayed.
+    virtual void setInStream(UInt32 attr, const InStream &v);
+
+    //! Set an input variable as Bool.
+    virtual void setBool(UInt32 attr, Bool v);
+
+    //! Set an input variable as Int32.
+    virtual void setInt32(UInt32 attr, Int32 v);
+
+    //! Set an input variable as UInt32.
+    virtual void setUInt32(UInt32 attr, UInt32 v);
+
+    //! Set an input variable as Int64.
+    virtual void setInt64(UInt32 attr, Int64 v);
+
+    //! Set an input variable as UInt64.
+    virtual void setUInt64(UInt32 attr, UInt64 v);
+
+    //! Set an input variable as Float.
+    virtual void setFloat(UInt32 attr, Float v);
+
+    //! Set an input variable as Double.
+    virtual void setDouble(UInt32 attr, Double v);
+
+    //! Set an input variable as CString.
+    virtual void setCString(UInt32 attr, const CString &v);
+
+    //! Set an input variable as Date.
+    virtual void setDate(UInt32 attr, const Date &date);
+
+    //! Set an input variable as Timestamp.
+    virtual void setTimestamp(UInt32 attr, const DateTime &date);
+
+    //! Get an output attribute id by its name.
+    virtual UInt32 getOutAttr(const CString &name);
+
+    //! Get an output variable of the current row by its name.
+    virtual const DbVariable& getOut(const CString &name) const;
+
+    //! Get an output variable of the current row by its index.
+    virtual const DbVariable& getOut(UInt32 attr) const;
+
+    //! Execute the query for a SELECT, on the key shard or on every shard.
+    virtual void execute();
+
+    //! Execute the query for an UPDATE, INSERT, or DELETE, on the key shard or on every shard.
+    virtual void update();
+
+    //! Get the number of affected or result rows after an execute or update.
+    virtual UInt32 getNumRows();
+
+    //! Get the result variable (ie for an auto increment). Only for a query with shard key.
+    virtual UInt64 getGeneratedKey() const;
+
+    //! Fetch the next (merged) row.
+    virtual Bool fetch();
+
+    //! Get the row position when fetching.
+    virtual UInt32 tellRow();
+
+    //! Set the row position when fetching. Merged results only support seek 0.
+    virtual void seekRow(UInt32 row);
+
+    //! Unbind the current input attributes.
+    virtual void unbind();
+
+protected:
+
+    //! Default ctor
+    MySqlShardedQuery(
+        MySqlShardedDb *shardedDb,
+        const String &name,
+        const CString &query,
+        UInt32 shardKey);
+
+    //! Get or register the query on a shard.
+    DbQuery* shardQuery(UInt32 shard);
+
+    //! Get the query of a shard, with the current inputs.
+    DbQuery* boundShardQuery(UInt32 shard);
+
+    //! Run execute() or update() on one shard or on every shard in parallel.
+    void run(Bool update);
+
+    //! Compare the current row of two shards on the merge column.
+    Int32 compareShards(UInt32 a, UInt32 b) const;
+
+    //! Get the query of the current row, or raise an error.
+    DbQuery* current() const;
+
+    MySqlShardedDb *m_shardedDb;
+
+    String m_name;
+    CString m_query;
+
+    UInt32 m_shardKey;
+
+    MySqlParams m_params;
+    UInt32 m_paramsVersion;
+
+    std::vector<DbQuery*> m_shardQueries;
+    std::vector<UInt32> m_shardVersions;
+
+    CString m_orderColumn;
+    UInt32 m_orderAttr;
+    Bool m_descending;
+    UInt32 m_limit;
+
+    //! Shard of the last key routed statement, or -1 if sent to every shard.
+    Int32 m_targetShard;
+
+    UInt32 m_numRows;
+    UInt32 m_currRow;
+
+    Int32 m_currentShard;             //!< Shard holding the current row
+    UInt32 m_cursor;                  //!< Unordered merge, shard being read
+    std::vector<UInt8> m_hasRow;      //!< Ordered merge, shards having a pending row
+    Bool m_mergeStarted;
+};
+
+} // namespace mysql
+} // namespace o3d
+
+#endif // _O3D_MYSQLSHARDEDDB_H
@@ -0,0 +1,103 @@
+/**
+ * @file mysqlsingleflight.h
+ * @brief Coalescing of identical concurrent reads.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#ifndef _O3D_MYSQLSINGLEFLIGHT_H
+#define _O3D_MYSQLSINGLEFLIGHT_H
+
+#include "mysqlrowset.h"
+#include "mysqlparams.h"
+
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace o3d {
+namespace mysql {
+
+class MySqlQuery;
+
+/**
+ * @brief MySqlSingleFlight let a single execute reach the server for the concurrent
+ * reads of the same query with the same parameters. The first caller (leader)
+ * executes on its own connection and materializes the result, the others wait
+ * for it and receive the same rowset, or the same error, without using their
+ * connection. A read starting once the leader finished executes again, so no
+ * result is older than the call.
+ * The reads are keyed by the query name and the parameters only, so an instance
+ * serves the connections of a single database. Use one instance per database, or
+ * with the generic execute give names including the database.
+ * Thread-safe, shared by the threads issuing the reads.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ */
+class O3D_MYSQL_API MySqlSingleFlight
+{
+public:
+
+    typedef std::shared_ptr<const MySqlRowSet> Result;
+
+    //! Load the result of a key, called by the leader only.
+    typedef std::function<Result()> Loader;
+
+    struct Stats
+    {
+        UInt64 executes;    //!< Reads done by a leader
+        UInt64 shared;      //!< Reads given the result of a leader
+    };
+
+    MySqlSingleFlight();
+
+    /**
+     * @brief Execute a registered query with parameters, or wait for the running
+     * execute of the same query name and parameters.
+     * @param query Query of the caller connection, used only if leader.
+     */
+    Result execute(MySqlQuery &query, const MySqlParams &params);
+
+    /**
+     * @brief Generic form, the loader being called only if there is no running
+     * load of the same name and parameters.
+     */
+    Result execute(const String &name, const MySqlParams &params, const Loader &loader);
+
+    //! Get the number of running loads.
+    UInt32 getNumInFlight() const;
+
+    //! Get the counters.
+    Stats getStats() const;
+
+    //! Hash of a name and parameters. @see MySqlParams::key
+    static UInt64 key(const String &name, const MySqlParams &params);
+
+private:
+
+    struct Flight
+    {
+        String name;
+        MySqlParams params;
+        std::shared_future<Result> result;
+    };
+
+    typedef std::unordered_multimap<UInt64, std::shared_ptr<Flight>> Flights;
+
+    Flights m_flights;
+    Stats m_stats;
+
+    mutable std::mutex m_mutex;
+
+    //! Same name and same parameters.
+    static Bool same(const Flight &flight, const String &name, const MySqlParams &params);
+};
+
+} // namespace mysql
+} // namespace o3d
+
+#endif // _O3D_MYSQLSINGLEFLIGHT_H
@@ -0,0 +1,108 @@
+/**
+ * @file mysqlsnapshotcache.h
+ * @brief On disk memory mapped snapshots of query results.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#ifndef _O3D_MYSQLSNAPSHOTCACHE_H
+#define _O3D_MYSQLSNAPSHOTCACHE_H
+
+#include "mysqlrowset.h"
+#include "mysqlparams.h"
+
+namespace o3d {
+namespace mysql {
+
+class MySqlDb;
+class MySqlQuery;
+
+/**
+ * @brief MySqlSnapshotCache keep the whole result of reference data queries into
+ * files, one per query and parameters, at the MySqlRowSet format.
+ * A file is mapped in memory and read with the rowset API without any copy, and
+ * without contacting the server when its version is still valid. The version is
+ * the result of a cheap query given by the caller, such as "CHECKSUM TABLE t" or
+ * "SELECT MAX(updated_at) FROM t".
+ * A new snapshot is streamed from the server to the file row by row, then mapped,
+ * so the memory used to build it is bounded whatever the size of the result.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ */
+class O3D_MYSQL_API MySqlSnapshotCache
+{
+public:
+
+    /**
+     * @brief Snapshot cache into a directory.
+     * @param db Connection used to query the versions and to build the snapshots.
+     * Can be null to only open existing snapshots.
+     */
+    MySqlSnapshotCache(MySqlDb *db, const String &directory);
+
+    /**
+     * @brief Get the result of a query. The snapshot is mapped if its version
+     * matches the version given by the server, else the query is run and its
+     * result written as the new snapshot.
+     * @param name Query name, used for the file name and to register the query.
+     * @param sql Query to snapshot.
+     * @param params Parameters of the query.
+     * @param versionSql Single row query, whose text values form the version.
+     */
+    std::shared_ptr<const MySqlRowSet> get(
+            const String &name,
+            const CString &sql,
+            const MySqlParams &params,
+            const CString &versionSql);
+
+    /**
+     * @brief Map an existing snapshot without contacting the server.
+     * @param version If non null receive the version of the snapshot.
+     * @return Null if there is no valid snapshot.
+     */
+    std::shared_ptr<const MySqlRowSet> open(
+            const String &name,
+            const CString &sql,
+            const MySqlParams &params,
+            CString *version = nullptr) const;
+
+    //! Remove the snapshot of a query.
+    void invalidate(const String &name, const CString &sql, const MySqlParams &params);
+
+    //! Get the file name of the snapshot of a query.
+    String getPath(const String &name, const CString &sql, const MySqlParams &params) const;
+
+    //! Key of a query and its parameters.
+    static UInt64 key(const CString &sql, const MySqlParams &params);
+
+private:
+
+    static const UInt32 VERSION = 1;
+
+    struct FileHeader
+    {
+        Char magic[8];          //!< "O3DSNAP"
+        UInt32 version;
+        UInt32 versionLength;   //!< Length of the version string following the header
+        UInt64 key;
+        UInt64 rowSetOffset;    //!< 8 bytes aligned
+        UInt64 rowSetSize;
+    };
+
+    MySqlDb *m_db;
+    String m_directory;
+
+    //! Run the version query.
+    CString queryVersion(const CString &versionSql);
+
+    //! Write the result of an executed query, streamed row by row into a
+    //! temporary file, synced and renamed once completed.
+    void write(const String &path, UInt64 keyHash, const CString &version, MySqlQuery &query);
+};
+
+} // namespace mysql
+} // namespace o3d
+
+#endif // _O3D_MYSQLSNAPSHOTCACHE_H
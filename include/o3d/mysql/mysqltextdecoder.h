@@ -0,0 +1,117 @@
+/**
+ * @file mysqltextdecoder.h
+ * @brief UTF-8 validation and decoding of text outputs into String.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#ifndef _O3D_MYSQLTEXTDECODER_H
+#define _O3D_MYSQLTEXTDECODER_H
+
+#include "mysql.h"
+
+#include <o3d/core/base.h>
+
+#include <vector>
+
+namespace o3d {
+namespace mysql {
+
+class MySqlQuery;
+class MySqlRowBlock;
+
+/**
+ * @brief MySqlTextDecoder validate and decode UTF-8 text (utf8mb4 columns) into
+ * String, through a buffer reused from a value to the next. The runs of ASCII,
+ * the most of the text, are detected and widened by 16 (SSE2) or 32 (AVX2) bytes,
+ * the other characters being decoded one by one. The instruction set is the best
+ * one supported by the CPU, detected at runtime, with a scalar fallback.
+ * Not thread-safe, use one decoder per thread.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ */
+class O3D_MYSQL_API MySqlTextDecoder
+{
+public:
+
+    enum Isa
+    {
+        ISA_SCALAR = 0,
+        ISA_SSE2,
+        ISA_AVX2
+    };
+
+    //! Decoder using the best instruction set of the CPU.
+    MySqlTextDecoder();
+
+    //! Get the best instruction set supported by the CPU.
+    static Isa getBestIsa();
+
+    //! Force an instruction set, which must be supported by the CPU.
+    void setIsa(Isa isa);
+
+    //! Get the used instruction set.
+    inline Isa getIsa() const { return m_isa; }
+
+    /**
+     * @brief In strict mode an invalid sequence raises E_InvalidFormat, else it is
+     * replaced by U+FFFD (default).
+     */
+    inline void setStrict(Bool strict) { m_strict = strict; }
+
+    //! Is strict mode.
+    inline Bool isStrict() const { return m_strict; }
+
+    //! Check if a text is only ASCII.
+    Bool isAscii(const Char *data, size_t length) const;
+
+    //! Check if a text is valid UTF-8 (no overlong, surrogate or out of range).
+    Bool validate(const Char *data, size_t length) const;
+
+    /**
+     * @brief Decode a text into the internal buffer, as UTF-32, or UTF-16 when
+     * WChar is 16 bits.
+     * @param outLength Receive the number of WChar.
+     * @return The buffer, zero terminated, valid until the next decode.
+     */
+    const WChar* decode(const Char *data, size_t length, UInt32 &outLength);
+
+    //! Decode a text into a String.
+    void decode(const Char *data, size_t length, String &out);
+
+    /**
+     * @brief Decode a string output of the current row of a query, without the
+     * copy of its DbVariable.
+     * @return False for a NULL value, out being emptied.
+     */
+    Bool decodeOutput(const MySqlQuery &query, UInt32 attr, String &out);
+
+    /**
+     * @brief Decode a string column of every row of a block. The strings of out
+     * are reused. A NULL value gives an empty string.
+     */
+    void decodeColumn(const MySqlRowBlock &block, UInt32 col, std::vector<String> &out);
+
+private:
+
+    //! Length of the leading whole blocks of ASCII.
+    typedef size_t (*AsciiFunc)(const UInt8 *data, size_t length);
+
+    //! Widen the leading whole blocks of ASCII, returning their length.
+    typedef size_t (*WidenFunc)(const UInt8 *data, size_t length, WChar *out);
+
+    Isa m_isa;
+    AsciiFunc m_ascii;
+    WidenFunc m_widen;
+
+    Bool m_strict;
+
+    std::vector<WChar> m_buffer;
+};
+
+} // namespace mysql
+} // namespace o3d
+
+#endif // _O3D_MYSQLTEXTDECODER_H
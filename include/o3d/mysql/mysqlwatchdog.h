@@ -0,0 +1,119 @@
+/**
+ * @file mysqlwatchdog.h
+ * @brief Deadlines of the running queries.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#ifndef _O3D_MYSQLWATCHDOG_H
+#define _O3D_MYSQLWATCHDOG_H
+
+#include "mysql.h"
+
+#include <o3d/core/base.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace o3d {
+namespace mysql {
+
+class MySqlDb;
+
+/**
+ * @brief MySqlWatchdog single thread cancelling, with MySqlDb::cancel, the queries
+ * still running once their deadline passed. It is started on the first deadline,
+ * and registered to the client library (mysql_thread_init) for its whole life.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ */
+class O3D_MYSQL_API MySqlWatchdog
+{
+public:
+
+    //! Get the process wide instance.
+    static MySqlWatchdog& instance();
+
+    //! Stop the thread.
+    ~MySqlWatchdog();
+
+    MySqlWatchdog(const MySqlWatchdog&) = delete;
+    MySqlWatchdog& operator= (const MySqlWatchdog&) = delete;
+
+    /**
+     * @brief Cancel the running query of a connection in timeout milliseconds.
+     * The password of the connection must have been kept at connect, else raises
+     * E_InvalidPrecondition rather than failing at the deadline.
+     * @return Identifier of the deadline.
+     */
+    UInt64 arm(MySqlDb *db, UInt32 timeout);
+
+    /**
+     * @brief Remove a deadline, once its query returned, waiting for its cancel
+     * if running.
+     * @return True if the deadline passed and the query has been cancelled.
+     */
+    Bool disarm(UInt64 id);
+
+private:
+
+    typedef std::chrono::steady_clock Clock;
+
+    struct Deadline
+    {
+        MySqlDb *db;
+        Clock::time_point time;
+        Bool firing;    //!< Cancel running
+        Bool fired;     //!< Cancel done
+    };
+
+    std::map<UInt64, Deadline> m_deadlines;
+    UInt64 m_nextId;
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+
+    std::thread m_thread;
+    Bool m_running;
+
+    MySqlWatchdog();
+
+    void run();
+};
+
+/**
+ * @brief MySqlDeadline arm a deadline for a scope, disarmed at its end.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ */
+class O3D_MYSQL_API MySqlDeadline
+{
+public:
+
+    //! No deadline for a null timeout.
+    MySqlDeadline(MySqlDb *db, UInt32 timeout);
+
+    ~MySqlDeadline();
+
+    MySqlDeadline(const MySqlDeadline&) = delete;
+    MySqlDeadline& operator= (const MySqlDeadline&) = delete;
+
+    //! Disarm now. Return True if the query has been cancelled by the deadline.
+    Bool expired();
+
+private:
+
+    UInt64 m_id;
+    Bool m_armed;
+    Bool m_expired;
+};
+
+} // namespace mysql
+} // namespace o3d
+
+#endif // _O3D_MYSQLWATCHDOG_H
@@ -0,0 +1,75 @@
+/**
+ * @file mysqlworkerpool.h
+ * @brief Fixed pool of worker threads for the parallel statements.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#ifndef _O3D_MYSQLWORKERPOOL_H
+#define _O3D_MYSQLWORKERPOOL_H
+
+#include "mysql.h"
+
+#include <o3d/core/base.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace o3d {
+namespace mysql {
+
+/**
+ * @brief MySqlWorkerPool run tasks on a fixed set of threads. Each task must use
+ * its own connection, a MySqlDb being never shared by two running tasks.
+ * The exceptions raised by a task are given back by the returned future.
+ * The threads are registered to the client library (mysql_thread_init) for
+ * their whole life.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ */
+class O3D_MYSQL_API MySqlWorkerPool
+{
+public:
+
+    //! Start the threads.
+    MySqlWorkerPool(UInt32 numThreads);
+
+    //! Finish the pending tasks and join the threads.
+    ~MySqlWorkerPool();
+
+    //! Get the number of threads.
+    inline UInt32 getNumThreads() const { return (UInt32)m_threads.size(); }
+
+    //! Queue a task.
+    std::future<void> submit(const std::function<void()> &task);
+
+    /**
+     * @brief Wait for a list of futures, and raise the first error if any after
+     * all of them are done.
+     */
+    static void waitAll(std::vector<std::future<void>> &futures);
+
+private:
+
+    std::vector<std::thread> m_threads;
+    std::deque<std::packaged_task<void()>> m_tasks;
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+
+    Bool m_running;
+
+    void run();
+};
+
+} // namespace mysql
+} // namespace o3d
+
+#endif // _O3D_MYSQLWORKERPOOL_H
@@ -0,0 +1,184 @@
+/**
+ * @file mysqlwritebehind.h
+ * @brief Coalescing buffer of the upserts of hot rows.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#ifndef _O3D_MYSQLWRITEBEHIND_H
+#define _O3D_MYSQLWRITEBEHIND_H
+
+#include "mysql.h"
+#include "mysqlparams.h"
+
+#include <o3d/core/base.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace o3d {
+namespace mysql {
+
+class MySqlDb;
+
+/**
+ * @brief MySqlWriteBehind keep in memory the last written row of each primary key
+ * of a table, or the sum of the increments of its counter columns, and flush them
+ * periodically or once maxRows keys are pending, as multi-row
+ * INSERT ... ON DUPLICATE KEY UPDATE. Many writes of the same row between two
+ * flushes cost a single row of a single statement.
+ * The connection is owned by the write-behind, flushing from its thread, and must
+ * not be used meanwhile. Writes are thread-safe. A write reaching maxRows flushes
+ * before returning, which bounds the memory. A failed flush keeps its rows,
+ * merged under the newer writes, and its error is raised by the next write or
+ * flush. Until a flush succeeds, a write of a new key while maxRows keys are
+ * pending raises E_MySqlOverload, so the memory stays bounded while the server
+ * is down. The rows still pending at destruction are lost, so flush at shutdown.
+ * The flush thread is registered to the client library (mysql_thread_init).
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ */
+class O3D_MYSQL_API MySqlWriteBehind
+{
+public:
+
+    enum Merge
+    {
+        MERGE_KEY = 0,      //!< Part of the primary key
+        MERGE_REPLACE,      //!< Last written value wins
+        MERGE_ADD           //!< Increments are summed, added to the stored value
+    };
+
+    struct Stats
+    {
+        UInt64 writes;      //!< Calls to write
+        UInt64 coalesced;   //!< Writes merged into a pending row
+        UInt64 rows;        //!< Rows sent
+        UInt64 statements;  //!< Statements executed
+        UInt64 failures;    //!< Failed flushes
+    };
+
+    /**
+     * @brief Start the flush thread.
+     * @param db Dedicated connection.
+     * @param table Destination table.
+     * @param interval Delay in milliseconds between two flushes, 0 for explicit
+     * flushes only.
+     * @param maxRows Max pending keys, flushed once reached.
+     * @param batchSize Max rows per statement.
+     */
+    MySqlWriteBehind(
+            MySqlDb *db,
+            const CString &table,
+            UInt32 interval = 1000,
+            UInt32 maxRows = 10000,
+            UInt32 batchSize = 256);
+
+    //! Stop the thread, without flush.
+    virtual ~MySqlWriteBehind();
+
+    MySqlWriteBehind(const MySqlWriteBehind&) = delete;
+    MySqlWriteBehind& operator= (const MySqlWriteBehind&) = delete;
+
+    /**
+     * @brief Add a column, before any write. The attribute of the column in the
+     * written rows is its order of addition.
+     */
+    void addColumn(const CString &name, Merge merge);
+
+    //! Get the number of columns.
+    inline UInt32 getNumColumns() const { return (UInt32)m_columns.size(); }
+
+    /**
+     * @brief Write a row, every column being set. Merged with the pending row of
+     * the same key if any. Raises E_MySqlOverload for a new key if full since a
+     * failed flush.
+     */
+    void write(const MySqlParams &row);
+
+    //! Send every pending row now, and raise the error of a failed flush.
+    void flush();
+
+    //! Get the number of pending keys.
+    UInt32 getNumPending() const;
+
+    //! Get the counters.
+    Stats getStats() const;
+
+    //! Build the statement for a number of rows.
+    CString getStatement(UInt32 numRows) const;
+
+protected:
+
+    //! Send rows by batches, numSent counting the rows of the executed statements.
+    virtual void send(const std::vector<MySqlParams> &rows, size_t &numSent);
+
+private:
+
+    struct Column
+    {
+        CString name;
+        Merge merge;
+    };
+
+    //! Pending rows, indexed by the hash of their key.
+    struct Pending
+    {
+        std::vector<MySqlParams> rows;
+        std::unordered_multimap<UInt64, UInt32> index;
+    };
+
+    MySqlDb *m_db;
+    CString m_table;
+
+    std::vector<Column> m_columns;
+    std::vector<UInt32> m_keys;     //!< Attributes of the key columns
+
+    std::chrono::milliseconds m_interval;
+    UInt32 m_maxRows;
+    UInt32 m_batchSize;
+
+    Pending m_pending;
+    std::exception_ptr m_error;     //!< Of the last failed flush
+    Bool m_failing;                 //!< Last flush failed
+    Stats m_stats;
+
+    mutable std::mutex m_mutex;
+    std::mutex m_flushMutex;        //!< Owner of the connection
+    std::condition_variable m_condition;
+
+    std::map<UInt32, DbQuery*> m_queries;   //!< Prepared per number of rows
+
+    std::thread m_thread;
+    Bool m_running;
+
+    //! Hash of the key of a row.
+    UInt64 hashKey(const MySqlParams &row) const;
+
+    //! Index of the pending row of the key of a row, -1 if none.
+    Int32 find(const MySqlParams &row, UInt64 hash) const;
+
+    //! Merge a row into the pending ones. An older row doesn't replace the values.
+    Bool merge(const MySqlParams &row, Bool older);
+
+    //! Take the pending rows and send them, the flush mutex being locked.
+    void flushPending();
+
+    //! Get the query for a number of rows.
+    DbQuery* query(UInt32 numRows);
+
+    void run();
+};
+
+} // namespace mysql
+} // namespace o3d
+
+#endif // _O3D_MYSQLWRITEBEHIND_H
@@ -0,0 +1,231 @@
+/**
+ * @file mysqladmission.cpp
+ * @brief Adaptive concurrency limits of the statements per query.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#include "o3d/mysql/mysqladmission.h"
+#include "o3d/mysql/mysqlexception.h"
+
+#include <algorithm>
+
+using namespace o3d;
+using namespace o3d::mysql;
+
+//
+// MySqlAdmission::Permit
+//
+
+MySqlAdmission::Permit::Permit(MySqlAdmission *admission, const String &name) :
+    m_admission(admission),
+    m_name(name),
+    m_released(False)
+{
+    if (m_admission) {
+        m_admission->acquire(m_name);
+        m_start = std::chrono::steady_clock::now();
+    }
+}
+
+MySqlAdmission::Permit::~Permit()
+{
+    if (m_admission && !m_released) {
+        m_admission->release(m_name, 0.f, False);
+    }
+}
+
+void MySqlAdmission::Permit::succeeded()
+{
+    if (m_admission && !m_released) {
+        Float latency = std::chrono::duration<Float, std::milli>(
+                    std::chrono::steady_clock::now() - m_start).count();
+
+        // a null latency is not a sample
+        m_admission->release(m_name, std::max(latency, 0.001f), False);
+        m_released = True;
+    }
+}
+
+void MySqlAdmission::Permit::overloaded()
+{
+    if (m_admission && !m_released) {
+        m_admission->release(m_name, 0.f, True);
+        m_released = True;
+    }
+}
+
+//
+// MySqlAdmission
+//
+
+MySqlAdmission::MySqlAdmission(
+        UInt32 initialLimit,
+        UInt32 maxLimit,
+        UInt32 maxQueue,
+        UInt32 maxWait) :
+    m_initialLimit((Float)initialLimit),
+    m_minLimit(1.f),
+    m_maxLimit((Float)maxLimit),
+    m_maxQueue(maxQueue),
+    m_maxWait(maxWait),
+    m_tolerance(2.f),
+    m_backoff(0.9f)
+{
+    if (initialLimit == 0 || maxLimit < initialLimit) {
+        O3D_ERROR(E_InvalidParameter("Initial limit must be between 1 and the max limit"));
+    }
+}
+
+void MySqlAdmission::setMinLimit(UInt32 limit)
+{
+    if (limit == 0 || (Float)limit > m_maxLimit) {
+        O3D_ERROR(E_InvalidParameter("Min limit must be between 1 and the max limit"));
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_minLimit = (Float)limit;
+}
+
+void MySqlAdmission::setTolerance(Float tolerance)
+{
+    if (tolerance <= 1.f) {
+        O3D_ERROR(E_InvalidParameter("Tolerance must be greater than 1"));
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_tolerance = tolerance;
+}
+
+void MySqlAdmission::setBackoff(Float backoff)
+{
+    if (backoff <= 0.f || backoff >= 1.f) {
+        O3D_ERROR(E_InvalidParameter("Backoff must be between 0 and 1 excluded"));
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_backoff = backoff;
+}
+
+MySqlAdmission::Stats MySqlAdmission::getStats(const String &name) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    Stats stats;
+
+    auto it = m_classes.find(name);
+    if (it == m_classes.end()) {
+        stats.limit = m_initialLimit;
+        stats.inFlight = 0;
+        stats.queued = 0;
+        stats.latency = 0.f;
+        stats.baseline = 0.f;
+        stats.admitted = 0;
+        stats.rejected = 0;
+    } else {
+        const Class &c = it->second;
+
+        stats.limit = c.limit;
+        stats.inFlight = c.inFlight;
+        stats.queued = c.queued;
+        stats.latency = c.latency;
+        stats.baseline = c.baseline;
+        stats.admitted = c.admitted;
+        stats.rejected = c.rejected;
+    }
+
+    return stats;
+}
+
+MySqlAdmission::Class &MySqlAdmission::getClass(const String &name)
+{
+    auto it = m_classes.find(name);
+    if (it != m_classes.end()) {
+        return it->second;
+    }
+
+    // constructed in place, the condition being not movable
+    Class &c = m_classes[name];
+
+    c.limit = m_initialLimit;
+    c.inFlight = 0;
+    c.queued = 0;
+    c.sinceDecrease = 0;
+    c.latency = 0.f;
+    c.baseline = 0.f;
+    c.admitted = 0;
+    c.rejected = 0;
+
+    return c;
+}
+
+void MySqlAdmission::acquire(const String &name)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    Class &c = getClass(name);
+
+    auto admissible = [&c] () { return c.inFlight < (UInt32)c.limit; };
+
+    if (!admissible()) {
+        if (c.queued >= m_maxQueue) {
+            ++c.rejected;
+            O3D_ERROR(E_MySqlOverload(String("Query ") + name + " rejected, too many running"));
+        }
+
+        ++c.queued;
+        Bool admitted = c.condition.wait_for(lock, m_maxWait, admissible);
+        --c.queued;
+
+        if (!admitted) {
+            ++c.rejected;
+            O3D_ERROR(E_MySqlOverload(String("Query ") + name + " rejected, waited too long"));
+        }
+    }
+
+    ++c.inFlight;
+    ++c.admitted;
+}
+
+void MySqlAdmission::release(const String &name, Float latency, Bool overloaded)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Class &c = getClass(name);
+
+    --c.inFlight;
+    ++c.sinceDecrease;
+
+    if (overloaded) {
+        decrease(c);
+    } else if (latency > 0.f) {
+        c.latency = c.latency <= 0.f ? latency : 0.9f * c.latency + 0.1f * latency;
+
+        // lowest latency, drifting slowly toward the current one to follow a lasting change
+        if (c.baseline <= 0.f || latency < c.baseline) {
+            c.baseline = latency;
+        } else {
+            c.baseline += (c.latency - c.baseline) * 0.01f;
+        }
+
+        if (c.latency > c.baseline * m_tolerance) {
+            decrease(c);
+        } else if (c.inFlight + 1 >= (UInt32)c.limit) {
+            // additive increase of one per window, only while the limit is used
+            c.limit = std::min(c.limit + 1.f / c.limit, m_maxLimit);
+        }
+    }
+
+    c.condition.notify_one();
+}
+
+void MySqlAdmission::decrease(Class &c)
+{
+    // a single decrease for the statements started before it
+    if ((Float)c.sinceDecrease < c.limit) {
+        return;
+    }
+
+    c.limit = std::max(c.limit * m_backoff, m_minLimit);
+    c.sinceDecrease = 0;
+}
@@ -0,0 +1,87 @@
+/**
+ * @file mysqlarena.cpp
+ * @brief Bump allocator for the fetched row data.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#include "o3d/mysql/mysqlarena.h"
+
+#include <o3d/core/debug.h>
+
+#include <algorithm>
+
+using namespace o3d;
+using namespace o3d::mysql;
+
+MySqlArena::MySqlArena(UInt32 blockSize) :
+    m_current(0),
+    m_blockSize(blockSize > 0 ? blockSize : DEFAULT_BLOCK_SIZE),
+    m_usedSize(0),
+    m_reservedSize(0)
+{
+
+}
+
+MySqlArena::~MySqlArena()
+{
+    for (Block &block : m_blocks) {
+        delete [] block.data;
+    }
+}
+
+UInt8 *MySqlArena::allocate(UInt32 size, UInt32 alignment)
+{
+    O3D_ASSERT(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+    while (m_current < m_blocks.size()) {
+        Block &block = m_blocks[m_current];
+
+        UInt32 offset = (block.used + alignment - 1) & ~(alignment - 1);
+        if (offset <= block.size && size <= block.size - offset) {
+            block.used = offset + size;
+            m_usedSize += size;
+
+            return block.data + offset;
+        }
+
+        ++m_current;
+    }
+
+    // new block, new[] returns a storage aligned for any fundamental type
+    Block block;
+    block.size = std::max(m_blockSize, size);
+    block.data = new UInt8[block.size];
+    block.used = size;
+
+    m_blocks.push_back(block);
+    m_current = m_blocks.size() - 1;
+
+    m_usedSize += size;
+    m_reservedSize += block.size;
+
+    return block.data;
+}
+
+void MySqlArena::reset()
+{
+    for (Block &block : m_blocks) {
+        block.used = 0;
+    }
+
+    m_current = 0;
+    m_usedSize = 0;
+}
+
+void MySqlArena::shrink()
+{
+    reset();
+
+    while (m_blocks.size() > 1) {
+        m_reservedSize -= m_blocks.back().size;
+        delete [] m_blocks.back().data;
+        m_blocks.pop_back();
+    }
+}
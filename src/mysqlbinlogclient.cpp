@@ -0,0 +1,881 @@
+/**
+ * @file mysqlbinlogclient.cpp
+ * @brief Row changes read from the binary log, for cache invalidation.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#include "o3d/mysql/mysqlbinlogclient.h"
+#include "o3d/mysql/mysqldb.h"
+#include "o3d/mysql/mysqlexception.h"
+
+#include <o3d/core/debug.h>
+
+#include <cstdlib>
+#include <cstring>
+
+using namespace o3d;
+using namespace o3d::mysql;
+
+// binary log event types
+static const UInt8 ROTATE_EVENT = 4;
+static const UInt8 FORMAT_DESCRIPTION_EVENT = 15;
+static const UInt8 TABLE_MAP_EVENT = 19;
+static const UInt8 WRITE_ROWS_EVENT_V1 = 23;
+static const UInt8 UPDATE_ROWS_EVENT_V1 = 24;
+static const UInt8 DELETE_ROWS_EVENT_V1 = 25;
+static const UInt8 WRITE_ROWS_EVENT = 30;
+static const UInt8 UPDATE_ROWS_EVENT = 31;
+static const UInt8 DELETE_ROWS_EVENT = 32;
+static const UInt8 PARTIAL_UPDATE_ROWS_EVENT = 39;
+
+static const size_t EVENT_HEADER_SIZE = 19;
+
+// optional metadata of the table map
+static const UInt8 TABLE_MAP_SIGNEDNESS = 1;
+
+static inline UInt64 readLE(const UInt8 *pos, size_t size)
+{
+    UInt64 v = 0;
+    for (size_t i = 0; i < size; ++i) {
+        v |= (UInt64)pos[i] << (8 * i);
+    }
+
+    return v;
+}
+
+static inline void checkSize(const UInt8 *pos, const UInt8 *end, size_t size)
+{
+    if (pos > end || (size_t)(end - pos) < size) {
+        O3D_ERROR(E_InvalidFormat("Truncated binary log event"));
+    }
+}
+
+//! Length encoded integer of the protocol.
+static UInt64 readPacked(const UInt8 *&pos, const UInt8 *end)
+{
+    checkSize(pos, end, 1);
+
+    UInt8 first = *pos++;
+    size_t size = 0;
+
+    if (first < 251) {
+        return first;
+    } else if (first == 252) {
+        size = 2;
+    } else if (first == 253) {
+        size = 3;
+    } else if (first == 254) {
+        size = 8;
+    } else {
+        O3D_ERROR(E_InvalidFormat("Invalid packed integer in a binary log event"));
+    }
+
+    checkSize(pos, end, size);
+
+    UInt64 v = readLE(pos, size);
+    pos += size;
+
+    return v;
+}
+
+static inline Bool isNumeric(UInt8 type)
+{
+    switch (type) {
+    case MYSQL_TYPE_TINY:
+    case MYSQL_TYPE_SHORT:
+    case MYSQL_TYPE_INT24:
+    case MYSQL_TYPE_LONG:
+    case MYSQL_TYPE_LONGLONG:
+    case MYSQL_TYPE_FLOAT:
+    case MYSQL_TYPE_DOUBLE:
+    case MYSQL_TYPE_DECIMAL:
+    case MYSQL_TYPE_NEWDECIMAL:
+        return True;
+    default:
+        return False;
+    }
+}
+
+//! Bytes of a packed decimal.
+static size_t decimalSize(UInt32 precision, UInt32 scale)
+{
+    static const UInt32 dig2bytes[10] = { 0, 1, 1, 2, 2, 3, 3, 4, 4, 4 };
+
+    UInt32 intg = precision - scale;
+    return (intg / 9) * 4 + dig2bytes[intg % 9] + (scale / 9) * 4 + dig2bytes[scale % 9];
+}
+
+MySqlBinlogClient::MySqlBinlogClient(MySqlDb *db, UInt32 serverId) :
+    m_db(db),
+    m_serverId(serverId),
+    m_heartbeatPeriod(1000),
+    m_open(False),
+    m_stopping(False),
+    m_offset(4),
+    m_checksumSize(0),
+    m_minimalImage(False),
+    m_nextId(1)
+{
+    if (!db) {
+        O3D_ERROR(E_InvalidParameter("Null connection"));
+    }
+
+    if (serverId == 0) {
+        O3D_ERROR(E_InvalidParameter("Server id must be greater than 0"));
+    }
+
+    memset(&m_rpl, 0, sizeof(MYSQL_RPL));
+}
+
+MySqlBinlogClient::~MySqlBinlogClient()
+{
+    close();
+}
+
+UInt32 MySqlBinlogClient::subscribe(
+        const CString &database,
+        const CString &table,
+        const std::vector<UInt32> &keyColumns,
+        const Callback &callback)
+{
+    if (keyColumns.empty()) {
+        O3D_ERROR(E_InvalidParameter("At least one key column is needed"));
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    Subscription subscription;
+    subscription.database = database;
+    subscription.table = table;
+    subscription.keyColumns = keyColumns;
+    subscription.callback = callback;
+
+    UInt32 id = m_nextId++;
+    m_subscriptions[id] = subscription;
+
+    return id;
+}
+
+void MySqlBinlogClient::unsubscribe(UInt32 id)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_subscriptions.erase(id) == 0) {
+        O3D_ERROR(E_InvalidParameter("Unknown subscription"));
+    }
+}
+
+void MySqlBinlogClient::open(const CString &file, UInt64 offset)
+{
+    MYSQL *pDb = m_db->m_pDB;
+    if (!pDb) {
+        O3D_ERROR(E_InvalidOperation("Not connected"));
+    }
+
+    if (m_open) {
+        O3D_ERROR(E_InvalidOperation("Binary log stream already open"));
+    }
+
+    if (file.isEmpty()) {
+        // SHOW MASTER STATUS is removed since 8.4 but SHOW BINARY LOG STATUS only exists since 8.2
+        if (mysql_query(pDb, "SHOW BINARY LOG STATUS") != 0) {
+            if (mysql_query(pDb, "SHOW MASTER STATUS") != 0) {
+                O3D_ERROR(E_MySqlError(mysql_error(pDb)));
+            }
+        }
+
+        MYSQL_RES *result = mysql_store_result(pDb);
+        if (!result) {
+            O3D_ERROR(E_MySqlError(mysql_error(pDb)));
+        }
+
+        MYSQL_ROW row = mysql_fetch_row(result);
+        if (!row || !row[0] || !row[1]) {
+            mysql_free_result(result);
+            O3D_ERROR(E_MySqlError("Binary logging is not enabled on the server"));
+        }
+
+        m_file = row[0];
+        m_offset = strtoull(row[1], nullptr, 10);
+
+        mysql_free_result(result);
+    } else {
+        m_file = file.getData();
+        m_offset = offset;
+    }
+
+    // announce the support of the checksums, the server refusing the dump else
+    if (mysql_query(pDb, "SET @source_binlog_checksum = @@global.binlog_checksum") != 0) {
+        if (mysql_query(pDb, "SET @master_binlog_checksum = @@global.binlog_checksum") != 0) {
+            O3D_ERROR(E_MySqlError(mysql_error(pDb)));
+        }
+    }
+
+    if (mysql_query(pDb, "SELECT @@global.binlog_checksum, @@global.binlog_format, @@global.binlog_row_image") != 0) {
+        O3D_ERROR(E_MySqlError(mysql_error(pDb)));
+    }
+
+    MYSQL_RES *result = mysql_store_result(pDb);
+    if (!result) {
+        O3D_ERROR(E_MySqlError(mysql_error(pDb)));
+    }
+
+    // the events before the format description are checksummed the same way
+    MYSQL_ROW row = mysql_fetch_row(result);
+    m_checksumSize = (row && row[0] && strcmp(row[0], "NONE") != 0) ? 4 : 0;
+
+    // the changes logged as statements would be missed
+    if (!row || !row[1] || strcmp(row[1], "ROW") != 0) {
+        mysql_free_result(result);
+        O3D_ERROR(E_InvalidPrecondition("The binlog_format of the server must be ROW"));
+    }
+
+    m_minimalImage = row[2] && strcmp(row[2], "MINIMAL") == 0;
+
+    mysql_free_result(result);
+
+    if (m_heartbeatPeriod > 0) {
+        // in nanoseconds
+        std::string sql = std::to_string((UInt64)m_heartbeatPeriod * 1000000);
+
+        if (mysql_query(pDb, ("SET @source_heartbeat_period = " + sql).c_str()) != 0) {
+            if (mysql_query(pDb, ("SET @master_heartbeat_period = " + sql).c_str()) != 0) {
+                O3D_ERROR(E_MySqlError(mysql_error(pDb)));
+            }
+        }
+    }
+
+    memset(&m_rpl, 0, sizeof(MYSQL_RPL));
+    m_rpl.file_name_length = m_file.length();
+    m_rpl.file_name = m_file.c_str();
+    m_rpl.start_position = m_offset;
+    m_rpl.server_id = m_serverId;
+    m_rpl.flags = 0;
+
+    if (mysql_binlog_open(pDb, &m_rpl) != 0) {
+        O3D_ERROR(E_MySqlError(mysql_error(pDb)));
+    }
+
+    m_tables.clear();
+    m_open = True;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopping = False;
+}
+
+void MySqlBinlogClient::close()
+{
+    if (m_open) {
+        mysql_binlog_close(m_db->m_pDB, &m_rpl);
+        m_open = False;
+    }
+}
+
+Bool MySqlBinlogClient::poll()
+{
+    if (!m_open) {
+        O3D_ERROR(E_InvalidOperation("Binary log stream not open"));
+    }
+
+    MYSQL *pDb = m_db->m_pDB;
+
+    if (mysql_binlog_fetch(pDb, &m_rpl) != 0) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        if (m_stopping) {
+            lock.unlock();
+            close();
+            return False;
+        }
+
+        O3D_ERROR(E_MySqlError(mysql_error(pDb)));
+    }
+
+    // end of the stream
+    if (m_rpl.size == 0) {
+        close();
+        return False;
+    }
+
+    // the event follows the OK byte of the packet
+    if (m_rpl.size > 1) {
+        processEvent(m_rpl.buffer + 1, m_rpl.size - 1);
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return !m_stopping;
+}
+
+void MySqlBinlogClient::run()
+{
+    while (poll()) {
+    }
+}
+
+void MySqlBinlogClient::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = True;
+    }
+
+    // a waiting read returns at the next heartbeat else
+    if (m_heartbeatPeriod == 0) {
+        try {
+            m_db->cancel();
+        } catch (E_BaseException &) {
+            O3D_WARNING("Unable to cancel the binary log read");
+        }
+    }
+}
+
+MySqlBinlogClient::Position MySqlBinlogClient::getPosition() const
+{
+    Position position;
+    position.file = CString(m_file.c_str(), (UInt32)m_file.length());
+    position.offset = m_offset;
+
+    return position;
+}
+
+void MySqlBinlogClient::processEvent(const UInt8 *data, size_t size)
+{
+    if (size < EVENT_HEADER_SIZE) {
+        O3D_ERROR(E_InvalidFormat("Truncated binary log event"));
+    }
+
+    UInt8 type = data[4];
+    UInt32 nextPosition = (UInt32)readLE(data + 13, 4);
+
+    if (type == FORMAT_DESCRIPTION_EVENT) {
+        readFormatDescription(data, size);
+    }
+
+    if (size < EVENT_HEADER_SIZE + m_checksumSize) {
+        O3D_ERROR(E_InvalidFormat("Truncated binary log event"));
+    }
+
+    // without the checksum
+    size_t bodySize = size - EVENT_HEADER_SIZE - m_checksumSize;
+    const UInt8 *body = data + EVENT_HEADER_SIZE;
+
+    switch (type) {
+    case ROTATE_EVENT:
+        readRotate(body, bodySize);
+        return;
+    case TABLE_MAP_EVENT:
+        readTableMap(body, bodySize);
+        break;
+    case WRITE_ROWS_EVENT_V1:
+    case UPDATE_ROWS_EVENT_V1:
+    case DELETE_ROWS_EVENT_V1:
+    case WRITE_ROWS_EVENT:
+    case UPDATE_ROWS_EVENT:
+    case DELETE_ROWS_EVENT:
+        readRows(type, body, bodySize);
+        break;
+    case PARTIAL_UPDATE_ROWS_EVENT:
+        // a missed change would let a stale cache
+        O3D_ERROR(E_InvalidFormat("Partial JSON updates are not supported, set binlog_row_value_options to empty"));
+        break;
+    default:
+        // heartbeat, transaction, query...
+        break;
+    }
+
+    // artificial events have no position
+    if (nextPosition > 0) {
+        m_offset = nextPosition;
+    }
+}
+
+void MySqlBinlogClient::readFormatDescription(const UInt8 *data, size_t size)
+{
+    // the checksum algorithm precedes the checksum, when the server supports them
+    if (size >= EVENT_HEADER_SIZE + 57 + 5) {
+        UInt8 algorithm = data[size - 5];
+        m_checksumSize = (algorithm != 0 && algorithm != 255) ? 4 : 0;
+    } else {
+        m_checksumSize = 0;
+    }
+}
+
+void MySqlBinlogClient::readRotate(const UInt8 *data, size_t size)
+{
+    if (size < 8) {
+        O3D_ERROR(E_InvalidFormat("Truncated rotate event"));
+    }
+
+    m_offset = readLE(data, 8);
+    m_file.assign((const Char*)data + 8, size - 8);
+
+    // the table ids are only valid in a file
+    m_tables.clear();
+}
+
+void MySqlBinlogClient::readTableMap(const UInt8 *data, size_t size)
+{
+    const UInt8 *pos = data;
+    const UInt8 *end = data + size;
+
+    checkSize(pos, end, 8);
+    UInt64 tableId = readLE(pos, 6);
+    pos += 8;
+
+    TableMap table;
+
+    checkSize(pos, end, 1);
+    size_t length = *pos++;
+    checkSize(pos, end, length + 1);
+    table.database = CString((const Char*)pos, (UInt32)length);
+    pos += length + 1;
+
+    checkSize(pos, end, 1);
+    length = *pos++;
+    checkSize(pos, end, length + 1);
+    table.table = CString((const Char*)pos, (UInt32)length);
+    pos += length + 1;
+
+    size_t numColumns = (size_t)readPacked(pos, end);
+
+    checkSize(pos, end, numColumns);
+    table.types.assign(pos, pos + numColumns);
+    pos += numColumns;
+
+    size_t metadataSize = (size_t)readPacked(pos, end);
+    checkSize(pos, end, metadataSize);
+
+    const UInt8 *metadata = pos;
+    const UInt8 *metadataEnd = pos + metadataSize;
+
+    table.metadata.resize(numColumns, 0);
+
+    for (size_t i = 0; i < numColumns; ++i) {
+        switch (table.types[i]) {
+        case MYSQL_TYPE_TINY_BLOB:
+        case MYSQL_TYPE_BLOB:
+        case MYSQL_TYPE_MEDIUM_BLOB:
+        case MYSQL_TYPE_LONG_BLOB:
+        case MYSQL_TYPE_DOUBLE:
+        case MYSQL_TYPE_FLOAT:
+        case MYSQL_TYPE_GEOMETRY:
+        case MYSQL_TYPE_JSON:
+        case MYSQL_TYPE_TIMESTAMP2:
+        case MYSQL_TYPE_DATETIME2:
+        case MYSQL_TYPE_TIME2:
+            checkSize(metadata, metadataEnd, 1);
+            table.metadata[i] = *metadata++;
+            break;
+        case MYSQL_TYPE_SET:
+        case MYSQL_TYPE_ENUM:
+        case MYSQL_TYPE_STRING:
+        case MYSQL_TYPE_NEWDECIMAL:
+            // real type or precision first
+            checkSize(metadata, metadataEnd, 2);
+            table.metadata[i] = (UInt16)((metadata[0] << 8) | metadata[1]);
+            metadata += 2;
+            break;
+        case MYSQL_TYPE_BIT:
+        case MYSQL_TYPE_VARCHAR:
+        case MYSQL_TYPE_VAR_STRING:
+            checkSize(metadata, metadataEnd, 2);
+            table.metadata[i] = (UInt16)readLE(metadata, 2);
+            metadata += 2;
+            break;
+        default:
+            break;
+        }
+    }
+
+    pos = metadataEnd;
+
+    // null bitmap
+    size_t nullBitmapSize = (numColumns + 7) / 8;
+    checkSize(pos, end, nullBitmapSize);
+    pos += nullBitmapSize;
+
+    table.unsignedColumns.resize(numColumns, False);
+
+    // optional metadata, as type, length, value
+    while (pos < end) {
+        UInt8 fieldType = *pos++;
+        size_t fieldSize = (size_t)readPacked(pos, end);
+        checkSize(pos, end, fieldSize);
+
+        if (fieldType == TABLE_MAP_SIGNEDNESS) {
+            // a bit per numeric column, most significant first
+            size_t n = 0;
+            for (size_t i = 0; i < numColumns; ++i) {
+                if (!isNumeric(table.types[i])) {
+                    continue;
+                }
+
+                if (n / 8 < fieldSize) {
+                    table.unsignedColumns[i] = (pos[n / 8] & (0x80 >> (n % 8))) != 0;
+                }
+
+                ++n;
+            }
+        }
+
+        pos += fieldSize;
+    }
+
+    m_tables[tableId] = std::move(table);
+}
+
+void MySqlBinlogClient::readRows(UInt8 type, const UInt8 *data, size_t size)
+{
+    const UInt8 *pos = data;
+    const UInt8 *end = data + size;
+
+    checkSize(pos, end, 8);
+    UInt64 tableId = readLE(pos, 6);
+    pos += 8;
+
+    Bool v2 = type >= WRITE_ROWS_EVENT;
+    if (v2) {
+        // the length of the extra data includes itself
+        checkSize(pos, end, 2);
+        size_t extraSize = (size_t)readLE(pos, 2);
+        if (extraSize < 2) {
+            O3D_ERROR(E_InvalidFormat("Invalid rows event"));
+        }
+
+        checkSize(pos, end, extraSize);
+        pos += extraSize;
+    }
+
+    // a transaction started before the position the stream was opened at
+    auto it = m_tables.find(tableId);
+    if (it == m_tables.end()) {
+        return;
+    }
+
+    const TableMap &table = it->second;
+
+    // the subscribers of the table, called without lock, so they can unsubscribe
+    std::vector<Subscription> subscriptions;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        for (auto &pair : m_subscriptions) {
+            if (pair.second.database == table.database && pair.second.table == table.table) {
+                subscriptions.push_back(pair.second);
+            }
+        }
+    }
+
+    if (subscriptions.empty()) {
+        return;
+    }
+
+    Operation operation = OP_INSERT;
+    if (type == UPDATE_ROWS_EVENT || type == UPDATE_ROWS_EVENT_V1) {
+        operation = OP_UPDATE;
+    } else if (type == DELETE_ROWS_EVENT || type == DELETE_ROWS_EVENT_V1) {
+        operation = OP_DELETE;
+    }
+
+    size_t numColumns = (size_t)readPacked(pos, end);
+    if (numColumns > table.types.size()) {
+        O3D_ERROR(E_InvalidFormat("Rows event with more columns than its table map"));
+    }
+
+    size_t bitmapSize = (numColumns + 7) / 8;
+
+    std::vector<Bool> present(numColumns);
+    std::vector<Bool> presentAfter;
+
+    checkSize(pos, end, bitmapSize);
+    for (size_t i = 0; i < numColumns; ++i) {
+        present[i] = (pos[i / 8] & (1 << (i % 8))) != 0;
+    }
+    pos += bitmapSize;
+
+    if (operation == OP_UPDATE) {
+        presentAfter.resize(numColumns);
+
+        checkSize(pos, end, bitmapSize);
+        for (size_t i = 0; i < numColumns; ++i) {
+            presentAfter[i] = (pos[i / 8] & (1 << (i % 8))) != 0;
+        }
+        pos += bitmapSize;
+    }
+
+    std::vector<const UInt8*> values;
+    std::vector<const UInt8*> valuesAfter;
+
+    Change change;
+    change.operation = operation;
+    change.database = table.database;
+    change.table = table.table;
+
+    while (pos < end) {
+        pos = readImage(table, present, pos, end, values);
+
+        if (operation == OP_UPDATE) {
+            pos = readImage(table, presentAfter, pos, end, valuesAfter);
+
+            // a minimal after image only has the changed columns
+            for (size_t i = 0; i < numColumns; ++i) {
+                if (!presentAfter[i]) {
+                    valuesAfter[i] = values[i];
+                }
+            }
+        }
+
+        for (const Subscription &subscription : subscriptions) {
+            change.key.clear();
+            readKey(table, values, end, subscription.keyColumns, change.key);
+
+            if (operation == OP_UPDATE) {
+                change.newKey.clear();
+                readKey(table, valuesAfter, end, subscription.keyColumns, change.newKey);
+            } else {
+                change.newKey = change.key;
+            }
+
+            subscription.callback(change);
+        }
+    }
+}
+
+const UInt8 *MySqlBinlogClient::readImage(
+        const TableMap &table,
+        const std::vector<Bool> &present,
+        const UInt8 *pos,
+        const UInt8 *end,
+        std::vector<const UInt8*> &values) const
+{
+    size_t numColumns = present.size();
+    values.assign(numColumns, nullptr);
+
+    size_t numPresent = 0;
+    for (Bool p : present) {
+        numPresent += p ? 1 : 0;
+    }
+
+    // the null bitmap counts only the present columns
+    size_t nullBitmapSize = (numPresent + 7) / 8;
+    checkSize(pos, end, nullBitmapSize);
+
+    const UInt8 *nulls = pos;
+    pos += nullBitmapSize;
+
+    size_t n = 0;
+    for (size_t i = 0; i < numColumns; ++i) {
+        if (!present[i]) {
+            continue;
+        }
+
+        Bool isNull = (nulls[n / 8] & (1 << (n % 8))) != 0;
+        ++n;
+
+        if (isNull) {
+            continue;
+        }
+
+        values[i] = pos;
+        pos += valueSize(table.types[i], table.metadata[i], pos, end);
+    }
+
+    return pos;
+}
+
+void MySqlBinlogClient::readKey(
+        const TableMap &table,
+        const std::vector<const UInt8*> &values,
+        const UInt8 *end,
+        const std::vector<UInt32> &keyColumns,
+        MySqlParams &key) const
+{
+    for (UInt32 k = 0; k < keyColumns.size(); ++k) {
+        UInt32 column = keyColumns[k];
+
+        if (column >= values.size() || !values[column]) {
+            O3D_ERROR(E_InvalidFormat(String(m_minimalImage ?
+                "Key column absent from the minimal row image, only the primary key is logged " :
+                "Key column absent from the row image ") << column));
+        }
+
+        const UInt8 *pos = values[column];
+        UInt8 type = table.types[column];
+        UInt16 metadata = table.metadata[column];
+        Bool isUnsigned = table.unsignedColumns[column];
+
+        size_t intSize = 0;
+
+        switch (type) {
+        case MYSQL_TYPE_TINY:
+            intSize = 1;
+            break;
+        case MYSQL_TYPE_SHORT:
+            intSize = 2;
+            break;
+        case MYSQL_TYPE_INT24:
+            intSize = 3;
+            break;
+        case MYSQL_TYPE_LONG:
+            intSize = 4;
+            break;
+        case MYSQL_TYPE_LONGLONG:
+            intSize = 8;
+            break;
+        case MYSQL_TYPE_YEAR:
+            key.setUInt32(k, *pos ? 1900 + *pos : 0);
+            continue;
+        case MYSQL_TYPE_VARCHAR:
+        case MYSQL_TYPE_VAR_STRING:
+        {
+            size_t prefix = metadata > 255 ? 2 : 1;
+            size_t length = (size_t)readLE(pos, prefix);
+            key.setCString(k, CString((const Char*)pos + prefix, (UInt32)length));
+            continue;
+        }
+        case MYSQL_TYPE_STRING:
+        {
+            UInt8 realType = (UInt8)(metadata >> 8);
+            if (realType == MYSQL_TYPE_ENUM || realType == MYSQL_TYPE_SET) {
+                key.setUInt64(k, readLE(pos, metadata & 0xff));
+                continue;
+            }
+
+            size_t maxLength = (((metadata >> 4) & 0x300) ^ 0x300) + (metadata & 0xff);
+            size_t prefix = maxLength > 255 ? 2 : 1;
+            size_t length = (size_t)readLE(pos, prefix);
+            key.setCString(k, CString((const Char*)pos + prefix, (UInt32)length));
+            continue;
+        }
+        case MYSQL_TYPE_TINY_BLOB:
+        case MYSQL_TYPE_BLOB:
+        case MYSQL_TYPE_MEDIUM_BLOB:
+        case MYSQL_TYPE_LONG_BLOB:
+        {
+            size_t length = (size_t)readLE(pos, metadata);
+            key.setBytes(k, pos + metadata, (UInt32)length);
+            continue;
+        }
+        default:
+            // compared as raw bytes
+            key.setBytes(k, pos, (UInt32)valueSize(type, metadata, pos, end));
+            continue;
+        }
+
+        UInt64 v = readLE(pos, intSize);
+
+        if (isUnsigned) {
+            if (intSize == 8) {
+                key.setUInt64(k, v);
+            } else {
+                key.setUInt32(k, (UInt32)v);
+            }
+        } else {
+            // sign extension
+            Int64 s = intSize == 8 ? (Int64)v : (Int64)(v << (64 - 8 * intSize)) >> (64 - 8 * intSize);
+
+            if (intSize == 8) {
+                key.setInt64(k, s);
+            } else {
+                key.setInt32(k, (Int32)s);
+            }
+        }
+    }
+}
+
+size_t MySqlBinlogClient::valueSize(UInt8 type, UInt16 metadata, const UInt8 *pos, const UInt8 *end)
+{
+    size_t size = 0;
+
+    switch (type) {
+    case MYSQL_TYPE_NULL:
+        size = 0;
+        break;
+    case MYSQL_TYPE_TINY:
+    case MYSQL_TYPE_YEAR:
+        size = 1;
+        break;
+    case MYSQL_TYPE_SHORT:
+        size = 2;
+        break;
+    case MYSQL_TYPE_INT24:
+    case MYSQL_TYPE_DATE:
+    case MYSQL_TYPE_NEWDATE:
+    case MYSQL_TYPE_TIME:
+        size = 3;
+        break;
+    case MYSQL_TYPE_LONG:
+    case MYSQL_TYPE_FLOAT:
+    case MYSQL_TYPE_TIMESTAMP:
+        size = 4;
+        break;
+    case MYSQL_TYPE_LONGLONG:
+    case MYSQL_TYPE_DOUBLE:
+    case MYSQL_TYPE_DATETIME:
+        size = 8;
+        break;
+    case MYSQL_TYPE_TIMESTAMP2:
+        size = 4 + (metadata + 1) / 2;
+        break;
+    case MYSQL_TYPE_DATETIME2:
+        size = 5 + (metadata + 1) / 2;
+        break;
+    case MYSQL_TYPE_TIME2:
+        size = 3 + (metadata + 1) / 2;
+        break;
+    case MYSQL_TYPE_NEWDECIMAL:
+        size = decimalSize(metadata >> 8, metadata & 0xff);
+        break;
+    case MYSQL_TYPE_BIT:
+        // bytes, plus one for the remaining bits
+        size = ((metadata >> 8) & 0xff) + ((metadata & 0xff) > 0 ? 1 : 0);
+        break;
+    case MYSQL_TYPE_VARCHAR:
+    case MYSQL_TYPE_VAR_STRING:
+    {
+        size_t prefix = metadata > 255 ? 2 : 1;
+        checkSize(pos, end, prefix);
+        size = prefix + (size_t)readLE(pos, prefix);
+        break;
+    }
+    case MYSQL_TYPE_ENUM:
+    case MYSQL_TYPE_SET:
+        size = metadata & 0xff;
+        break;
+    case MYSQL_TYPE_STRING:
+    {
+        UInt8 realType = (UInt8)(metadata >> 8);
+        if (realType == MYSQL_TYPE_ENUM || realType == MYSQL_TYPE_SET) {
+            size = metadata & 0xff;
+            break;
+        }
+
+        // the high bits of the max length are stored into the real type
+        size_t maxLength = (((metadata >> 4) & 0x300) ^ 0x300) + (metadata & 0xff);
+        size_t prefix = maxLength > 255 ? 2 : 1;
+        checkSize(pos, end, prefix);
+        size = prefix + (size_t)readLE(pos, prefix);
+        break;
+    }
+    case MYSQL_TYPE_TINY_BLOB:
+    case MYSQL_TYPE_BLOB:
+    case MYSQL_TYPE_MEDIUM_BLOB:
+    case MYSQL_TYPE_LONG_BLOB:
+    case MYSQL_TYPE_GEOMETRY:
+    case MYSQL_TYPE_JSON:
+        // metadata is the size of the length
+        checkSize(pos, end, metadata);
+        size = metadata + (size_t)readLE(pos, metadata);
+        break;
+    default:
+        O3D_ERROR(E_InvalidFormat(String("Unsupported column type in the binary log ") << (Int32)type));
+        break;
+    }
+
+    checkSize(pos, end, size);
+    return size;
+}
@@ -0,0 +1,333 @@
+/**
+ * @file mysqlbulkloader.cpp
+ * @brief LOAD DATA LOCAL INFILE fed by rows produced in memory.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#include "o3d/mysql/mysqlbulkloader.h"
+#include "o3d/mysql/mysqlexception.h"
+
+#include <o3d/core/debug.h>
+
+#include <mysql/errmsg.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+using namespace o3d;
+using namespace o3d::mysql;
+
+//
+// MySqlBulkRow
+//
+
+MySqlBulkRow::MySqlBulkRow(std::string &buffer, Char fieldTerminator, Char lineTerminator) :
+    m_buffer(buffer),
+    m_fieldTerminator(fieldTerminator),
+    m_lineTerminator(lineTerminator),
+    m_numFields(0)
+{
+
+}
+
+void MySqlBulkRow::separator()
+{
+    if (m_numFields > 0) {
+        m_buffer += m_fieldTerminator;
+    }
+
+    ++m_numFields;
+}
+
+void MySqlBulkRow::addText(const Char *text, size_t length)
+{
+    separator();
+    m_buffer.append(text, length);
+}
+
+void MySqlBulkRow::addEscaped(const UInt8 *data, size_t length)
+{
+    separator();
+
+    for (size_t i = 0; i < length; ++i) {
+        Char c = (Char)data[i];
+
+        if (c == 0) {
+            m_buffer += "\\0";
+        } else if (c == '\n') {
+            m_buffer += "\\n";
+        } else if (c == '\r') {
+            m_buffer += "\\r";
+        } else if (c == '\t') {
+            m_buffer += "\\t";
+        } else if (c == '\\' || c == m_fieldTerminator || c == m_lineTerminator) {
+            m_buffer += '\\';
+            m_buffer += c;
+        } else {
+            m_buffer += c;
+        }
+    }
+}
+
+void MySqlBulkRow::addNull()
+{
+    addText("\\N", 2);
+}
+
+void MySqlBulkRow::addBool(Bool v)
+{
+    addText(v ? "1" : "0", 1);
+}
+
+void MySqlBulkRow::addInt32(Int32 v)
+{
+    Char text[16];
+    int len = snprintf(text, sizeof(text), "%d", v);
+    addText(text, len);
+}
+
+void MySqlBulkRow::addUInt32(UInt32 v)
+{
+    Char text[16];
+    int len = snprintf(text, sizeof(text), "%u", v);
+    addText(text, len);
+}
+
+void MySqlBulkRow::addInt64(Int64 v)
+{
+    Char text[24];
+    int len = snprintf(text, sizeof(text), "%lld", (long long)v);
+    addText(text, len);
+}
+
+void MySqlBulkRow::addUInt64(UInt64 v)
+{
+    Char text[24];
+    int len = snprintf(text, sizeof(text), "%llu", (unsigned long long)v);
+    addText(text, len);
+}
+
+void MySqlBulkRow::addFloat(Float v)
+{
+    Char text[32];
+    int len = snprintf(text, sizeof(text), "%.9g", v);
+    addText(text, len);
+}
+
+void MySqlBulkRow::addDouble(Double v)
+{
+    Char text[32];
+    int len = snprintf(text, sizeof(text), "%.17g", v);
+    addText(text, len);
+}
+
+void MySqlBulkRow::addCString(const CString &v)
+{
+    addEscaped((const UInt8*)v.getData(), v.length());
+}
+
+void MySqlBulkRow::addData(const UInt8 *data, UInt32 length)
+{
+    addEscaped(data, length);
+}
+
+void MySqlBulkRow::addDate(const Date &date)
+{
+    Char text[16];
+    int len = snprintf(text, sizeof(text), "%04u-%02u-%02u",
+                       (unsigned)date.year, (unsigned)date.month + 1, (unsigned)date.mday + 1);
+    addText(text, len);
+}
+
+void MySqlBulkRow::addTimestamp(const DateTime &date)
+{
+    Char text[32];
+    int len = snprintf(text, sizeof(text), "%04u-%02u-%02u %02u:%02u:%02u",
+                       (unsigned)date.year, (unsigned)date.month + 1, (unsigned)date.mday + 1,
+                       (unsigned)date.hour, (unsigned)date.minute, (unsigned)date.second);
+    addText(text, len);
+}
+
+//
+// MySqlBulkLoader
+//
+
+//! Character as a SQL string literal content.
+static std::string sqlChar(Char c)
+{
+    switch (c) {
+    case '\t': return "\\t";
+    case '\n': return "\\n";
+    case '\r': return "\\r";
+    case '\\': return "\\\\";
+    case '\'': return "\\'";
+    default: return std::string(1, c);
+    }
+}
+
+MySqlBulkLoader::MySqlBulkLoader(const CString &table, const std::vector<CString> &columns) :
+    m_table(table),
+    m_columns(columns),
+    m_fieldTerminator('\t'),
+    m_lineTerminator('\n'),
+    m_duplicates(DUPLICATES_ERROR),
+    m_charset("utf8mb4"),
+    m_chunkSize(65536)
+{
+
+}
+
+CString MySqlBulkLoader::getStatement() const
+{
+    // the file name is given to the handler, which ignores it
+    std::string sql = "LOAD DATA LOCAL INFILE 'o3d-bulk-load'";
+
+    if (m_duplicates == DUPLICATES_REPLACE) {
+        sql += " REPLACE";
+    } else if (m_duplicates == DUPLICATES_IGNORE) {
+        sql += " IGNORE";
+    }
+
+    sql += " INTO TABLE ";
+    sql += m_table.getData();
+
+    if (!m_charset.isEmpty()) {
+        sql += " CHARACTER SET ";
+        sql += m_charset.getData();
+    }
+
+    sql += " FIELDS TERMINATED BY '" + sqlChar(m_fieldTerminator) + "' ESCAPED BY '\\\\'";
+    sql += " LINES TERMINATED BY '" + sqlChar(m_lineTerminator) + "'";
+
+    if (!m_columns.empty()) {
+        sql += " (";
+
+        for (size_t i = 0; i < m_columns.size(); ++i) {
+            if (i > 0) {
+                sql += ", ";
+            }
+
+            sql += m_columns[i].getData();
+        }
+
+        sql += ")";
+    }
+
+    return CString(sql.c_str(), (UInt32)sql.length());
+}
+
+MySqlBulkLoader::Stats MySqlBulkLoader::run(MYSQL *pDb, const Producer &producer) const
+{
+    O3D_ASSERT(pDb != nullptr);
+
+    Context context;
+    context.loader = this;
+    context.producer = &producer;
+    context.pos = 0;
+    context.eof = False;
+    context.rows = 0;
+    context.bytes = 0;
+
+    CString sql = getStatement();
+
+    auto start = std::chrono::steady_clock::now();
+
+    mysql_set_local_infile_handler(pDb, infileInit, infileRead, infileEnd, infileError, &context);
+    int result = mysql_real_query(pDb, sql.getData(), sql.length());
+    mysql_set_local_infile_default(pDb);
+
+    std::chrono::duration<Double> duration = std::chrono::steady_clock::now() - start;
+
+    // an exception of the producer has priority
+    if (context.error) {
+        std::rethrow_exception(context.error);
+    }
+
+    if (result != 0) {
+        O3D_ERROR(E_MySqlError(mysql_error(pDb)));
+    }
+
+    Stats stats;
+    stats.producedRows = context.rows;
+    stats.loadedRows = mysql_affected_rows(pDb);
+    stats.warnings = mysql_warning_count(pDb);
+    stats.bytes = context.bytes;
+    stats.seconds = duration.count();
+    stats.rowsPerSecond = stats.seconds > 0 ? stats.loadedRows / stats.seconds : 0;
+
+    const char *info = mysql_info(pDb);
+    stats.info = info ? info : "";
+
+    return stats;
+}
+
+int MySqlBulkLoader::infileInit(void **ptr, const char *, void *userdata)
+{
+    *ptr = userdata;
+    return 0;
+}
+
+int MySqlBulkLoader::infileRead(void *ptr, char *buf, unsigned int length)
+{
+    Context &context = *static_cast<Context*>(ptr);
+
+    // no exception through the client library
+    try {
+        if (context.pos >= context.buffer.size()) {
+            context.buffer.clear();
+            context.pos = 0;
+
+            const MySqlBulkLoader &loader = *context.loader;
+            size_t chunkSize = std::max<size_t>(loader.m_chunkSize, length);
+
+            while (!context.eof && context.buffer.size() < chunkSize) {
+                size_t rowStart = context.buffer.size();
+                MySqlBulkRow row(context.buffer, loader.m_fieldTerminator, loader.m_lineTerminator);
+
+                if (!(*context.producer)(row)) {
+                    context.buffer.resize(rowStart);
+                    context.eof = True;
+                } else {
+                    context.buffer += loader.m_lineTerminator;
+                    ++context.rows;
+                }
+            }
+        }
+
+        size_t size = std::min<size_t>(length, context.buffer.size() - context.pos);
+        memcpy(buf, context.buffer.data() + context.pos, size);
+
+        context.pos += size;
+        context.bytes += size;
+
+        return (int)size;
+    } catch (...) {
+        context.error = std::current_exception();
+        context.errorMessage = "Bulk load producer failure";
+
+        return -1;
+    }
+}
+
+void MySqlBulkLoader::infileEnd(void *)
+{
+
+}
+
+int MySqlBulkLoader::infileError(void *ptr, char *msg, unsigned int length)
+{
+    Context &context = *static_cast<Context*>(ptr);
+
+    if (length > 0) {
+        size_t size = std::min<size_t>(length - 1, context.errorMessage.size());
+        memcpy(msg, context.errorMessage.data(), size);
+        msg[size] = 0;
+    }
+
+    return CR_UNKNOWN_ERROR;
+}
@@ -0,0 +1,121 @@
+/**
+ * @file mysqlconnectoptions.cpp
+ * @brief Connection options profile of a MySqlDb.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#include "o3d/mysql/mysqlconnectoptions.h"
+
+#include <o3d/core/debug.h>
+
+using namespace o3d;
+using namespace o3d::mysql;
+
+MySqlConnectOptions::MySqlConnectOptions() :
+    m_transport(TRANSPORT_DEFAULT),
+    m_compression(COMPRESSION_NONE),
+    m_compressionLevel(0),
+    m_connectTimeout(0),
+    m_readTimeout(0),
+    m_writeTimeout(0),
+    m_clientFlags(CLIENT_MULTI_RESULTS | CLIENT_PS_MULTI_RESULTS),
+    m_maxAllowedPacket(0),
+    m_netBufferLength(0),
+    m_localInfile(False)
+{
+
+}
+
+void MySqlConnectOptions::setUnixSocket(const CString &path)
+{
+    m_unixSocket = path;
+
+    if (!path.isEmpty()) {
+        m_transport = TRANSPORT_SOCKET;
+    }
+}
+
+void MySqlConnectOptions::setCompression(Compression compression, UInt32 level)
+{
+    m_compression = compression;
+    m_compressionLevel = level;
+}
+
+void MySqlConnectOptions::setMultiStatements(Bool enable)
+{
+    if (enable) {
+        m_clientFlags |= CLIENT_MULTI_STATEMENTS;
+    } else {
+        m_clientFlags &= ~CLIENT_MULTI_STATEMENTS;
+    }
+}
+
+void MySqlConnectOptions::apply(MYSQL *mysql) const
+{
+    O3D_ASSERT(mysql != nullptr);
+
+    if (m_transport != TRANSPORT_DEFAULT) {
+        unsigned int protocol = m_transport == TRANSPORT_TCP ? MYSQL_PROTOCOL_TCP : MYSQL_PROTOCOL_SOCKET;
+#ifdef O3D_WINDOWS
+        if (m_transport == TRANSPORT_SOCKET) {
+            protocol = MYSQL_PROTOCOL_PIPE;
+        }
+#endif
+        mysql_options(mysql, MYSQL_OPT_PROTOCOL, &protocol);
+    }
+
+    if (m_compression != COMPRESSION_NONE) {
+#if MYSQL_VERSION_ID >= 80018 && !defined(MARIADB_BASE_VERSION)
+        mysql_options(mysql, MYSQL_OPT_COMPRESSION_ALGORITHMS,
+                      m_compression == COMPRESSION_ZSTD ? "zstd,zlib" : "zlib");
+
+        if (m_compression == COMPRESSION_ZSTD && m_compressionLevel) {
+            unsigned int level = m_compressionLevel;
+            mysql_options(mysql, MYSQL_OPT_ZSTD_COMPRESSION_LEVEL, &level);
+        }
+#else
+        if (m_compression == COMPRESSION_ZSTD) {
+            O3D_WARNING("zstd compression is not supported by the MySql client library, zlib is used");
+        }
+
+        mysql_options(mysql, MYSQL_OPT_COMPRESS, nullptr);
+#endif
+    }
+
+    if (m_connectTimeout) {
+        unsigned int timeout = m_connectTimeout;
+        mysql_options(mysql, MYSQL_OPT_CONNECT_TIMEOUT, &timeout);
+    }
+
+    if (m_readTimeout) {
+        unsigned int timeout = m_readTimeout;
+        mysql_options(mysql, MYSQL_OPT_READ_TIMEOUT, &timeout);
+    }
+
+    if (m_writeTimeout) {
+        unsigned int timeout = m_writeTimeout;
+        mysql_options(mysql, MYSQL_OPT_WRITE_TIMEOUT, &timeout);
+    }
+
+    if (m_maxAllowedPacket) {
+        unsigned long size = m_maxAllowedPacket;
+        mysql_options(mysql, MYSQL_OPT_MAX_ALLOWED_PACKET, &size);
+    }
+
+    if (m_netBufferLength) {
+        unsigned long size = m_netBufferLength;
+        mysql_options(mysql, MYSQL_OPT_NET_BUFFER_LENGTH, &size);
+    }
+
+    if (!m_charset.isEmpty()) {
+        mysql_options(mysql, MYSQL_SET_CHARSET_NAME, m_charset.getData());
+    }
+
+    if (m_localInfile) {
+        unsigned int enable = 1;
+        mysql_options(mysql, MYSQL_OPT_LOCAL_INFILE, &enable);
+    }
+}
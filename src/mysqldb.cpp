@@ -10,20 +10,37 @@
 #include "o3d/mysql/mysqldb.h"
 #include "o3d/mysql/mysqlexception.h"
 #include "o3d/mysql/mysqldbvariable.h"
+#include "o3d/mysql/mysqlwatchdog.h"
 
 #include <o3d/core/application.h>
 #include <o3d/core/objects.h>
 
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
 using namespace o3d;
 using namespace o3d::mysql;
 
 static UInt32 ms_mySqlLibRefCount = 0;
 static Bool ms_mySqlLibState = False;
 
+//! Is a variable a string or a blob, of variable length.
+static inline Bool isVarLength(const DbVariable &var)
+{
+    return var.getIntType() == DbVariable::IT_ARRAY_CHAR || var.getIntType() == DbVariable::IT_ARRAY_UINT8;
+}
+
 //! Default ctor
 MySqlDb::MySqlDb() :
     Database(),
-    m_pDB(nullptr)
+    m_pDB(nullptr),
+    m_sessionId(0),
+    m_port(0),
+    m_threadId(0),
+    m_passwordKept(False),
+    m_cancelDB(nullptr),
+    m_admission(nullptr)
 {
     if (!ms_mySqlLibState) {
         O3D_ERROR(E_InvalidPrecondition("MySql::init() must be called before"));
@@ -46,6 +63,38 @@ Bool MySqlDb::connect(
         const String &user,
         const String &password,
         Bool keepPassord)
+{
+    port = prepareConnect(host, port, database, user, password, keepPassord);
+
+    const CString &unixSocket = m_options.getUnixSocket();
+
+    if (!mysql_real_connect(
+                m_pDB,
+                m_host.toUtf8().getData(),
+                m_user.toUtf8().getData(),
+                password.toUtf8().getData(),
+                m_database.toUtf8().getData(),
+                static_cast<UInt16>(port),
+                unixSocket.isEmpty() ? NULL : unixSocket.getData(),
+                m_options.getClientFlags())) {
+        //unsigned int erro = mysql_errno(m_pDB);
+        O3D_ERROR(E_MySqlError(mysql_error(m_pDB)));
+    }
+
+    // O3D_MESSAGE("Successfully connected to the MySql database");
+
+    connected(port);
+
+    return True;
+}
+
+UInt32 MySqlDb::prepareConnect(
+        const String &host,
+        UInt32 port,
+        const String &database,
+        const String &user,
+        const String &password,
+        Bool keepPassord)
 {
     Int32 pos;
 
@@ -61,6 +110,8 @@ Bool MySqlDb::connect(
         m_password = password;
 	}
 
+    m_passwordKept = keepPassord;
+
     if ((pos = host.find(':')) != -1) {
         m_host.truncate(pos);
         port = host.sub(pos+1).toUInt32();
@@ -69,24 +120,33 @@ Bool MySqlDb::connect(
     m_pDB = mysql_init(m_pDB);
     O3D_ASSERT(m_pDB != nullptr);
 
-    if (!mysql_real_connect(
-                m_pDB,
-                m_host.toUtf8().getData(),
-                m_user.toUtf8().getData(),
-                m_password.toUtf8().getData(),
-                m_database.toUtf8().getData(),
-                static_cast<UInt16>(port),
-                NULL,
-                0)/*CLIENT_MULTI_STATEMENTS)*/) {
-        //unsigned int erro = mysql_errno(m_pDB);
-        O3D_ERROR(E_MySqlError(mysql_error(m_pDB)));
-    }
+    m_options.apply(m_pDB);
 
-    // O3D_MESSAGE("Successfully connected to the MySql database");
+    return port;
+}
+
+void MySqlDb::connected(UInt32 port)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_cancelMutex);
+        m_port = port;
+        m_threadId = mysql_thread_id(m_pDB);
+    }
 
     m_isConnected = True;
+}
 
-    return True;
+Bool MySqlDb::connect(
+        const String &host,
+        UInt32 port,
+        const String &database,
+        const String &user,
+        const String &password,
+        const MySqlConnectOptions &options,
+        Bool keepPassord)
+{
+    m_options = options;
+    return connect(host, port, database, user, password, keepPassord);
 }
 
 // Disconnect from the database server
@@ -100,6 +160,67 @@ void MySqlDb::disconnect()
         mysql_close(m_pDB);
         m_pDB = nullptr;
     }
+
+    std::lock_guard<std::mutex> lock(m_cancelMutex);
+
+    if (m_cancelDB) {
+        mysql_close(m_cancelDB);
+        m_cancelDB = nullptr;
+    }
+
+    m_threadId = 0;
+}
+
+void MySqlDb::cancel()
+{
+    std::lock_guard<std::mutex> lock(m_cancelMutex);
+
+    if (!m_threadId) {
+        return;
+    }
+
+    if (!m_cancelDB) {
+        if (!m_passwordKept) {
+            O3D_ERROR(E_InvalidPrecondition("Cancel needs the password to have been kept at connect"));
+        }
+
+        m_cancelDB = mysql_init(nullptr);
+        O3D_ASSERT(m_cancelDB != nullptr);
+
+        m_options.apply(m_cancelDB);
+
+        const CString &unixSocket = m_options.getUnixSocket();
+
+        if (!mysql_real_connect(
+                    m_cancelDB,
+                    m_host.toUtf8().getData(),
+                    m_user.toUtf8().getData(),
+                    m_password.toUtf8().getData(),
+                    nullptr,
+                    static_cast<UInt16>(m_port),
+                    unixSocket.isEmpty() ? NULL : unixSocket.getData(),
+                    0)) {
+            String err = mysql_error(m_cancelDB);
+
+            mysql_close(m_cancelDB);
+            m_cancelDB = nullptr;
+
+            O3D_ERROR(E_MySqlError(err));
+        }
+    }
+
+    Char sql[48];
+    snprintf(sql, sizeof(sql), "KILL QUERY %lu", m_threadId);
+
+    if (mysql_query(m_cancelDB, sql) != 0) {
+        String err = mysql_error(m_cancelDB);
+
+        // opened again by the next cancel
+        mysql_close(m_cancelDB);
+        m_cancelDB = nullptr;
+
+        O3D_ERROR(E_MySqlError(err));
+    }
 }
 
 // Try to maintain the connection established
@@ -110,15 +231,115 @@ void MySqlDb::pingConnection()
     }
 }
 
+Bool MySqlDb::ping()
+{
+    return m_pDB && mysql_ping(m_pDB) == 0;
+}
+
+void MySqlDb::resetSession()
+{
+    if (!m_pDB) {
+        O3D_ERROR(E_InvalidOperation("Not connected"));
+    }
+
+    // the statements are closed even if the reset fails
+    ++m_sessionId;
+
+    if (mysql_reset_connection(m_pDB) != 0) {
+        O3D_ERROR(E_MySqlError(mysql_error(m_pDB)));
+    }
+
+    // SET NAMES is reset to the server default
+    const CString &charset = m_options.getCharset();
+    if (!charset.isEmpty() && mysql_set_character_set(m_pDB, charset.getData()) != 0) {
+        O3D_ERROR(E_MySqlError(mysql_error(m_pDB)));
+    }
+}
+
+Int32 MySqlDb::getReplicationLag()
+{
+    if (!m_pDB) {
+        O3D_ERROR(E_InvalidOperation("Not connected"));
+    }
+
+    // SHOW SLAVE STATUS is removed since 8.4 but SHOW REPLICA STATUS only exists since 8.0.22
+    if (mysql_query(m_pDB, "SHOW REPLICA STATUS") != 0) {
+        if (mysql_query(m_pDB, "SHOW SLAVE STATUS") != 0) {
+            O3D_ERROR(E_MySqlError(mysql_error(m_pDB)));
+        }
+    }
+
+    MYSQL_RES *result = mysql_store_result(m_pDB);
+    if (!result) {
+        O3D_ERROR(E_MySqlError(mysql_error(m_pDB)));
+    }
+
+    Int32 lag = 0;
+
+    MYSQL_ROW row = mysql_fetch_row(result);
+    if (row) {
+        UInt32 numFields = mysql_num_fields(result);
+        MYSQL_FIELD *fields = mysql_fetch_fields(result);
+
+        lag = -1;
+
+        for (UInt32 i = 0; i < numFields; ++i) {
+            if (strcmp(fields[i].name, "Seconds_Behind_Source") == 0 ||
+                strcmp(fields[i].name, "Seconds_Behind_Master") == 0) {
+                // null when the SQL thread is not running
+                if (row[i]) {
+                    lag = atoi(row[i]);
+                }
+                break;
+            }
+        }
+    }
+
+    mysql_free_result(result);
+    return lag;
+}
+
+MySqlResult *MySqlDb::executeDirect(const CString &sql, Bool buffered)
+{
+    if (!m_pDB) {
+        O3D_ERROR(E_InvalidOperation("Not connected"));
+    }
+
+    if (mysql_real_query(m_pDB, sql.getData(), (unsigned long)sql.length()) != 0) {
+        O3D_ERROR(E_MySqlError(mysql_error(m_pDB)));
+    }
+
+    return new MySqlResult(m_pDB, buffered);
+}
+
+// Load rows with a LOAD DATA LOCAL INFILE
+MySqlBulkLoader::Stats MySqlDb::bulkLoad(
+        const MySqlBulkLoader &loader,
+        const MySqlBulkLoader::Producer &producer)
+{
+    if (!m_pDB) {
+        O3D_ERROR(E_InvalidPrecondition("Not connected"));
+    }
+
+    if (!m_options.isLocalInfile()) {
+        O3D_ERROR(E_InvalidPrecondition("Local infile must be enabled in the connect options"));
+    }
+
+    return loader.run(m_pDB, producer);
+}
+
 // Instanciate a new DbQuery object
 DbQuery* MySqlDb::newDbQuery(const String &name, const CString &query)
 {
-    return new MySqlQuery(m_pDB, name, query);
+    return new MySqlQuery(m_pDB, name, query, this);
 }
 
 // Virtual destructor
 MySqlQuery::~MySqlQuery()
 {
+    // the watchdog must not cancel after the query
+    endDeadline();
+
     for (Int32 i = 0; i < m_inputs.getSize(); ++i) {
         deletePtr(m_inputs[i]);
     }
@@ -128,6 +349,8 @@ MySqlQuery::~MySqlQuery()
     }
 
     if (m_stmt) {
+        drainResults();
+
         if (m_prepareMetaResult) {
             mysql_free_result(m_prepareMetaResult);
         }
@@ -138,6 +361,8 @@ MySqlQuery::~MySqlQuery()
 
 		mysql_stmt_close(m_stmt);
     }
+
+    deletePtr(m_arena);
 }
 
 void MySqlQuery::setArrayUInt8(UInt32 attr, const ArrayUInt8 &v)
@@ -491,6 +716,44 @@ void MySqlQuery::setCString(UInt32 attr, const CString &v)
     m_needBind = True;
 }
 
+void MySqlQuery::bindArrayUInt8Ref(UInt32 attr, const UInt8 *data, UInt32 size)
+{
+    bindRef(attr, MYSQL_TYPE_BLOB, data, size);
+}
+
+void MySqlQuery::bindCStringRef(UInt32 attr, const Char *data, UInt32 length)
+{
+    bindRef(attr, MYSQL_TYPE_VARCHAR, data, length);
+}
+
+void MySqlQuery::bindRef(UInt32 attr, enum_field_types type, const void *data, UInt32 size)
+{
+    if (attr >= m_numParam) {
+        O3D_ERROR(E_IndexOutOfRange("Input attribute id"));
+    }
+
+    if (m_inputs[attr]) {
+        deletePtr(m_inputs[attr]);
+    }
+
+    // only keeps the length, the data are read by the client library at execute
+    m_inputs[attr] = new MySqlDbVariable();
+    m_inputs[attr]->setLength(size);
+
+    memset(&m_param_bind[attr], 0, sizeof(MYSQL_BIND));
+
+    m_param_bind[attr].buffer_type = type;
+    m_param_bind[attr].buffer = const_cast<void*>(data);
+    m_param_bind[attr].buffer_length = size;
+
+    m_param_bind[attr].is_null = 0;
+
+    // the length of the data is the size of the buffer
+    m_param_bind[attr].length = &m_param_bind[attr].buffer_length;
+
+    m_needBind = True;
+}
+
 void MySqlQuery::setDate(UInt32 attr, const Date &v)
 {
     if (attr >= m_numParam) {
@@ -587,11 +850,37 @@ UInt32 MySqlQuery::getOutAttr(const CString &name)
     }
 }
 
+CString MySqlQuery::getOutName(UInt32 attr) const
+{
+    for (auto it = m_outputNames.begin(); it != m_outputNames.end(); ++it) {
+        if (it->second == attr) {
+            return it->first;
+        }
+    }
+
+    O3D_ERROR(E_IndexOutOfRange("Output attribute is out of range"));
+}
+
+UInt32 MySqlQuery::getOutDecimals(UInt32 attr) const
+{
+    if (attr >= (UInt32)m_outputs.getSize()) {
+        O3D_ERROR(E_IndexOutOfRange("Output attribute is out of range"));
+    }
+
+    for (const DecodedOutput &decoded : m_decodedOutputs) {
+        if (decoded.attr == attr) {
+            return decoded.decimals;
+        }
+    }
+
+    return 0;
+}
+
 const DbVariable &MySqlQuery::getOut(const CString &name) const
 {
     auto it = m_outputNames.find(name);
     if (it != m_outputNames.end()) {
-        return *m_outputs[it->second];
+        return getOut(it->second);
     } else {
         O3D_ERROR(E_InvalidParameter(o3d::String("Unknown output attribute name ") + name));
     }
@@ -600,12 +889,86 @@ const DbVariable &MySqlQuery::getOut(const CString &name) const
 const DbVariable &MySqlQuery::getOut(UInt32 attr) const
 {
     if (attr < (UInt32)m_outputs.getSize()) {
+        convertOutput(attr);
         return *m_outputs[attr];
     } else {
         O3D_ERROR(E_IndexOutOfRange("Output attribute is out of range"));
     }
 }
 
+const UInt8 *MySqlQuery::getOutData(UInt32 attr, UInt32 &length) const
+{
+    if (attr >= (UInt32)m_outputs.getSize()) {
+        O3D_ERROR(E_IndexOutOfRange("Output attribute is out of range"));
+    }
+
+    const DbVariable &var = *m_outputs[attr];
+    if (!isVarLength(var)) {
+        O3D_ERROR(E_InvalidParameter("Output attribute is not a string or a blob"));
+    }
+
+    if (var.isNull()) {
+        length = 0;
+        return nullptr;
+    }
+
+    if (m_arena) {
+        length = var.getLength();
+        return m_arenaData[attr];
+    }
+
+    // the fetch gives the full length, the data being truncated to the bound buffer
+    length = std::min(var.getLength(), var.getObjectSize());
+
+    if (var.getIntType() == DbVariable::IT_ARRAY_CHAR) {
+        return (const UInt8*)((const ArrayChar*)var.getObject())->getData();
+    } else {
+        return ((const ArrayUInt8*)var.getObject())->getData();
+    }
+}
+
+void MySqlQuery::setArenaMode(Bool enable, UInt32 blockSize)
+{
+    if (enable == (m_arena != nullptr)) {
+        return;
+    }
+
+    if (enable) {
+        m_arena = new MySqlArena(blockSize);
+    } else {
+        deletePtr(m_arena);
+    }
+
+    // strings and blobs are bound differently
+    if (m_stmt) {
+        drainResults();
+        bindResult();
+    }
+}
+
+void MySqlQuery::copyFromArena(UInt32 attr) const
+{
+    DbVariable &var = *m_outputs[attr];
+    if (!isVarLength(var) || var.isNull() || !m_arenaData[attr]) {
+        return;
+    }
+
+    UInt32 len = var.getLength();
+
+    if (var.getIntType() == DbVariable::IT_ARRAY_CHAR) {
+        ArrayChar *array = (ArrayChar*)var.getObject();
+
+        // with its terminal zero
+        array->setSize(len+1);
+        memcpy(array->getData(), m_arenaData[attr], len+1);
+    } else {
+        ArrayUInt8 *array = (ArrayUInt8*)var.getObject();
+
+        array->setSize(len);
+        memcpy(array->getData(), m_arenaData[attr], len);
+    }
+}
+
 // Prepare the query. Can do nothing if not preparation is needed
 void MySqlQuery::prepareQuery()
 {
@@ -637,8 +1000,6 @@ void MySqlQuery::prepareQuery()
 
 //        mysql_field_seek(m_prepareMetaParam, 0);
 
-          MYSQL_FIELD *field;
-          int id = 0;
 //        while ((field = mysql_fetch_field(m_prepareMetaParam)) != nullptr) {
 //            memset(&m_param_bind[id], 0, sizeof(MYSQL_BIND));
 
@@ -655,83 +1016,411 @@ void MySqlQuery::prepareQuery()
 //        }
 
         // outputs
-        m_prepareMetaResult = mysql_stmt_result_metadata(m_stmt);
-        if (m_prepareMetaResult) {
-            mysql_field_seek(m_prepareMetaResult, 0);
+        bindResult();
 
-            UInt32 maxSize;
-            DbVariable::IntType intType;
-            DbVariable::VarType varType;
-
-            id = 0;
-            while ((field = mysql_fetch_field(m_prepareMetaResult)) != nullptr) {
-                memset(&m_result_bind[id], 0, sizeof(MYSQL_BIND));
+        m_needBind = True;
+	}
+}
 
-                unmapType(field->type, maxSize, intType, varType);
+void MySqlQuery::reprepare()
+{
+    // the server side statement no longer exists
+    mysql_stmt_close(m_stmt);
+    m_stmt = nullptr;
 
-                m_outputNames.insert(std::make_pair(field->name, id));
+    m_pendingResults = False;
+    m_outParams = False;
+    m_resultIndex = 0;
 
-                m_outputs[id] = new MySqlDbVariable(intType, varType, maxSize);
-                DbVariable &var = *m_outputs[id];
+    m_stmt = mysql_stmt_init(m_pDB);
+    O3D_ASSERT(m_stmt != nullptr);
 
-                m_result_bind[id].buffer = (void*)var.getObjectPtr();
-                m_result_bind[id].buffer_type = field->type;
-                m_result_bind[id].buffer_length = var.getObjectSize();
+    if (mysql_stmt_prepare(m_stmt, m_query.getData(), (unsigned long)m_query.length()) != 0) {
+        String err = mysql_stmt_error(m_stmt);
 
-                m_result_bind[id].is_null = (bool*)var.getIsNullPtr();
-                m_result_bind[id].error = (bool*)var.getErrorPtr();
+        mysql_stmt_close(m_stmt);
+        m_stmt = nullptr;
 
-                var.setLength(var.getObjectSize());
-                m_result_bind[id].length = (unsigned long*)var.getLengthPtr();
+        O3D_ERROR(E_MySqlError(err));
+    }
 
-                ++id;
-            }
-        }
+    m_preparedSession = *m_sessionId;
 
-        m_needBind = True;
-	}
+    // same query, same parameters, bound again to the new statement
+    bindResult();
+    m_needBind = True;
 }
 
-// Unbind the current bound DbAttribute
-void MySqlQuery::unbind()
+// Bind the outputs to the current result set
+//! Type of the buffer receiving a field, as its output variable stores it.
+static enum_field_types resultBufferType(enum_field_types fieldType, DbVariable::IntType intType)
 {
-    if (m_stmt) {
-        for (Int32 i = 0; i < m_inputs.getSize(); ++i) {
-            deletePtr(m_inputs[i]);
-        }
+    switch (intType) {
+    case DbVariable::IT_ARRAY_CHAR:
+        // JSON, ENUM, SET and TIME converted to text by the client library
+        return MYSQL_TYPE_STRING;
 
-//		m_is_error.destroy();
-//		m_param_bind.destroy();
-//		m_length.destroy();
-//		m_param_length.destroy();
-//		m_param_bind.destroy();
-//		m_result_bind.destroy();
+    case DbVariable::IT_ARRAY_UINT8:
+        // any blob and GEOMETRY
+        return MYSQL_TYPE_BLOB;
+
+    default:
+        // integers, reals and dates as received, DECIMAL as digits and BIT as bytes
+        return fieldType;
     }
 }
 
-MySqlQuery::MySqlQuery(MYSQL *pDb, const String &name, const CString &query) :
-    m_name(name),
-    m_query(query),
-    m_numParam(0),
-    m_numRow(0),
-    m_currRow(0),
-    m_pDB(pDb),
-    m_stmt(nullptr),
-    //m_prepareMetaParam(nullptr),
-    m_prepareMetaResult(nullptr)
+void MySqlQuery::bindResult()
 {
-    prepareQuery();
-}
+    for (Int32 i = 0; i < m_outputs.getSize(); ++i) {
+        deletePtr(m_outputs[i]);
+    }
 
-// Execute the query on the current bound DbAttribute and store the result in the DbAttribute
-void MySqlQuery::execute()
-{
-    O3D_ASSERT(m_stmt != nullptr);
+    m_outputs.setSize(0);
+    m_outputNames.clear();
+    m_decodedOutputs.clear();
+
+    if (m_prepareMetaResult) {
+        mysql_free_result(m_prepareMetaResult);
+        m_prepareMetaResult = nullptr;
+    }
+
+    m_prepareMetaResult = mysql_stmt_result_metadata(m_stmt);
+    if (m_prepareMetaResult) {
+        mysql_field_seek(m_prepareMetaResult, 0);
+
+        // the decoded outputs are bound to their buffer, never reallocated
+        m_decodedOutputs.reserve(mysql_num_fields(m_prepareMetaResult));
+
+        UInt32 maxSize;
+        DbVariable::IntType intType;
+        DbVariable::VarType varType;
+
+        MYSQL_FIELD *field;
+        int id = 0;
+
+        while ((field = mysql_fetch_field(m_prepareMetaResult)) != nullptr) {
+            memset(&m_result_bind[id], 0, sizeof(MYSQL_BIND));
+
+            const Bool isUnsigned = (field->flags & UNSIGNED_FLAG) != 0;
+            unmapType(field->type, maxSize, intType, varType, isUnsigned);
+
+            m_outputNames.insert(std::make_pair(field->name, id));
+
+            m_outputs[id] = new MySqlDbVariable(intType, varType, maxSize);
+            DbVariable &var = *m_outputs[id];
+
+            m_result_bind[id].buffer_type = resultBufferType(field->type, intType);
+            m_result_bind[id].is_unsigned = isUnsigned;
+
+            if (field->type == MYSQL_TYPE_DECIMAL || field->type == MYSQL_TYPE_NEWDECIMAL ||
+                field->type == MYSQL_TYPE_BIT) {
+                // received as digits or as big endian bytes, decoded after the fetch
+                m_decodedOutputs.push_back(DecodedOutput());
+                DecodedOutput &decoded = m_decodedOutputs.back();
+
+                decoded.attr = id;
+                decoded.type = field->type;
+                decoded.decimals = field->type == MYSQL_TYPE_BIT ? 0 : field->decimals;
+                decoded.length = 0;
+
+                m_result_bind[id].buffer = decoded.buffer;
+                m_result_bind[id].buffer_length = sizeof(decoded.buffer);
+                m_result_bind[id].is_null = (bool*)var.getIsNullPtr();
+                m_result_bind[id].error = (bool*)var.getErrorPtr();
+                m_result_bind[id].length = &decoded.length;
+
+                var.setLength(var.getObjectSize());
+
+                ++id;
+                continue;
+            } else if (m_arena && isVarLength(var)) {
+                // only the length is returned by the fetch, the data are read into the arena
+                m_result_bind[id].buffer = nullptr;
+                m_result_bind[id].buffer_length = 0;
+            } else {
+                m_result_bind[id].buffer = (void*)var.getObjectPtr();
+                m_result_bind[id].buffer_length = var.getObjectSize();
+            }
+
+            m_result_bind[id].is_null = (bool*)var.getIsNullPtr();
+            m_result_bind[id].error = (bool*)var.getErrorPtr();
+
+            var.setLength(var.getObjectSize());
+            m_result_bind[id].length = (unsigned long*)var.getLengthPtr();
+
+            ++id;
+        }
+    }
+
+    m_arenaData.assign(m_outputs.getSize(), nullptr);
+
+    buildConversionPlan();
+}
+
+void MySqlQuery::buildConversionPlan()
+{
+    const UInt32 co = m_outputs.getSize();
+
+    m_conversions.clear();
+    m_conversionIndex.assign(co, -1);
+    m_convertedStamp.assign(co, 0);
+
+    for (UInt32 i = 0; i < co; ++i) {
+        const DbVariable &var = *m_outputs[i];
+
+        Conversion conversion;
+        conversion.attr = i;
+        conversion.convert = nullptr;
+        conversion.decoded = -1;
+        conversion.onAccess = False;
+
+        for (size_t d = 0; d < m_decodedOutputs.size(); ++d) {
+            if (m_decodedOutputs[d].attr == i) {
+                conversion.decoded = (Int32)d;
+                conversion.convert = m_decodedOutputs[d].type == MYSQL_TYPE_BIT ?
+                            &MySqlQuery::convertBit : &MySqlQuery::convertDecimal;
+                break;
+            }
+        }
+
+        if (conversion.decoded >= 0) {
+            // decoded
+        } else if (m_arena && isVarLength(var)) {
+            // strings and arrays are copied from the arena on access
+            conversion.convert = &MySqlQuery::convertFromArena;
+            conversion.onAccess = True;
+        } else if (var.getIntType() == DbVariable::IT_ARRAY_CHAR) {
+            conversion.convert = &MySqlQuery::convertString;
+        } else if (var.getIntType() == DbVariable::IT_ARRAY_UINT8) {
+            conversion.convert = &MySqlQuery::convertArray;
+        } else if (var.getIntType() == DbVariable::IT_DATE) {
+            conversion.convert = &MySqlQuery::convertDate;
+        } else if (var.getIntType() == DbVariable::IT_DATETIME) {
+            conversion.convert = &MySqlQuery::convertDateTime;
+        } else {
+            // fetched in place
+            continue;
+        }
+
+        m_conversionIndex[i] = (Int32)m_conversions.size();
+        m_conversions.push_back(conversion);
+    }
+}
+
+void MySqlQuery::runConversion(const Conversion &conversion) const
+{
+    m_convertedStamp[conversion.attr] = m_rowStamp;
+
+    if (!m_outputs[conversion.attr]->isNull()) {
+        (this->*conversion.convert)(conversion);
+    }
+}
+
+void MySqlQuery::convertString(const Conversion &conversion) const
+{
+    DbVariable &var = *m_outputs[conversion.attr];
+    ArrayChar *array = (ArrayChar*)var.getObject();
+
+    // add a terminal zero
+    array->setSize(var.getLength()+1);
+    (*array)[array->getSize()-1] = 0;
+}
+
+void MySqlQuery::convertArray(const Conversion &conversion) const
+{
+    DbVariable &var = *m_outputs[conversion.attr];
+    ArrayUInt8 *array = (ArrayUInt8*)var.getObject();
+
+    array->setSize(var.getLength());
+}
+
+void MySqlQuery::convertDate(const Conversion &conversion) const
+{
+    DbVariable &var = *m_outputs[conversion.attr];
+    Date *date = (Date*)var.getObject();
+    MYSQL_TIME *mysqlTime = (MYSQL_TIME*)var.getObjectPtr();
+
+    date->mday = mysqlTime->day;
+    date->month = mysqlTime->month;
+    date->year = mysqlTime->year;
+}
+
+void MySqlQuery::convertDateTime(const Conversion &conversion) const
+{
+    DbVariable &var = *m_outputs[conversion.attr];
+    DateTime *datetime = (DateTime*)var.getObject();
+    MYSQL_TIME *mysqlTime = (MYSQL_TIME*)var.getObjectPtr();
+
+    datetime->mday = mysqlTime->day;
+    datetime->hour = mysqlTime->hour;
+    datetime->minute = mysqlTime->minute;
+    datetime->month = mysqlTime->month;
+    datetime->second = mysqlTime->second;
+    datetime->year = mysqlTime->year;
+}
+
+void MySqlQuery::convertFromArena(const Conversion &conversion) const
+{
+    copyFromArena(conversion.attr);
+}
+
+// Unbind the current bound DbAttribute
+void MySqlQuery::unbind()
+{
+    if (m_stmt) {
+        for (Int32 i = 0; i < m_inputs.getSize(); ++i) {
+            deletePtr(m_inputs[i]);
+        }
+
+//		m_is_error.destroy();
+//		m_param_bind.destroy();
+//		m_length.destroy();
+//		m_param_length.destroy();
+//		m_param_bind.destroy();
+//		m_result_bind.destroy();
+    }
+}
+
+MySqlQuery::MySqlQuery(MYSQL *pDb, const String &name, const CString &query, MySqlDb *db) :
+    m_name(name),
+    m_query(query),
+    m_numParam(0),
+    m_numRow(0),
+    m_currRow(0),
+    m_pDB(pDb),
+    m_stmt(nullptr),
+    m_needBind(False),
+    m_outParams(False),
+    m_pendingResults(False),
+    m_resultIndex(0),
+    m_executeMode(EXEC_STORE),
+    m_prefetchRows(256),
+    m_arena(nullptr),
+    m_rowStamp(0),
+    m_lazyConversion(False),
+    //m_prepareMetaParam(nullptr),
+    m_prepareMetaResult(nullptr),
+    m_db(db),
+    m_timeout(0),
+    m_deadlineId(0),
+    m_deadlineArmed(False),
+    m_cursorTimeout(False),
+    m_sessionId(db ? &db->m_sessionId : nullptr),
+    m_preparedSession(db ? db->m_sessionId : 0)
+{
+    prepareQuery();
+}
+
+void MySqlQuery::execute()
+{
+    execute(m_timeout);
+}
+
+void MySqlQuery::execute(UInt32 timeout)
+{
+    // deadline of the previous result, not fully fetched
+    endDeadline();
+
+    MySqlAdmission::Permit permit(m_db ? m_db->getAdmission() : nullptr, m_name);
+
+    if (timeout == 0 || !m_db) {
+        executeStatement();
+        permit.succeeded();
+        return;
+    }
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    m_deadlineId = MySqlWatchdog::instance().arm(m_db, timeout);
+    m_deadlineArmed = True;
+
+    try {
+        executeStatement();
+    } catch (E_MySqlError &) {
+        if (endDeadline()) {
+            permit.overloaded();
+            O3D_ERROR(E_MySqlTimeout(String("Query ") + m_name + " cancelled after its timeout"));
+        }
+
+        throw;
+    } catch (...) {
+        endDeadline();
+        throw;
+    }
+
+    permit.succeeded();
+
+    // the rows are still sent by the server, disarmed after the last one
+    if (m_executeMode == EXEC_STREAM) {
+        return;
+    }
+
+    endDeadline();
+
+    // other queries can use the connection between two fetches, the cancel could
+    // hit them, so the deadline is only checked by the fetches
+    if (m_executeMode == EXEC_CURSOR) {
+        m_cursorDeadline = start + std::chrono::milliseconds(timeout);
+        m_cursorTimeout = True;
+    }
+}
+
+void MySqlQuery::update(UInt32 timeout)
+{
+    // deadline of a previous result, not fully fetched
+    endDeadline();
+
+    MySqlAdmission::Permit permit(m_db ? m_db->getAdmission() : nullptr, m_name);
+
+    if (timeout == 0 || !m_db) {
+        updateStatement();
+        permit.succeeded();
+        return;
+    }
+
+    MySqlDeadline deadline(m_db, timeout);
+
+    try {
+        updateStatement();
+        permit.succeeded();
+    } catch (E_MySqlError &) {
+        if (deadline.expired()) {
+            permit.overloaded();
+            O3D_ERROR(E_MySqlTimeout(String("Query ") + m_name + " cancelled after its timeout"));
+        }
+
+        throw;
+    }
+}
+
+void MySqlQuery::cancel()
+{
+    if (!m_db) {
+        O3D_ERROR(E_InvalidOperation("Query without connection"));
+    }
+
+    m_db->cancel();
+}
+
+// Execute the query on the current bound DbAttribute and store the result in the DbAttribute
+void MySqlQuery::executeStatement()
+{
+    O3D_ASSERT(m_stmt != nullptr);
+
+    if (m_stmt) {
+        if (m_sessionId && *m_sessionId != m_preparedSession) {
+            reprepare();
+        }
 
-    if (m_stmt) {
         m_numRow = 0;
         m_currRow = 0;
 
+        // unread rows of a previous streamed result
+        mysql_stmt_free_result(m_stmt);
+
+        drainResults();
+
         // bind if necessary
         if (m_needBind) {
             if (mysql_stmt_bind_param(m_stmt, &m_param_bind[0]) != 0) {
@@ -741,30 +1430,62 @@ void MySqlQuery::execute()
             m_needBind = False;
         }
 
-        if (mysql_stmt_execute(m_stmt) != 0) {
+        // the cursor is opened by the execute, and the prefetch used by the fetch
+        unsigned long cursorType = m_executeMode == EXEC_CURSOR ? CURSOR_TYPE_READ_ONLY : CURSOR_TYPE_NO_CURSOR;
+        unsigned long prefetchRows = m_prefetchRows;
+
+        if (mysql_stmt_attr_set(m_stmt, STMT_ATTR_CURSOR_TYPE, &cursorType) ||
+            mysql_stmt_attr_set(m_stmt, STMT_ATTR_PREFETCH_ROWS, &prefetchRows)) {
             O3D_ERROR(E_MySqlError(mysql_stmt_error(m_stmt)));
         }
 
-        if (mysql_stmt_bind_result(m_stmt,&m_result_bind[0]) != 0) {
+        if (mysql_stmt_execute(m_stmt) != 0) {
             O3D_ERROR(E_MySqlError(mysql_stmt_error(m_stmt)));
         }
 
-        if (mysql_stmt_store_result(m_stmt) != 0) {
-            O3D_ERROR(E_MySqlError(mysql_stmt_error(m_stmt)));
+        // the shape of the result of a CALL is only known once executed
+        if (m_resultIndex != 0 || mysql_stmt_field_count(m_stmt) != (UInt32)m_outputs.getSize()) {
+            bindResult();
         }
 
-        m_numRow = mysql_stmt_num_rows(m_stmt);
+        m_resultIndex = 0;
+
+        if (m_arena) {
+            m_arena->reset();
+        }
+
+        storeResult();
+    }
+}
+
+void MySqlQuery::setPrefetchRows(UInt32 rows)
+{
+    if (rows == 0) {
+        O3D_ERROR(E_InvalidParameter("At least one row per batch is required"));
     }
+
+    m_prefetchRows = rows;
 }
 
 void MySqlQuery::update()
+{
+    update(m_timeout);
+}
+
+void MySqlQuery::updateStatement()
 {
     O3D_ASSERT(m_stmt != nullptr);
 
     if (m_stmt) {
+        if (m_sessionId && *m_sessionId != m_preparedSession) {
+            reprepare();
+        }
+
         m_numRow = 0;
         m_currRow = 0;
 
+        drainResults();
+
         // bind if necessary
         if (m_needBind) {
             if (mysql_stmt_bind_param(m_stmt, &m_param_bind[0]) != 0) {
@@ -779,9 +1500,89 @@ void MySqlQuery::update()
         }
 
         m_numRow = mysql_stmt_affected_rows(m_stmt);
+
+        m_resultIndex = 0;
+        m_outParams = False;
+
+        // a CALL always ends with a status result
+        m_pendingResults = mysql_more_results(m_pDB);
     }
 }
 
+void MySqlQuery::storeResult()
+{
+    if (m_outputs.getSize() > 0) {
+        if (mysql_stmt_bind_result(m_stmt, &m_result_bind[0]) != 0) {
+            O3D_ERROR(E_MySqlError(mysql_stmt_error(m_stmt)));
+        }
+
+        if (m_executeMode == EXEC_STORE) {
+            if (mysql_stmt_store_result(m_stmt) != 0) {
+                O3D_ERROR(E_MySqlError(mysql_stmt_error(m_stmt)));
+            }
+
+            m_numRow = mysql_stmt_num_rows(m_stmt);
+        }
+    } else {
+        m_numRow = mysql_stmt_affected_rows(m_stmt);
+    }
+
+    m_outParams = (m_pDB->server_status & SERVER_PS_OUT_PARAMS) != 0;
+    m_pendingResults = mysql_more_results(m_pDB);
+}
+
+void MySqlQuery::drainResults()
+{
+    if (!m_pendingResults) {
+        return;
+    }
+
+    mysql_stmt_free_result(m_stmt);
+
+    while (mysql_stmt_next_result(m_stmt) == 0) {
+        mysql_stmt_free_result(m_stmt);
+    }
+
+    m_pendingResults = False;
+}
+
+Bool MySqlQuery::nextResult()
+{
+    O3D_ASSERT(m_stmt != nullptr);
+
+    if (!m_stmt || !m_pendingResults) {
+        return False;
+    }
+
+    m_numRow = 0;
+    m_currRow = 0;
+
+    mysql_stmt_free_result(m_stmt);
+
+    int res = mysql_stmt_next_result(m_stmt);
+    if (res != 0) {
+        m_pendingResults = False;
+        m_outParams = False;
+
+        if (res > 0) {
+            O3D_ERROR(E_MySqlError(mysql_stmt_error(m_stmt)));
+        }
+
+        return False;
+    }
+
+    ++m_resultIndex;
+
+    if (m_arena) {
+        m_arena->reset();
+    }
+
+    bindResult();
+    storeResult();
+
+    return True;
+}
+
 UInt32 MySqlQuery::getNumRows()
 {
     return m_numRow;
@@ -799,68 +1600,387 @@ UInt64 MySqlQuery::getGeneratedKey() const
 }
 
 // Fetch the results (outputs values) into the DbAttribute. Can be called in a while for each entry of the result.
+Bool MySqlQuery::fetchRow()
+{
+    if (m_cursorTimeout && std::chrono::steady_clock::now() >= m_cursorDeadline) {
+        m_cursorTimeout = False;
+        O3D_ERROR(E_MySqlTimeout(String("Query ") + m_name + " not fetched before its timeout"));
+    }
+
+    int res = mysql_stmt_fetch(m_stmt);
+
+    if (res == MYSQL_NO_DATA) {
+        endDeadline();
+        return False;
+    } else if (res == MYSQL_DATA_TRUNCATED) {
+        // expected in arena mode, the strings and blobs being fetched after
+        if (!m_arena) {
+            O3D_WARNING("MYSQL_DATA_TRUNCATED");
+        }
+    } else if (res != 0) {
+        if (endDeadline()) {
+            O3D_ERROR(E_MySqlTimeout(String("Query ") + m_name + " cancelled after its timeout"));
+        }
+
+        O3D_ERROR(E_MySqlError(mysql_stmt_error(m_stmt)));
+    }
+
+    ++m_rowStamp;
+    ++m_currRow;
+
+    return True;
+}
+
+Bool MySqlQuery::endDeadline()
+{
+    m_cursorTimeout = False;
+
+    if (!m_deadlineArmed) {
+        return False;
+    }
+
+    m_deadlineArmed = False;
+    return MySqlWatchdog::instance().disarm(m_deadlineId);
+}
+
 Bool MySqlQuery::fetch()
 {
     O3D_ASSERT(m_stmt != nullptr);
     if (m_stmt) {
-        int res = mysql_stmt_fetch(m_stmt);
+        if (!fetchRow()) {
+            return False;
+        }
+
+        if (m_arena) {
+            // a streamed row can't be read again
+            if (m_executeMode != EXEC_STORE) {
+                m_arena->reset();
+            }
+
+            fetchToArena();
+        }
+
+        // only the outputs of the plan, the others being fetched in place
+        if (!m_lazyConversion) {
+            for (const Conversion &conversion : m_conversions) {
+                if (!conversion.onAccess) {
+                    runConversion(conversion);
+                }
+            }
+        }
+
+        return True;
+	}
+
+    return False;
+}
+
+Bool MySqlQuery::decodeDecimal(const Char *text, size_t length, UInt32 scale, Int64 &value)
+{
+    const Char *end = text + length;
+    Bool negative = False;
+
+    if (text < end && (*text == '-' || *text == '+')) {
+        negative = *text == '-';
+        ++text;
+    }
 
-        if (res == MYSQL_NO_DATA) {
+    const UInt64 limit = negative ? (UInt64)1 << 63 : ((UInt64)1 << 63) - 1;
+    UInt64 v = 0;
+    Bool fraction = False;
+    UInt32 decimals = 0;
+
+    for (; text < end; ++text) {
+        Char c = *text;
+
+        if (c == '.') {
+            fraction = True;
+            continue;
+        } else if (c < '0' || c > '9') {
+            return False;
+        }
+
+        if (fraction) {
+            // more decimals than the scale are truncated
+            if (decimals == scale) {
+                break;
+            }
+
+            ++decimals;
+        }
+
+        UInt32 digit = c - '0';
+        if (v > (limit - digit) / 10) {
             return False;
-        } else if (res == MYSQL_DATA_TRUNCATED) {
-            O3D_WARNING("MYSQL_DATA_TRUNCATED");
-        } else if (res != 0) {
-            O3D_ERROR(E_MySqlError(mysql_stmt_error(m_stmt)));
         }
 
-		// validate arrays and strings results
-        UInt32 co = m_outputs.getSize();
-        for (size_t i = 0; i < co; ++i) {
+        v = v * 10 + digit;
+    }
+
+    for (; decimals < scale; ++decimals) {
+        if (v > limit / 10) {
+            return False;
+        }
+
+        v *= 10;
+    }
+
+    value = negative ? (Int64)((UInt64)0 - v) : (Int64)v;
+    return True;
+}
+
+void MySqlQuery::convertDecimal(const Conversion &conversion) const
+{
+    const DecodedOutput &decoded = m_decodedOutputs[conversion.decoded];
+    DbVariable &var = *m_outputs[conversion.attr];
+
+    const size_t length = std::min<size_t>(decoded.length, sizeof(decoded.buffer));
+
+    Int64 v;
+    if (!decodeDecimal(decoded.buffer, length, decoded.decimals, v)) {
+        O3D_ERROR(E_InvalidResult("DECIMAL value out of the 64 bits fixed point range"));
+    }
+
+    memcpy(var.getObjectPtr(), &v, sizeof(Int64));
+    var.setLength(sizeof(Int64));
+}
+
+void MySqlQuery::convertBit(const Conversion &conversion) const
+{
+    const DecodedOutput &decoded = m_decodedOutputs[conversion.decoded];
+    DbVariable &var = *m_outputs[conversion.attr];
+
+    const size_t length = std::min<size_t>(decoded.length, sizeof(decoded.buffer));
+    UInt64 v = decodeBit((const UInt8*)decoded.buffer, length);
+
+    memcpy(var.getObjectPtr(), &v, sizeof(UInt64));
+    var.setLength(sizeof(UInt64));
+}
+
+UInt64 MySqlQuery::decodeBit(const UInt8 *data, size_t length)
+{
+    // big endian, the last 64 bits
+    if (length > sizeof(UInt64)) {
+        data += length - sizeof(UInt64);
+        length = sizeof(UInt64);
+    }
+
+    UInt64 v = 0;
+    for (size_t i = 0; i < length; ++i) {
+        v = (v << 8) | data[i];
+    }
+
+    return v;
+}
+
+void MySqlQuery::fetchToArena()
+{
+    UInt32 co = m_outputs.getSize();
+    for (UInt32 i = 0; i < co; ++i) {
+        DbVariable &var = *m_outputs[i];
+
+        if (!isVarLength(var)) {
+            continue;
+        }
+
+        if (var.isNull()) {
+            m_arenaData[i] = nullptr;
+            continue;
+        }
+
+        // the length is the full length of the value, plus a terminal zero
+        UInt32 len = var.getLength();
+        UInt8 *data = m_arena->allocate(len+1);
+
+        if (len > 0) {
+            MYSQL_BIND bind = m_result_bind[i];
+            bind.buffer = data;
+            bind.buffer_length = len;
+
+            if (mysql_stmt_fetch_column(m_stmt, &bind, i, 0) != 0) {
+                O3D_ERROR(E_MySqlError(mysql_stmt_error(m_stmt)));
+            }
+        }
+
+        data[len] = 0;
+        m_arenaData[i] = data;
+    }
+}
+
+UInt64 MySqlQuery::packTime(const MYSQL_TIME &t)
+{
+    // a duration would be wrapped, only a point in time is ordered
+    if (t.neg || t.hour > 23 || t.month > 12 || t.day > 31 || t.minute > 59 || t.second > 59) {
+        O3D_ERROR(E_InvalidResult("Not a valid date or date time to pack"));
+    }
+
+    return ((UInt64)t.year << 40) | ((UInt64)t.month << 32) | ((UInt64)t.day << 24) |
+           ((UInt64)t.hour << 16) | ((UInt64)t.minute << 8) | (UInt64)t.second;
+}
+
+UInt32 MySqlQuery::fetchBatch(UInt32 maxRows, MySqlRowBlock &block)
+{
+    O3D_ASSERT(m_stmt != nullptr);
+
+    const UInt32 co = m_outputs.getSize();
+
+    block.reset(co);
+    for (UInt32 i = 0; i < co; ++i) {
+        block.setColumn(i, m_outputs[i]->getIntType());
+    }
+
+    if (!m_stmt || co == 0) {
+        return 0;
+    }
+
+    while (block.m_numRows < maxRows && fetchRow()) {
+        UInt64 *slots = block.appendRow();
+        UInt8 *nulls = block.m_nulls.data() + (size_t)(block.m_numRows - 1) * co;
+
+        for (UInt32 i = 0; i < co; ++i) {
             DbVariable &var = *m_outputs[i];
 
             if (var.isNull()) {
+                nulls[i] = 1;
                 continue;
             }
 
-            // string
-            if (var.getIntType() == DbVariable::IT_ARRAY_CHAR) {
-                ArrayChar *array = (ArrayChar*)var.getObject();
-
-                // add a terminal zero
-                array->setSize(var.getLength()+1);
-                (*array)[array->getSize()-1] = 0;
-			}
-            // array
-            else if (var.getIntType() == DbVariable::IT_ARRAY_UINT8) {
-                ArrayUInt8 *array = (ArrayUInt8*)var.getObject();
-                array->setSize(var.getLength());
-			}
-            // date
-            else if (var.getIntType() == DbVariable::IT_DATE) {
-                Date *date = (Date*)var.getObject();
-                MYSQL_TIME *mysqlTime = (MYSQL_TIME*)var.getObjectPtr();
-                date->mday = mysqlTime->day;
-                date->month = mysqlTime->month;
-                date->year = mysqlTime->year;
+            const UInt8 *object = var.getObjectPtr();
+            const DbVariable::VarType varType = var.getType();
+
+            switch (var.getIntType()) {
+            case DbVariable::IT_BOOL:
+                slots[i] = *(const Bool*)object ? 1 : 0;
+                break;
+
+            case DbVariable::IT_INT8:
+                slots[i] = varType == DbVariable::UINT8 ? (UInt64)*(const UInt8*)object :
+                                                          (UInt64)(Int64)*(const Int8*)object;
+                break;
+
+            case DbVariable::IT_INT16:
+                slots[i] = varType == DbVariable::UINT16 ? (UInt64)*(const UInt16*)object :
+                                                           (UInt64)(Int64)*(const Int16*)object;
+                break;
+
+            case DbVariable::IT_INT32:
+                slots[i] = varType == DbVariable::UINT32 ? (UInt64)*(const UInt32*)object :
+                                                           (UInt64)(Int64)*(const Int32*)object;
+                break;
+
+            case DbVariable::IT_INT64:
+            {
+                // DECIMAL and BIT are decoded first
+                Int32 conversion = m_conversionIndex[i];
+                if (conversion >= 0) {
+                    runConversion(m_conversions[conversion]);
+                }
+
+                memcpy(&slots[i], object, 8);
+                break;
             }
-            // datetime
-            else if (var.getIntType() == DbVariable::IT_DATETIME) {
-                DateTime *datetime = (DateTime*)var.getObject();
-                MYSQL_TIME *mysqlTime = (MYSQL_TIME*)var.getObjectPtr();
-                datetime->mday = mysqlTime->day;
-                datetime->hour = mysqlTime->hour;
-                datetime->minute = mysqlTime->minute;
-                datetime->month = mysqlTime->month;
-                datetime->second = mysqlTime->second;
-                datetime->year = mysqlTime->year;
+
+            case DbVariable::IT_FLOAT:
+            {
+                Double v = *(const Float*)object;
+                memcpy(&slots[i], &v, 8);
+                break;
             }
-		}
 
-        ++m_currRow;
-        return True;
-	}
+            case DbVariable::IT_DOUBLE:
+                memcpy(&slots[i], object, 8);
+                break;
+
+            case DbVariable::IT_DATE:
+            case DbVariable::IT_DATETIME:
+                slots[i] = packTime(*(const MYSQL_TIME*)object);
+                break;
+
+            case DbVariable::IT_ARRAY_CHAR:
+            case DbVariable::IT_ARRAY_UINT8:
+            {
+                UInt32 len = var.getLength();
+
+                if (m_arena) {
+                    // at its full length, directly into the block
+                    UInt8 *data = block.allocateData(len, slots[i]);
+
+                    if (len > 0) {
+                        MYSQL_BIND bind = m_result_bind[i];
+                        bind.buffer = data;
+                        bind.buffer_length = len;
+
+                        if (mysql_stmt_fetch_column(m_stmt, &bind, i, 0) != 0) {
+                            O3D_ERROR(E_MySqlError(mysql_stmt_error(m_stmt)));
+                        }
+                    }
+                } else {
+                    // truncated to the bound buffer
+                    len = std::min(len, var.getObjectSize());
+
+                    UInt8 *data = block.allocateData(len, slots[i]);
+                    memcpy(data, object, len);
+                }
+                break;
+            }
 
-    return False;
+            default:
+                O3D_ERROR(E_InvalidParameter("Unsupported column type for a row block"));
+            }
+        }
+    }
+
+    // the arena is not filled by a batch
+    std::fill(m_arenaData.begin(), m_arenaData.end(), nullptr);
+
+    return block.m_numRows;
+}
+
+std::shared_ptr<const MySqlRowSet> MySqlQuery::materialize()
+{
+    MySqlRowSetBuilder builder;
+    materialize(builder);
+
+    return builder.build();
+}
+
+void MySqlQuery::materialize(MySqlRowSetBuilder &builder)
+{
+    O3D_ASSERT(m_stmt != nullptr);
+
+    UInt32 co = m_outputs.getSize();
+    for (UInt32 i = 0; i < co; ++i) {
+        builder.addColumn(getOutName(i), m_outputs[i]->getIntType(), m_outputs[i]->getType(), getOutDecimals(i));
+    }
+
+    Bool rows = m_stmt != nullptr;
+
+    if (rows && m_executeMode == EXEC_STORE) {
+        rows = m_numRow > 0;
+        if (rows) {
+            seekRow(0);
+        }
+    }
+
+    if (rows) {
+        while (fetch()) {
+            builder.beginRow();
+
+            for (UInt32 i = 0; i < co; ++i) {
+                const DbVariable &var = *m_outputs[i];
+
+                if (var.isNull()) {
+                    continue;
+                }
+
+                if (m_arena && isVarLength(var)) {
+                    builder.setData(i, m_arenaData[i], var.getLength());
+                } else {
+                    builder.setValue(i, getOut(i));
+                }
+            }
+        }
+    }
 }
 
 UInt32 MySqlQuery::tellRow()
@@ -874,6 +1994,10 @@ UInt32 MySqlQuery::tellRow()
 
 void MySqlQuery::seekRow(UInt32 row)
 {
+    if (m_executeMode != EXEC_STORE) {
+        O3D_ERROR(E_InvalidOperation("Seek is only available in store mode"));
+    }
+
     if (row >= m_numRow) {
         O3D_ERROR(E_IndexOutOfRange("Row number"));
     }
@@ -1005,39 +2129,62 @@ void MySqlQuery::unmapType(
         enum_field_types mysqltype,
         UInt32 &maxSize,
         DbVariable::IntType &intType,
-        DbVariable::VarType &varType)
+        DbVariable::VarType &varType,
+        Bool isUnsigned)
 {
     switch (mysqltype) {
+    case MYSQL_TYPE_NULL:
+    case MYSQL_TYPE_BOOL:
     case MYSQL_TYPE_TINY:
         intType = DbVariable::IT_INT8;
-        varType = DbVariable::INT8;
+        varType = isUnsigned ? DbVariable::UINT8 : DbVariable::INT8;
         maxSize = 1;
         break;
 
     case MYSQL_TYPE_SHORT:
         intType = DbVariable::IT_INT16;
-        varType = DbVariable::INT16;
+        varType = isUnsigned ? DbVariable::UINT16 : DbVariable::INT16;
+        maxSize = 2;
+        break;
+
+    case MYSQL_TYPE_YEAR:
+        intType = DbVariable::IT_INT16;
+        varType = DbVariable::UINT16;
         maxSize = 2;
         break;
 
     case MYSQL_TYPE_INT24:
         intType = DbVariable::IT_INT32;
-        varType = DbVariable::INT32;
+        varType = isUnsigned ? DbVariable::UINT32 : DbVariable::INT32;
         maxSize = 4;
         break;
 
     case MYSQL_TYPE_LONG:
         intType = DbVariable::IT_INT32;
-        varType = DbVariable::INT32;
+        varType = isUnsigned ? DbVariable::UINT32 : DbVariable::INT32;
         maxSize = 4;
         break;
 
     case MYSQL_TYPE_LONGLONG:
+        intType = DbVariable::IT_INT64;
+        varType = isUnsigned ? DbVariable::UINT64 : DbVariable::INT64;
+        maxSize = 8;
+        break;
+
+    case MYSQL_TYPE_DECIMAL:
+    case MYSQL_TYPE_NEWDECIMAL:
+        // fixed point, scaled by the decimals of the field
         intType = DbVariable::IT_INT64;
         varType = DbVariable::INT64;
         maxSize = 8;
         break;
 
+    case MYSQL_TYPE_BIT:
+        intType = DbVariable::IT_INT64;
+        varType = DbVariable::UINT64;
+        maxSize = 8;
+        break;
+
     case MYSQL_TYPE_FLOAT:
         intType = DbVariable::IT_FLOAT;
         varType = DbVariable::FLOAT32;
@@ -1051,15 +2198,19 @@ void MySqlQuery::unmapType(
         break;
 
     case MYSQL_TYPE_VARCHAR:
+    case MYSQL_TYPE_VAR_STRING:
+    case MYSQL_TYPE_STRING:
+    case MYSQL_TYPE_ENUM:
+    case MYSQL_TYPE_SET:
         intType = DbVariable::IT_ARRAY_CHAR;
         varType = DbVariable::ARRAY;
         maxSize = 256;
         break;
 
-    case MYSQL_TYPE_VAR_STRING:
+    case MYSQL_TYPE_JSON:
         intType = DbVariable::IT_ARRAY_CHAR;
-        varType = DbVariable::ARRAY;
-        maxSize = 256;
+        varType = DbVariable::LONG_ARRAY;
+        maxSize = 4096;
         break;
 
     case MYSQL_TYPE_TINY_BLOB:
@@ -1081,19 +2232,37 @@ void MySqlQuery::unmapType(
         break;
 
     case MYSQL_TYPE_LONG_BLOB:
+    case MYSQL_TYPE_GEOMETRY:
         intType = DbVariable::IT_ARRAY_UINT8;
         varType = DbVariable::LONG_ARRAY;
         maxSize = 4096;
         break;
 
     case MYSQL_TYPE_TIMESTAMP:
+    case MYSQL_TYPE_DATE:
+    case MYSQL_TYPE_NEWDATE:
         intType = DbVariable::IT_DATE;
         varType = DbVariable::TIMESTAMP;
         maxSize = sizeof(MYSQL_TIME);
         break;
 
-    default:
-        O3D_ASSERT(0);
+    case MYSQL_TYPE_DATETIME:
+    case MYSQL_TYPE_DATETIME2:
+    case MYSQL_TYPE_TIMESTAMP2:
+        intType = DbVariable::IT_DATETIME;
+        varType = DbVariable::TIMESTAMP;
+        maxSize = sizeof(MYSQL_TIME);
         break;
+
+    case MYSQL_TYPE_TIME:
+    case MYSQL_TYPE_TIME2:
+        // a signed duration up to 838 hours, not a time of day, as text [-]hhh:mm:ss[.ffffff]
+        intType = DbVariable::IT_ARRAY_CHAR;
+        varType = DbVariable::ARRAY;
+        maxSize = 32;
+        break;
+
+    default:
+        O3D_ERROR(E_InvalidParameter("Unsupported MySQL field type"));
     };
 }
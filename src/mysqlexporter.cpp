@@ -0,0 +1,576 @@
+/**
+ * @file mysqlexporter.cpp
+ * @brief Export of a query result to a CSV or a binary columnar file.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#include "o3d/mysql/mysqlexporter.h"
+#include "o3d/mysql/mysqldb.h"
+
+#include <o3d/core/debug.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+using namespace o3d;
+using namespace o3d::mysql;
+
+static const Char COLUMNAR_MAGIC[8] = { 'O', '3', 'D', 'C', 'O', 'L', 0, 0 };
+static const UInt32 COLUMNAR_VERSION = 1;
+
+static const Char HEX_DIGITS[] = "0123456789abcdef";
+
+//! Write the decimal digits of a value, ending at end. Return the first digit.
+static Char* formatUInt64(Char *end, UInt64 v)
+{
+    do {
+        *--end = (Char)('0' + v % 10);
+        v /= 10;
+    } while (v);
+
+    return end;
+}
+
+static Char* formatInt64(Char *end, Int64 v)
+{
+    if (v < 0) {
+        Char *begin = formatUInt64(end, (UInt64)0 - (UInt64)v);
+        *--begin = '-';
+        return begin;
+    }
+
+    return formatUInt64(end, (UInt64)v);
+}
+
+//! True for an unsigned integer variable.
+static inline Bool isUnsigned(const DbVariable &var)
+{
+    const DbVariable::VarType type = var.getType();
+    return type == DbVariable::UINT8 || type == DbVariable::UINT16 ||
+           type == DbVariable::UINT32 || type == DbVariable::UINT64;
+}
+
+//! Read an integer output as 64 bits, to be taken as an UInt64 if unsigned.
+static Int64 readInteger(const DbVariable &var)
+{
+    const UInt8 *object = var.getObjectPtr();
+    const Bool isUnsign = isUnsigned(var);
+
+    switch (var.getIntType()) {
+    case DbVariable::IT_BOOL:
+        return *(const Bool*)object ? 1 : 0;
+    case DbVariable::IT_INT8:
+        return isUnsign ? (Int64)*(const UInt8*)object : (Int64)*(const Int8*)object;
+    case DbVariable::IT_INT16:
+        return isUnsign ? (Int64)*(const UInt16*)object : (Int64)*(const Int16*)object;
+    case DbVariable::IT_INT32:
+        return isUnsign ? (Int64)*(const UInt32*)object : (Int64)*(const Int32*)object;
+    case DbVariable::IT_INT64:
+        return *(const Int64*)object;
+    default:
+        O3D_ERROR(E_InvalidParameter("Not an integer variable"));
+    }
+}
+
+//! Size of a value in the columnar format, 0 for variable length.
+static UInt32 columnarWidth(UInt32 intType)
+{
+    switch (intType) {
+    case DbVariable::IT_BOOL:
+    case DbVariable::IT_INT8:
+        return 1;
+    case DbVariable::IT_INT16:
+        return 2;
+    case DbVariable::IT_INT32:
+    case DbVariable::IT_FLOAT:
+        return 4;
+    case DbVariable::IT_INT64:
+    case DbVariable::IT_DOUBLE:
+    case DbVariable::IT_DATE:
+    case DbVariable::IT_DATETIME:
+        return 8;
+    case DbVariable::IT_ARRAY_CHAR:
+    case DbVariable::IT_ARRAY_UINT8:
+        return 0;
+    default:
+        O3D_ERROR(E_InvalidParameter("Unsupported column type for a columnar export"));
+    }
+}
+
+namespace {
+
+//! Outputs of an executed query.
+class QuerySource : public MySqlExporter::Source
+{
+public:
+
+    QuerySource(MySqlQuery &query) : m_query(query) {}
+
+    virtual UInt32 getNumColumns() const override { return m_query.getNumOutputs(); }
+    virtual CString getColumnName(UInt32 col) const override { return m_query.getOutName(col); }
+    virtual UInt32 getColumnDecimals(UInt32 col) const override { return m_query.getOutDecimals(col); }
+    virtual Bool next() override { return m_query.fetch(); }
+    virtual const DbVariable& getOut(UInt32 col) const override { return m_query.getOut(col); }
+
+    virtual const UInt8* getOutData(UInt32 col, UInt32 &length) const override
+    {
+        return m_query.getOutData(col, length);
+    }
+
+private:
+
+    MySqlQuery &m_query;
+};
+
+} // anonymous namespace
+
+MySqlExporter::MySqlExporter(Format format) :
+    m_format(format),
+    m_delimiter(','),
+    m_header(True),
+    m_bufferSize(1024*1024),
+    m_rowGroupSize(65536),
+    m_out(nullptr),
+    m_bytes(0),
+    m_groupRows(0)
+{
+
+}
+
+MySqlExporter::Stats MySqlExporter::exportQuery(MySqlQuery &query, const String &filename)
+{
+    std::ofstream file(filename.toUtf8().getData(), std::ios::binary | std::ios::trunc);
+    if (!file) {
+        O3D_ERROR(E_FileNotFoundOrInvalidRights("Unable to create the export file", filename));
+    }
+
+    Stats stats = exportQuery(query, file);
+
+    file.close();
+    if (file.fail()) {
+        O3D_ERROR(E_FileNotFoundOrInvalidRights("Unable to write the export file", filename));
+    }
+
+    return stats;
+}
+
+MySqlExporter::Stats MySqlExporter::exportQuery(MySqlQuery &query, std::ostream &out)
+{
+    const Bool arena = query.isArenaMode();
+    const MySqlQuery::ExecuteMode mode = query.getExecuteMode();
+
+    // rows read while written, strings and blobs at their full length
+    query.setExecuteMode(MySqlQuery::EXEC_STREAM);
+    query.setArenaMode(True);
+
+    Stats stats;
+
+    try {
+        auto start = std::chrono::steady_clock::now();
+
+        query.execute();
+
+        QuerySource source(query);
+        stats = exportSource(source, out);
+
+        // with the execute
+        std::chrono::duration<Double> duration = std::chrono::steady_clock::now() - start;
+        stats.seconds = duration.count();
+    } catch (...) {
+        query.setExecuteMode(mode);
+        query.setArenaMode(arena);
+
+        throw;
+    }
+
+    query.setExecuteMode(mode);
+    query.setArenaMode(arena);
+
+    return stats;
+}
+
+MySqlExporter::Stats MySqlExporter::exportSource(Source &source, std::ostream &out)
+{
+    if (m_out) {
+        O3D_ERROR(E_InvalidOperation("An export is in progress"));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    m_out = &out;
+    m_buffer.clear();
+    m_buffer.reserve(m_bufferSize);
+    m_bytes = 0;
+
+    Stats stats;
+
+    try {
+        m_columns.resize(source.getNumColumns());
+        for (UInt32 i = 0; i < source.getNumColumns(); ++i) {
+            m_columns[i].intType = source.getOut(i).getIntType();
+            m_columns[i].width = 0;
+            m_columns[i].decimals = source.getColumnDecimals(i);
+        }
+
+        stats.rows = m_format == FORMAT_CSV ? writeCsv(source) : writeColumnar(source);
+        flush();
+    } catch (...) {
+        m_out = nullptr;
+        m_columns.clear();
+
+        throw;
+    }
+
+    m_out = nullptr;
+    m_columns.clear();
+
+    if (out.fail()) {
+        O3D_ERROR(E_InvalidResult("Unable to write the export"));
+    }
+
+    std::chrono::duration<Double> duration = std::chrono::steady_clock::now() - start;
+
+    stats.bytes = m_bytes;
+    stats.seconds = duration.count();
+
+    return stats;
+}
+
+void MySqlExporter::write(const void *data, size_t size)
+{
+    if (m_buffer.size() + size > m_bufferSize) {
+        flush();
+
+        // larger than the buffer, directly
+        if (size > m_bufferSize) {
+            m_out->write((const char*)data, (std::streamsize)size);
+            m_bytes += size;
+            return;
+        }
+    }
+
+    m_buffer.insert(m_buffer.end(), (const Char*)data, (const Char*)data + size);
+}
+
+void MySqlExporter::flush()
+{
+    if (!m_buffer.empty()) {
+        m_out->write(m_buffer.data(), (std::streamsize)m_buffer.size());
+        m_bytes += m_buffer.size();
+        m_buffer.clear();
+    }
+}
+
+void MySqlExporter::writeCsvField(const Char *text, size_t length, std::ostream &out)
+{
+    if (m_out) {
+        O3D_ERROR(E_InvalidOperation("An export is in progress"));
+    }
+
+    m_out = &out;
+    m_buffer.clear();
+
+    csvText(text, length);
+    flush();
+
+    m_out = nullptr;
+}
+
+//
+// CSV
+//
+
+UInt64 MySqlExporter::writeCsv(Source &source)
+{
+    const UInt32 numColumns = (UInt32)m_columns.size();
+
+    if (m_header) {
+        for (UInt32 i = 0; i < numColumns; ++i) {
+            if (i > 0) {
+                put(m_delimiter);
+            }
+
+            CString name = source.getColumnName(i);
+            csvText(name.getData(), name.length());
+        }
+
+        write("\r\n", 2);
+    }
+
+    UInt64 rows = 0;
+
+    while (source.next()) {
+        for (UInt32 i = 0; i < numColumns; ++i) {
+            if (i > 0) {
+                put(m_delimiter);
+            }
+
+            csvValue(source, i);
+        }
+
+        write("\r\n", 2);
+        ++rows;
+    }
+
+    return rows;
+}
+
+void MySqlExporter::csvText(const Char *text, size_t length)
+{
+    Bool quote = False;
+
+    for (size_t i = 0; i < length; ++i) {
+        Char c = text[i];
+        if (c == m_delimiter || c == '"' || c == '\r' || c == '\n') {
+            quote = True;
+            break;
+        }
+    }
+
+    if (!quote) {
+        write(text, length);
+        return;
+    }
+
+    // quotes are doubled
+    put('"');
+
+    size_t begin = 0;
+    for (size_t i = 0; i < length; ++i) {
+        if (text[i] == '"') {
+            write(text + begin, i + 1 - begin);
+            put('"');
+            begin = i + 1;
+        }
+    }
+
+    write(text + begin, length - begin);
+    put('"');
+}
+
+void MySqlExporter::csvValue(const Source &source, UInt32 attr)
+{
+    const UInt32 intType = m_columns[attr].intType;
+
+    // strings and blobs without copy
+    if (intType == DbVariable::IT_ARRAY_CHAR || intType == DbVariable::IT_ARRAY_UINT8) {
+        UInt32 length;
+        const UInt8 *data = source.getOutData(attr, length);
+
+        if (!data) {
+            write(m_nullText.getData(), m_nullText.length());
+        } else if (intType == DbVariable::IT_ARRAY_CHAR) {
+            csvText((const Char*)data, length);
+        } else {
+            for (UInt32 i = 0; i < length; ++i) {
+                put(HEX_DIGITS[data[i] >> 4]);
+                put(HEX_DIGITS[data[i] & 0x0f]);
+            }
+        }
+
+        return;
+    }
+
+    const DbVariable &var = source.getOut(attr);
+
+    if (var.isNull()) {
+        write(m_nullText.getData(), m_nullText.length());
+        return;
+    }
+
+    Char text[64];
+    Char *end = text + sizeof(text);
+    int len;
+
+    switch (intType) {
+    case DbVariable::IT_BOOL:
+    case DbVariable::IT_INT8:
+    case DbVariable::IT_INT16:
+    case DbVariable::IT_INT32:
+    case DbVariable::IT_INT64:
+    {
+        const Int64 v = readInteger(var);
+        const UInt32 decimals = m_columns[attr].decimals;
+
+        if (decimals == 0) {
+            Char *begin = isUnsigned(var) ? formatUInt64(end, (UInt64)v) : formatInt64(end, v);
+            write(begin, end - begin);
+            break;
+        }
+
+        // DECIMAL fixed point, at least one digit before the point
+        const UInt64 absolute = v < 0 ? (UInt64)0 - (UInt64)v : (UInt64)v;
+        Char *begin = formatUInt64(end, absolute);
+
+        while ((UInt32)(end - begin) <= decimals) {
+            *--begin = '0';
+        }
+
+        if (v < 0) {
+            put('-');
+        }
+
+        const size_t integral = (end - begin) - decimals;
+        write(begin, integral);
+        put('.');
+        write(begin + integral, decimals);
+        break;
+    }
+
+    case DbVariable::IT_FLOAT:
+        len = snprintf(text, sizeof(text), "%.9g", *(const Float*)var.getObjectPtr());
+        write(text, len);
+        break;
+
+    case DbVariable::IT_DOUBLE:
+        len = snprintf(text, sizeof(text), "%.17g", *(const Double*)var.getObjectPtr());
+        write(text, len);
+        break;
+
+    case DbVariable::IT_DATE:
+    case DbVariable::IT_DATETIME:
+    {
+        const MYSQL_TIME *t = (const MYSQL_TIME*)var.getObjectPtr();
+
+        if (t->time_type == MYSQL_TIMESTAMP_DATE) {
+            len = snprintf(text, sizeof(text), "%04u-%02u-%02u", t->year, t->month, t->day);
+        } else if (t->time_type == MYSQL_TIMESTAMP_TIME) {
+            // a duration, the hours up to 838
+            len = snprintf(text, sizeof(text), "%s%02u:%02u:%02u",
+                           t->neg ? "-" : "", t->hour, t->minute, t->second);
+        } else {
+            len = snprintf(text, sizeof(text), "%04u-%02u-%02u %02u:%02u:%02u",
+                           t->year, t->month, t->day, t->hour, t->minute, t->second);
+        }
+
+        write(text, len);
+        break;
+    }
+
+    default:
+        O3D_ERROR(E_InvalidParameter("Unsupported column type for a CSV export"));
+    }
+}
+
+//
+// Columnar
+//
+
+UInt64 MySqlExporter::writeColumnar(Source &source)
+{
+    const UInt32 numColumns = (UInt32)m_columns.size();
+    const UInt32 groupSize = m_rowGroupSize > 0 ? m_rowGroupSize : 65536;
+
+    // header
+    write(COLUMNAR_MAGIC, sizeof(COLUMNAR_MAGIC));
+    write(&COLUMNAR_VERSION, sizeof(UInt32));
+    write(&numColumns, sizeof(UInt32));
+
+    for (UInt32 i = 0; i < numColumns; ++i) {
+        ColumnData &column = m_columns[i];
+        column.width = columnarWidth(column.intType);
+
+        UInt8 type = (UInt8)column.intType;
+        write(&type, 1);
+
+        UInt8 decimals = (UInt8)column.decimals;
+        write(&decimals, 1);
+
+        CString name = source.getColumnName(i);
+        UInt32 nameLength = name.length();
+
+        write(&nameLength, sizeof(UInt32));
+        write(name.getData(), nameLength);
+
+        column.offsets.assign(1, 0);
+    }
+
+    m_groupRows = 0;
+    UInt64 rows = 0;
+
+    while (source.next()) {
+        const UInt32 bit = m_groupRows & 7;
+
+        for (UInt32 i = 0; i < numColumns; ++i) {
+            ColumnData &column = m_columns[i];
+
+            if (bit == 0) {
+                column.nulls.push_back(0);
+            }
+
+            if (column.width == 0) {
+                UInt32 length;
+                const UInt8 *data = source.getOutData(i, length);
+
+                if (data) {
+                    column.values.insert(column.values.end(), data, data + length);
+                } else {
+                    column.nulls.back() |= 1 << bit;
+                }
+
+                column.offsets.push_back((UInt32)column.values.size());
+                continue;
+            }
+
+            const DbVariable &var = source.getOut(i);
+            UInt8 value[8] = { 0 };
+
+            if (var.isNull()) {
+                column.nulls.back() |= 1 << bit;
+            } else if (column.intType == DbVariable::IT_DATE || column.intType == DbVariable::IT_DATETIME) {
+                UInt64 packed = MySqlQuery::packTime(*(const MYSQL_TIME*)var.getObjectPtr());
+                memcpy(value, &packed, 8);
+            } else if (column.intType == DbVariable::IT_BOOL) {
+                value[0] = *(const Bool*)var.getObjectPtr() ? 1 : 0;
+            } else {
+                memcpy(value, var.getObjectPtr(), column.width);
+            }
+
+            column.values.insert(column.values.end(), value, value + column.width);
+        }
+
+        ++rows;
+
+        if (++m_groupRows >= groupSize) {
+            flushRowGroup();
+        }
+    }
+
+    flushRowGroup();
+
+    // end of file
+    const UInt32 zero = 0;
+    write(&zero, sizeof(UInt32));
+
+    return rows;
+}
+
+void MySqlExporter::flushRowGroup()
+{
+    if (m_groupRows == 0) {
+        return;
+    }
+
+    write(&m_groupRows, sizeof(UInt32));
+
+    for (ColumnData &column : m_columns) {
+        write(column.nulls.data(), column.nulls.size());
+
+        if (column.width == 0) {
+            write(column.offsets.data(), column.offsets.size() * sizeof(UInt32));
+        }
+
+        write(column.values.data(), column.values.size());
+
+        column.nulls.clear();
+        column.values.clear();
+        column.offsets.assign(1, 0);
+    }
+
+    m_groupRows = 0;
+}
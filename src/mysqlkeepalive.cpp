@@ -0,0 +1,161 @@
+/**
+ * @file mysqlkeepalive.cpp
+ * @brief Background ping of the idle connections.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#include "o3d/mysql/mysqlkeepalive.h"
+#include "o3d/mysql/mysqldb.h"
+
+#include <o3d/core/debug.h>
+
+#include <mysql/mysql.h>
+
+using namespace o3d;
+using namespace o3d::mysql;
+
+MySqlKeepAlive::MySqlKeepAlive(UInt32 interval, Float jitter) :
+    m_interval(interval),
+    m_jitter(jitter),
+    m_running(True),
+    m_random(std::random_device()())
+{
+    if (interval == 0) {
+        O3D_ERROR(E_InvalidParameter("Keep alive interval must be greater than 0"));
+    }
+
+    if (jitter < 0.f || jitter > 1.f) {
+        O3D_ERROR(E_InvalidParameter("Keep alive jitter must be between 0 and 1"));
+    }
+
+    m_stats.pings = 0;
+    m_stats.failures = 0;
+
+    m_thread = std::thread(&MySqlKeepAlive::run, this);
+}
+
+MySqlKeepAlive::~MySqlKeepAlive()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = False;
+    }
+
+    m_condition.notify_all();
+    m_thread.join();
+}
+
+void MySqlKeepAlive::add(MySqlDb *db)
+{
+    if (!db) {
+        O3D_ERROR(E_InvalidParameter("Null connection"));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        Entry entry;
+        entry.nextPing = nextPing();
+        entry.busy = False;
+        entry.alive = True;
+
+        if (!m_connections.insert(std::make_pair(db, entry)).second) {
+            O3D_ERROR(E_InvalidOperation("Connection already added"));
+        }
+    }
+
+    m_condition.notify_all();
+}
+
+Bool MySqlKeepAlive::remove(MySqlDb *db)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    auto it = m_connections.find(db);
+    if (it == m_connections.end()) {
+        O3D_ERROR(E_InvalidParameter("Unknown connection"));
+    }
+
+    m_condition.wait(lock, [&] () { return !it->second.busy; });
+
+    Bool alive = it->second.alive;
+    m_connections.erase(it);
+
+    return alive;
+}
+
+UInt32 MySqlKeepAlive::getNumConnections() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return (UInt32)m_connections.size();
+}
+
+MySqlKeepAlive::Stats MySqlKeepAlive::getStats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+MySqlKeepAlive::Clock::time_point MySqlKeepAlive::nextPing()
+{
+    std::uniform_real_distribution<Float> distribution(-m_jitter, m_jitter);
+    auto delay = std::chrono::duration_cast<Clock::duration>(m_interval * (1.f + distribution(m_random)));
+
+    return Clock::now() + delay;
+}
+
+void MySqlKeepAlive::run()
+{
+    // the pings use the client library from this thread
+    mysql_thread_init();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (m_running) {
+        // earliest ping
+        auto next = m_connections.end();
+        for (auto it = m_connections.begin(); it != m_connections.end(); ++it) {
+            if (!it->second.busy && (next == m_connections.end() || it->second.nextPing < next->second.nextPing)) {
+                next = it;
+            }
+        }
+
+        if (next == m_connections.end()) {
+            m_condition.wait(lock);
+            continue;
+        }
+
+        if (next->second.nextPing > Clock::now()) {
+            // or a connection added or removed
+            m_condition.wait_until(lock, next->second.nextPing);
+            continue;
+        }
+
+        MySqlDb *db = next->first;
+        next->second.busy = True;
+
+        lock.unlock();
+        Bool alive = db->ping();
+        lock.lock();
+
+        // still registered, remove waits for the ping
+        Entry &entry = m_connections[db];
+        entry.busy = False;
+        entry.alive = alive;
+        entry.nextPing = nextPing();
+
+        ++m_stats.pings;
+        if (!alive) {
+            ++m_stats.failures;
+            O3D_WARNING("Keep alive ping failed, the connection is lost");
+        }
+
+        m_condition.notify_all();
+    }
+
+    lock.unlock();
+    mysql_thread_end();
+}
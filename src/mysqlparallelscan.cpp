@@ -0,0 +1,331 @@
+/**
+ * @file mysqlparallelscan.cpp
+ * @brief Table scan split into primary key ranges read over many connections.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#include "o3d/mysql/mysqlparallelscan.h"
+#include "o3d/mysql/mysqldb.h"
+
+#include <o3d/core/debug.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <string>
+
+using namespace o3d;
+using namespace o3d::mysql;
+
+static std::atomic<UInt32> ms_scanCounter(0);
+
+MySqlParallelScan::MySqlParallelScan(const std::vector<MySqlDb*> &connections, MySqlWorkerPool *pool) :
+    m_connections(connections),
+    m_pool(pool),
+    m_ownPool(False),
+    m_numChunks(0),
+    m_maxPending(0),
+    m_ordered(False)
+{
+    if (m_connections.empty()) {
+        O3D_ERROR(E_InvalidParameter("At least one connection is required"));
+    }
+
+    if (!m_pool) {
+        m_pool = new MySqlWorkerPool((UInt32)m_connections.size());
+        m_ownPool = True;
+    }
+}
+
+MySqlParallelScan::~MySqlParallelScan()
+{
+    if (m_ownPool) {
+        deletePtr(m_pool);
+    }
+}
+
+void MySqlParallelScan::setTable(
+        const CString &table,
+        const CString &primaryKey,
+        const std::vector<CString> &columns)
+{
+    m_table = table;
+    m_primaryKey = primaryKey;
+    m_columns = columns;
+}
+
+Bool MySqlParallelScan::queryBounds(Int64 &minKey, Int64 &maxKey)
+{
+    std::string sql = "SELECT MIN(";
+    sql += m_primaryKey.getData();
+    sql += "), MAX(";
+    sql += m_primaryKey.getData();
+    sql += ") FROM ";
+    sql += m_table.getData();
+
+    if (!m_condition.isEmpty()) {
+        sql += " WHERE ";
+        sql += m_condition.getData();
+    }
+
+    MySqlResult *result = m_connections[0]->executeDirect(CString(sql.c_str(), (UInt32)sql.length()));
+    Bool found = False;
+
+    try {
+        if (result->fetch()) {
+            UInt32 length;
+            const Char *minText = result->getText(0, length);
+            const Char *maxText = result->getText(1, length);
+
+            // NULL for an empty table
+            if (minText && maxText) {
+                minKey = strtoll(minText, nullptr, 10);
+                maxKey = strtoll(maxText, nullptr, 10);
+                found = True;
+            }
+        }
+    } catch (...) {
+        deletePtr(result);
+        throw;
+    }
+
+    deletePtr(result);
+    return found;
+}
+
+CString MySqlParallelScan::chunkQuery() const
+{
+    std::string sql = "SELECT ";
+
+    if (m_columns.empty()) {
+        sql += "*";
+    } else {
+        for (size_t i = 0; i < m_columns.size(); ++i) {
+            if (i > 0) {
+                sql += ", ";
+            }
+
+            sql += m_columns[i].getData();
+        }
+    }
+
+    sql += " FROM ";
+    sql += m_table.getData();
+    sql += " WHERE ";
+    sql += m_primaryKey.getData();
+    sql += " >= ? AND ";
+    sql += m_primaryKey.getData();
+    sql += " <= ?";
+
+    if (!m_condition.isEmpty()) {
+        sql += " AND (";
+        sql += m_condition.getData();
+        sql += ")";
+    }
+
+    if (m_ordered) {
+        sql += " ORDER BY ";
+        sql += m_primaryKey.getData();
+    }
+
+    return CString(sql.c_str(), (UInt32)sql.length());
+}
+
+MySqlParallelScan::Stats MySqlParallelScan::run(const Consumer &consumer)
+{
+    if (m_table.isEmpty() || m_primaryKey.isEmpty()) {
+        O3D_ERROR(E_InvalidPrecondition("The table and its primary key must be defined"));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    Stats stats;
+    stats.minKey = 0;
+    stats.maxKey = 0;
+    stats.numChunks = 0;
+    stats.numRows = 0;
+    stats.seconds = 0;
+
+    Int64 minKey, maxKey;
+    if (!queryBounds(minKey, maxKey)) {
+        return stats;
+    }
+
+    const UInt32 numWorkers = (UInt32)m_connections.size();
+
+    // split the range
+    UInt64 span = (UInt64)maxKey - (UInt64)minKey + 1;
+    UInt64 numChunks = m_numChunks ? m_numChunks : numWorkers * 4;
+
+    if (span < numChunks) {
+        numChunks = span;
+    }
+
+    UInt64 chunkSize = (span + numChunks - 1) / numChunks;
+    numChunks = (span + chunkSize - 1) / chunkSize;
+
+    const UInt32 maxPending = m_maxPending ? m_maxPending : numWorkers * 2;
+    const Bool ordered = m_ordered;
+
+    // state shared with the workers
+    std::mutex mutex;
+    std::condition_variable condition;
+
+    UInt32 nextChunk = 0;
+    UInt32 nextDeliver = 0;
+    UInt32 running = numWorkers;
+    Bool abort = False;
+    std::exception_ptr error;
+
+    std::map<UInt32, std::shared_ptr<const MySqlRowSet>> ready;
+
+    CString sql = chunkQuery();
+
+    Char name[48];
+    snprintf(name, sizeof(name), "o3d.parallelscan.%u", ms_scanCounter.fetch_add(1));
+    String queryName(name);
+
+    std::vector<std::future<void>> futures;
+    futures.reserve(numWorkers);
+
+    for (UInt32 w = 0; w < numWorkers; ++w) {
+        MySqlDb *db = m_connections[w];
+
+        futures.push_back(m_pool->submit([&, db] () {
+            MySqlQuery *query = nullptr;
+
+            try {
+                query = static_cast<MySqlQuery*>(db->registerQuery(queryName, sql));
+
+                // rows read one by one from the network into the builder, only the
+                // rowset of the chunk being held, the arena keeping a single row
+                query->setExecuteMode(MySqlQuery::EXEC_STREAM);
+                query->setArenaMode(True);
+
+                for (;;) {
+                    UInt32 chunk;
+
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        if (abort || nextChunk >= numChunks) {
+                            break;
+                        }
+
+                        chunk = nextChunk++;
+                    }
+
+                    Int64 lo = (Int64)((UInt64)minKey + chunk * chunkSize);
+                    Int64 hi = chunk == numChunks - 1 ? maxKey : (Int64)((UInt64)lo + chunkSize - 1);
+
+                    query->setInt64(0, lo);
+                    query->setInt64(1, hi);
+                    query->execute();
+
+                    std::shared_ptr<const MySqlRowSet> rows = query->materialize();
+
+                    {
+                        // the next chunk to deliver never waits, else it could block every worker
+                        std::unique_lock<std::mutex> lock(mutex);
+                        condition.wait(lock, [&] () {
+                            return abort || ready.size() < maxPending || (ordered && chunk == nextDeliver);
+                        });
+
+                        if (abort) {
+                            break;
+                        }
+
+                        ready[chunk] = rows;
+                    }
+
+                    condition.notify_all();
+                }
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+
+                abort = True;
+            }
+
+            if (query) {
+                db->unregisterQuery(queryName);
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                --running;
+            }
+
+            condition.notify_all();
+        }));
+    }
+
+    // delivery from the calling thread
+    for (;;) {
+        UInt32 chunk;
+        std::shared_ptr<const MySqlRowSet> rows;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [&] () {
+                return abort || running == 0 || (ordered ? ready.count(nextDeliver) > 0 : !ready.empty());
+            });
+
+            if (abort) {
+                break;
+            }
+
+            auto it = ordered ? ready.find(nextDeliver) : ready.begin();
+            if (it == ready.end()) {
+                // every worker is done
+                break;
+            }
+
+            chunk = it->first;
+            rows = it->second;
+
+            ready.erase(it);
+
+            if (ordered) {
+                ++nextDeliver;
+            }
+        }
+
+        condition.notify_all();
+
+        try {
+            consumer(chunk, *rows);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+
+            abort = True;
+        }
+
+        stats.numRows += rows->getNumRows();
+    }
+
+    condition.notify_all();
+    MySqlWorkerPool::waitAll(futures);
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    std::chrono::duration<Double> duration = std::chrono::steady_clock::now() - start;
+
+    stats.minKey = minKey;
+    stats.maxKey = maxKey;
+    stats.numChunks = (UInt32)numChunks;
+    stats.seconds = duration.count();
+
+    return stats;
+}
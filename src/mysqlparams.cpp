@@ -0,0 +1,309 @@
+/**
+ * @file mysqlparams.cpp
+ * @brief Recorded set of query input parameters.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#include "o3d/mysql/mysqlparams.h"
+
+#include <o3d/core/error.h>
+
+using namespace o3d;
+using namespace o3d::mysql;
+
+static const UInt64 FNV_OFFSET_BASIS = 14695981039346656037ULL;
+static const UInt64 FNV_PRIME = 1099511628211ULL;
+
+static inline UInt64 fnv1a(UInt64 h, const void *data, size_t size)
+{
+    const UInt8 *bytes = (const UInt8*)data;
+    for (size_t i = 0; i < size; ++i) {
+        h ^= bytes[i];
+        h *= FNV_PRIME;
+    }
+
+    return h;
+}
+
+MySqlParams::MySqlParams()
+{
+
+}
+
+void MySqlParams::clear()
+{
+    m_params.clear();
+}
+
+MySqlParams::Type MySqlParams::getType(UInt32 attr) const
+{
+    if (attr < m_params.size()) {
+        return m_params[attr].type;
+    }
+
+    return T_UNDEFINED;
+}
+
+MySqlParams::Param &MySqlParams::param(UInt32 attr, MySqlParams::Type type)
+{
+    if (attr >= m_params.size()) {
+        m_params.resize(attr + 1);
+    }
+
+    Param &p = m_params[attr];
+    p.type = type;
+    p.u64 = 0;
+
+    return p;
+}
+
+void MySqlParams::setArrayUInt8(UInt32 attr, const ArrayUInt8 &v)
+{
+    param(attr, T_ARRAY_UINT8).array = v;
+}
+
+void MySqlParams::setSmartArrayUInt8(UInt32 attr, const SmartArrayUInt8 &v)
+{
+    setBytes(attr, v.getData(), v.getSizeInBytes());
+}
+
+void MySqlParams::setBytes(UInt32 attr, const UInt8 *data, UInt32 size)
+{
+    Param &p = param(attr, T_ARRAY_UINT8);
+
+    p.array.setSize(size);
+    if (size) {
+        memcpy(p.array.getData(), data, size);
+    }
+}
+
+void MySqlParams::setBool(UInt32 attr, Bool v)
+{
+    param(attr, T_BOOL).i64 = v ? 1 : 0;
+}
+
+void MySqlParams::setInt32(UInt32 attr, Int32 v)
+{
+    param(attr, T_INT32).i64 = v;
+}
+
+void MySqlParams::setUInt32(UInt32 attr, UInt32 v)
+{
+    param(attr, T_UINT32).u64 = v;
+}
+
+void MySqlParams::setInt64(UInt32 attr, Int64 v)
+{
+    param(attr, T_INT64).i64 = v;
+}
+
+void MySqlParams::setUInt64(UInt32 attr, UInt64 v)
+{
+    param(attr, T_UINT64).u64 = v;
+}
+
+void MySqlParams::setFloat(UInt32 attr, Float v)
+{
+    param(attr, T_FLOAT).f64 = v;
+}
+
+void MySqlParams::setDouble(UInt32 attr, Double v)
+{
+    param(attr, T_DOUBLE).f64 = v;
+}
+
+void MySqlParams::setCString(UInt32 attr, const CString &v)
+{
+    param(attr, T_CSTRING).string = v;
+}
+
+void MySqlParams::setDate(UInt32 attr, const Date &date)
+{
+    param(attr, T_DATE).date = date;
+}
+
+void MySqlParams::setTimestamp(UInt32 attr, const DateTime &date)
+{
+    param(attr, T_TIMESTAMP).dateTime = date;
+}
+
+void MySqlParams::apply(DbQuery &query, UInt32 offset) const
+{
+    UInt32 attr = offset;
+    for (const Param &p : m_params) {
+        switch (p.type) {
+        case T_BOOL:
+            query.setBool(attr, p.i64 != 0);
+            break;
+        case T_INT32:
+            query.setInt32(attr, (Int32)p.i64);
+            break;
+        case T_UINT32:
+            query.setUInt32(attr, (UInt32)p.u64);
+            break;
+        case T_INT64:
+            query.setInt64(attr, p.i64);
+            break;
+        case T_UINT64:
+            query.setUInt64(attr, p.u64);
+            break;
+        case T_FLOAT:
+            query.setFloat(attr, (Float)p.f64);
+            break;
+        case T_DOUBLE:
+            query.setDouble(attr, p.f64);
+            break;
+        case T_CSTRING:
+            query.setCString(attr, p.string);
+            break;
+        case T_ARRAY_UINT8:
+            query.setArrayUInt8(attr, p.array);
+            break;
+        case T_DATE:
+            query.setDate(attr, p.date);
+            break;
+        case T_TIMESTAMP:
+            query.setTimestamp(attr, p.dateTime);
+            break;
+        default:
+            O3D_ERROR(E_InvalidParameter(String("Undefined input attribute ") << attr));
+            break;
+        }
+
+        ++attr;
+    }
+}
+
+UInt64 MySqlParams::hash(UInt32 attr) const
+{
+    if (getType(attr) == T_UNDEFINED) {
+        O3D_ERROR(E_InvalidParameter(String("Undefined input attribute ") << attr));
+    }
+
+    const Param &p = m_params[attr];
+
+    switch (p.type) {
+    case T_BOOL:
+    case T_INT32:
+    case T_UINT32:
+    case T_INT64:
+    case T_UINT64:
+        return fnv1a(FNV_OFFSET_BASIS, &p.u64, sizeof(UInt64));
+
+    case T_FLOAT:
+    case T_DOUBLE:
+        return fnv1a(FNV_OFFSET_BASIS, &p.f64, sizeof(Double));
+
+    case T_CSTRING:
+        return fnv1a(FNV_OFFSET_BASIS, p.string.getData(), p.string.length());
+
+    case T_ARRAY_UINT8:
+        return fnv1a(FNV_OFFSET_BASIS, p.array.getData(), p.array.getSize());
+
+    case T_DATE:
+    {
+        UInt32 fields[3] = { (UInt32)p.date.year, (UInt32)p.date.month, (UInt32)p.date.mday };
+        return fnv1a(FNV_OFFSET_BASIS, fields, sizeof(fields));
+    }
+
+    case T_TIMESTAMP:
+    {
+        UInt32 fields[6] = {
+            (UInt32)p.dateTime.year, (UInt32)p.dateTime.month, (UInt32)p.dateTime.mday,
+            (UInt32)p.dateTime.hour, (UInt32)p.dateTime.minute, (UInt32)p.dateTime.second };
+        return fnv1a(FNV_OFFSET_BASIS, fields, sizeof(fields));
+    }
+
+    default:
+        return 0;
+    }
+}
+
+Bool MySqlParams::equal(UInt32 attr, const MySqlParams &other) const
+{
+    Type type = getType(attr);
+    Type otherType = other.getType(attr);
+
+    if (type == T_UNDEFINED || otherType == T_UNDEFINED) {
+        O3D_ERROR(E_InvalidParameter(String("Undefined input attribute ") << attr));
+    }
+
+    const Param &p = m_params[attr];
+    const Param &o = other.m_params[attr];
+
+    switch (p.type) {
+    case T_BOOL:
+    case T_INT32:
+    case T_UINT32:
+    case T_INT64:
+    case T_UINT64:
+        return o.type >= T_BOOL && o.type <= T_UINT64 && p.u64 == o.u64;
+
+    case T_FLOAT:
+    case T_DOUBLE:
+        return (o.type == T_FLOAT || o.type == T_DOUBLE) && p.f64 == o.f64;
+
+    case T_CSTRING:
+        return o.type == T_CSTRING && p.string == o.string;
+
+    case T_ARRAY_UINT8:
+        return o.type == T_ARRAY_UINT8 && p.array.getSize() == o.array.getSize() &&
+                memcmp(p.array.getData(), o.array.getData(), p.array.getSize()) == 0;
+
+    case T_DATE:
+        return o.type == T_DATE && p.date.year == o.date.year &&
+                p.date.month == o.date.month && p.date.mday == o.date.mday;
+
+    case T_TIMESTAMP:
+        return o.type == T_TIMESTAMP &&
+                p.dateTime.year == o.dateTime.year && p.dateTime.month == o.dateTime.month &&
+                p.dateTime.mday == o.dateTime.mday && p.dateTime.hour == o.dateTime.hour &&
+                p.dateTime.minute == o.dateTime.minute && p.dateTime.second == o.dateTime.second &&
+                p.dateTime.microsecond == o.dateTime.microsecond;
+
+    default:
+        return False;
+    }
+}
+
+UInt64 MySqlParams::key(const CString &text) const
+{
+    UInt64 h = fnv1a(FNV_OFFSET_BASIS, text.getData(), text.length());
+
+    for (UInt32 i = 0; i < getNumParams(); ++i) {
+        h ^= hash(i);
+        h *= FNV_PRIME;
+    }
+
+    return h;
+}
+
+void MySqlParams::add(UInt32 attr, const MySqlParams &other)
+{
+    Type type = getType(attr);
+    Type otherType = other.getType(attr);
+
+    if (type == T_UNDEFINED || otherType == T_UNDEFINED) {
+        O3D_ERROR(E_InvalidParameter(String("Undefined input attribute ") << attr));
+    }
+
+    Param &p = m_params[attr];
+    const Param &o = other.m_params[attr];
+
+    Bool integer = p.type >= T_INT32 && p.type <= T_UINT64;
+    Bool otherInteger = o.type >= T_INT32 && o.type <= T_UINT64;
+
+    if (integer && otherInteger) {
+        // two's complement, the same for signed and unsigned
+        p.u64 += o.u64;
+    } else if ((p.type == T_FLOAT || p.type == T_DOUBLE) && (o.type == T_FLOAT || o.type == T_DOUBLE)) {
+        p.f64 += o.f64;
+    } else if ((p.type == T_FLOAT || p.type == T_DOUBLE) && otherInteger) {
+        p.f64 += (o.type == T_UINT32 || o.type == T_UINT64) ? (Double)o.u64 : (Double)o.i64;
+    } else {
+        O3D_ERROR(E_InvalidParameter(String("Input attribute is not numeric ") << attr));
+    }
+}
@@ -0,0 +1,328 @@
+/**
+ * @file mysqlreactor.cpp
+ * @brief Event loop driving many connections with the non-blocking client API.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#include "o3d/mysql/mysqlreactor.h"
+
+#ifdef O3D_MYSQL_REACTOR
+
+#include "o3d/mysql/mysqldb.h"
+#include "o3d/mysql/mysqlexception.h"
+
+#include <sys/epoll.h>
+#include <unistd.h>
+#include <cerrno>
+
+using namespace o3d;
+using namespace o3d::mysql;
+
+static const Int32 MAX_EVENTS = 64;
+
+MySqlReactor::MySqlReactor() :
+    m_epoll(-1)
+{
+    m_epoll = epoll_create1(EPOLL_CLOEXEC);
+    if (m_epoll < 0) {
+        O3D_ERROR(E_InvalidResult("Unable to create the epoll instance"));
+    }
+}
+
+MySqlReactor::~MySqlReactor()
+{
+    m_runnable.clear();
+    m_operations.clear();
+
+    if (m_epoll >= 0) {
+        ::close(m_epoll);
+        m_epoll = -1;
+    }
+}
+
+void MySqlReactor::connect(
+        MySqlDb &db,
+        const String &host,
+        UInt32 port,
+        const String &database,
+        const String &user,
+        const String &password,
+        Bool keepPassord,
+        const ConnectHandler &handler)
+{
+    if (db.m_pDB && m_operations.find(db.m_pDB) != m_operations.end()) {
+        O3D_ERROR(E_InvalidOperation("An operation is already pending on the connection"));
+    }
+
+    port = db.prepareConnect(host, port, database, user, password, keepPassord);
+
+    Operation &op = start(db.m_pDB, STEP_CONNECT);
+    op.db = &db;
+    op.host = db.m_host.toUtf8();
+    op.user = db.m_user.toUtf8();
+    op.password = password.toUtf8();
+    op.database = db.m_database.toUtf8();
+    op.port = port;
+    op.onConnect = handler;
+}
+
+void MySqlReactor::execute(MySqlDb &db, const CString &sql, Bool buffered, const ResultHandler &handler)
+{
+    if (!db.m_pDB) {
+        O3D_ERROR(E_InvalidOperation("Not connected"));
+    }
+
+    Operation &op = start(db.m_pDB, STEP_QUERY);
+    op.db = &db;
+    op.sql = sql;
+    op.buffered = buffered;
+    op.onResult = handler;
+}
+
+void MySqlReactor::fetch(MySqlResult &result, const FetchHandler &handler)
+{
+    if (result.isBuffered()) {
+        O3D_ERROR(E_InvalidOperation("A buffered result is fetched without wait by MySqlResult::fetch"));
+    }
+
+    Operation &op = start(result.m_pDB, STEP_FETCH);
+    op.result = &result;
+    op.onFetch = handler;
+}
+
+UInt32 MySqlReactor::poll(Int32 timeout)
+{
+    if (!m_operations.empty()) {
+        epoll_event events[MAX_EVENTS];
+
+        // don't wait while some operations are runnable
+        int n = epoll_wait(m_epoll, events, MAX_EVENTS, m_runnable.empty() ? timeout : 0);
+        if (n < 0 && errno != EINTR) {
+            O3D_ERROR(E_InvalidResult("epoll_wait failed"));
+        }
+
+        for (int i = 0; i < n; ++i) {
+            Operation *op = static_cast<Operation*>(events[i].data.ptr);
+            if (!op->queued) {
+                op->queued = True;
+                m_runnable.push_back(op);
+            }
+        }
+    }
+
+    // the operations started by the handlers are run by the next poll
+    UInt32 numDone = 0;
+    size_t count = m_runnable.size();
+
+    while (count-- > 0 && !m_runnable.empty()) {
+        Operation *op = m_runnable.front();
+        m_runnable.pop_front();
+
+        if (dispatch(op)) {
+            ++numDone;
+        }
+    }
+
+    return numDone;
+}
+
+void MySqlReactor::run()
+{
+    while (!m_operations.empty()) {
+        poll(-1);
+    }
+}
+
+MySqlReactor::Operation& MySqlReactor::start(MYSQL *pDB, Step step)
+{
+    std::unique_ptr<Operation> &slot = m_operations[pDB];
+    if (slot) {
+        O3D_ERROR(E_InvalidOperation("An operation is already pending on the connection"));
+    }
+
+    slot.reset(new Operation());
+
+    Operation &op = *slot;
+    op.step = step;
+    op.pDB = pDB;
+    op.db = nullptr;
+    op.result = nullptr;
+    op.port = 0;
+    op.buffered = True;
+    op.hasRow = False;
+    op.registered = False;
+    op.queued = True;
+
+    // tried at the next poll, the most of the operations progressing at once
+    m_runnable.push_back(&op);
+
+    return op;
+}
+
+Bool MySqlReactor::progress(Operation &op)
+{
+    net_async_status status;
+
+    switch (op.step) {
+    case STEP_CONNECT:
+    {
+        const CString &unixSocket = op.db->m_options.getUnixSocket();
+
+        // called again with the same arguments until complete
+        status = mysql_real_connect_nonblocking(
+                    op.pDB,
+                    op.host.getData(),
+                    op.user.getData(),
+                    op.password.getData(),
+                    op.database.getData(),
+                    op.port,
+                    unixSocket.isEmpty() ? NULL : unixSocket.getData(),
+                    op.db->m_options.getClientFlags());
+
+        if (status == NET_ASYNC_NOT_READY) {
+            return False;
+        } else if (status == NET_ASYNC_ERROR) {
+            O3D_ERROR(E_MySqlError(mysql_error(op.pDB)));
+        }
+
+        op.db->connected(op.port);
+        return True;
+    }
+
+    case STEP_QUERY:
+        status = mysql_real_query_nonblocking(op.pDB, op.sql.getData(), (unsigned long)op.sql.length());
+
+        if (status == NET_ASYNC_NOT_READY) {
+            return False;
+        } else if (status == NET_ASYNC_ERROR) {
+            O3D_ERROR(E_MySqlError(mysql_error(op.pDB)));
+        }
+
+        if (!op.buffered) {
+            // the metadata are already read, the rows being read by fetch
+            op.result = new MySqlResult(op.pDB, mysql_use_result(op.pDB), False);
+            return True;
+        }
+
+        op.step = STEP_STORE;
+        return progress(op);
+
+    case STEP_STORE:
+    {
+        MYSQL_RES *result = nullptr;
+        status = mysql_store_result_nonblocking(op.pDB, &result);
+
+        if (status == NET_ASYNC_NOT_READY) {
+            return False;
+        } else if (status == NET_ASYNC_ERROR) {
+            O3D_ERROR(E_MySqlError(mysql_error(op.pDB)));
+        }
+
+        // null for a statement without result set
+        op.result = new MySqlResult(op.pDB, result, True);
+        return True;
+    }
+
+    case STEP_FETCH:
+    {
+        if (!op.result->m_result) {
+            op.hasRow = False;
+            return True;
+        }
+
+        MYSQL_ROW row = nullptr;
+        status = mysql_fetch_row_nonblocking(op.result->m_result, &row);
+
+        if (status == NET_ASYNC_NOT_READY) {
+            return False;
+        } else if (status == NET_ASYNC_ERROR) {
+            O3D_ERROR(E_MySqlError(mysql_error(op.pDB)));
+        }
+
+        op.hasRow = op.result->acceptRow(row);
+        return True;
+    }
+
+    default:
+        return True;
+    }
+}
+
+Bool MySqlReactor::dispatch(Operation *op)
+{
+    op->queued = False;
+
+    Bool done;
+
+    try {
+        done = progress(*op);
+
+        if (!done && !op->registered) {
+            // edge triggered, the client reading or writing until it would block
+            epoll_event event;
+            event.events = EPOLLIN | EPOLLOUT | EPOLLET;
+            event.data.ptr = op;
+
+            if (epoll_ctl(m_epoll, EPOLL_CTL_ADD, op->pDB->net.fd, &event) != 0) {
+                O3D_ERROR(E_InvalidResult("Unable to watch the socket of the connection"));
+            }
+
+            op->registered = True;
+        }
+    } catch (...) {
+        if (op->result && op->step != STEP_FETCH) {
+            deletePtr(op->result);
+        }
+
+        op->error = std::current_exception();
+        done = True;
+    }
+
+    if (!done) {
+        return False;
+    }
+
+    if (op->registered) {
+        // fails if a failed connect closed the socket, already removed then
+        epoll_ctl(m_epoll, EPOLL_CTL_DEL, op->pDB->net.fd, nullptr);
+        op->registered = False;
+    }
+
+    // the handler can start the next operation of the connection
+    auto it = m_operations.find(op->pDB);
+    std::unique_ptr<Operation> owned(std::move(it->second));
+    m_operations.erase(it);
+
+    switch (owned->step) {
+    case STEP_CONNECT:
+        if (owned->onConnect) {
+            owned->onConnect(owned->error);
+        }
+        break;
+
+    case STEP_QUERY:
+    case STEP_STORE:
+        if (owned->onResult) {
+            owned->onResult(owned->result, owned->error);
+        } else {
+            deletePtr(owned->result);
+        }
+        break;
+
+    case STEP_FETCH:
+        if (owned->onFetch) {
+            owned->onFetch(owned->hasRow, owned->error);
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    return True;
+}
+
+#endif // O3D_MYSQL_REACTOR
@@ -0,0 +1,405 @@
+/**
+ * @file mysqlresult.cpp
+ * @brief Result of a direct (text protocol) query.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#include "o3d/mysql/mysqlresult.h"
+#include "o3d/mysql/mysqldb.h"
+#include "o3d/mysql/mysqlexception.h"
+#include "o3d/mysql/mysqldbvariable.h"
+
+#include <cstdlib>
+#include <cstdio>
+
+using namespace o3d;
+using namespace o3d::mysql;
+
+MySqlResult::MySqlResult(MYSQL *pDb, Bool buffered) :
+    m_pDB(pDb),
+    m_result(nullptr),
+    m_buffered(buffered),
+    m_row(nullptr),
+    m_lengths(nullptr),
+    m_numRows(0),
+    m_currRow(0),
+    m_generatedKey(0),
+    m_rowStamp(0)
+{
+    O3D_ASSERT(m_pDB != nullptr);
+    readResult();
+}
+
+MySqlResult::MySqlResult(MYSQL *pDb, MYSQL_RES *result, Bool buffered) :
+    m_pDB(pDb),
+    m_result(result),
+    m_buffered(buffered),
+    m_row(nullptr),
+    m_lengths(nullptr),
+    m_numRows(0),
+    m_currRow(0),
+    m_generatedKey(0),
+    m_rowStamp(0)
+{
+    O3D_ASSERT(m_pDB != nullptr);
+    setupResult();
+}
+
+MySqlResult::~MySqlResult()
+{
+    freeResult();
+    drainResults();
+}
+
+UInt32 MySqlResult::getNumRows() const
+{
+    return m_numRows;
+}
+
+void MySqlResult::readResult()
+{
+    m_result = m_buffered ? mysql_store_result(m_pDB) : mysql_use_result(m_pDB);
+    setupResult();
+}
+
+void MySqlResult::setupResult()
+{
+    if (!m_result) {
+        if (mysql_field_count(m_pDB) != 0) {
+            O3D_ERROR(E_MySqlError(mysql_error(m_pDB)));
+        }
+
+        // statement without result set
+        m_numRows = (UInt32)mysql_affected_rows(m_pDB);
+        m_generatedKey = mysql_insert_id(m_pDB);
+
+        return;
+    }
+
+    m_numRows = m_buffered ? (UInt32)mysql_num_rows(m_result) : 0;
+
+    UInt32 numFields = mysql_num_fields(m_result);
+    MYSQL_FIELD *fields = mysql_fetch_fields(m_result);
+
+    UInt32 maxSize;
+    DbVariable::IntType intType;
+    DbVariable::VarType varType;
+
+    m_fieldTypes.resize(numFields);
+    m_decimals.resize(numFields);
+
+    for (UInt32 i = 0; i < numFields; ++i) {
+        // the same types as the outputs of a MySqlQuery
+        const Bool isUnsigned = (fields[i].flags & UNSIGNED_FLAG) != 0;
+        MySqlQuery::unmapType(fields[i].type, maxSize, intType, varType, isUnsigned);
+
+        m_fieldTypes[i] = fields[i].type;
+        m_decimals[i] = fields[i].decimals;
+
+        m_outputNames.insert(std::make_pair(CString(fields[i].name), i));
+        m_outputs[i] = new MySqlDbVariable(intType, varType, maxSize);
+    }
+
+    m_parsedStamp.assign(numFields, 0);
+}
+
+void MySqlResult::freeResult()
+{
+    if (m_result) {
+        // with mysql_use_result the remaining rows are read and discarded
+        mysql_free_result(m_result);
+        m_result = nullptr;
+    }
+
+    for (Int32 i = 0; i < m_outputs.getSize(); ++i) {
+        deletePtr(m_outputs[i]);
+    }
+
+    m_outputs.setSize(0);
+    m_outputNames.clear();
+    m_parsedStamp.clear();
+    m_fieldTypes.clear();
+    m_decimals.clear();
+
+    m_row = nullptr;
+    m_lengths = nullptr;
+}
+
+void MySqlResult::drainResults()
+{
+    // the connection is out of sync until every result has been read
+    while (mysql_more_results(m_pDB) && mysql_next_result(m_pDB) == 0) {
+        MYSQL_RES *result = mysql_use_result(m_pDB);
+        if (result) {
+            mysql_free_result(result);
+        }
+    }
+}
+
+Bool MySqlResult::hasMoreResults() const
+{
+    return mysql_more_results(m_pDB);
+}
+
+Bool MySqlResult::nextResult()
+{
+    freeResult();
+
+    int res = mysql_next_result(m_pDB);
+    if (res > 0) {
+        O3D_ERROR(E_MySqlError(mysql_error(m_pDB)));
+    } else if (res < 0) {
+        return False;
+    }
+
+    m_numRows = 0;
+    m_currRow = 0;
+
+    readResult();
+
+    return True;
+}
+
+Bool MySqlResult::fetch()
+{
+    if (!m_result) {
+        return False;
+    }
+
+    return acceptRow(mysql_fetch_row(m_result));
+}
+
+Bool MySqlResult::acceptRow(MYSQL_ROW row)
+{
+    m_row = row;
+    if (!m_row) {
+        if (!m_buffered && mysql_errno(m_pDB) != 0) {
+            O3D_ERROR(E_MySqlError(mysql_error(m_pDB)));
+        }
+
+        return False;
+    }
+
+    m_lengths = mysql_fetch_lengths(m_result);
+
+    ++m_rowStamp;
+    ++m_currRow;
+
+    return True;
+}
+
+void MySqlResult::seekRow(UInt32 row)
+{
+    if (!m_buffered) {
+        O3D_ERROR(E_InvalidOperation("Seek is only available for a buffered result"));
+    }
+
+    if (row >= m_numRows) {
+        O3D_ERROR(E_IndexOutOfRange("Row number"));
+    }
+
+    mysql_data_seek(m_result, row);
+
+    m_currRow = row;
+    m_row = nullptr;
+}
+
+UInt32 MySqlResult::getOutAttr(const CString &name) const
+{
+    auto it = m_outputNames.find(name);
+    if (it != m_outputNames.end()) {
+        return it->second;
+    } else {
+        O3D_ERROR(E_InvalidParameter(o3d::String("Unknown output attribute name ") + name));
+    }
+}
+
+const DbVariable &MySqlResult::getOut(const CString &name) const
+{
+    return getOut(getOutAttr(name));
+}
+
+const DbVariable &MySqlResult::getOut(UInt32 attr) const
+{
+    if (attr >= (UInt32)m_outputs.getSize()) {
+        O3D_ERROR(E_IndexOutOfRange("Output attribute is out of range"));
+    }
+
+    if (!m_row) {
+        O3D_ERROR(E_InvalidOperation("No current row"));
+    }
+
+    if (m_parsedStamp[attr] != m_rowStamp) {
+        parse(attr);
+    }
+
+    return *m_outputs[attr];
+}
+
+const Char *MySqlResult::getText(UInt32 attr, UInt32 &length) const
+{
+    if (attr >= (UInt32)m_outputs.getSize()) {
+        O3D_ERROR(E_IndexOutOfRange("Output attribute is out of range"));
+    }
+
+    if (!m_row) {
+        O3D_ERROR(E_InvalidOperation("No current row"));
+    }
+
+    length = m_row[attr] ? (UInt32)m_lengths[attr] : 0;
+    return m_row[attr];
+}
+
+void MySqlResult::parse(UInt32 attr) const
+{
+    DbVariable &var = *m_outputs[attr];
+    m_parsedStamp[attr] = m_rowStamp;
+
+    const Char *text = m_row[attr];
+    const UInt32 len = (UInt32)m_lengths[attr];
+
+    var.setNull(text == nullptr);
+    if (!text) {
+        return;
+    }
+
+    const enum_field_types fieldType = m_fieldTypes[attr];
+
+    if (fieldType == MYSQL_TYPE_DECIMAL || fieldType == MYSQL_TYPE_NEWDECIMAL) {
+        // fixed point, scaled by the decimals of the field
+        Int64 v;
+        if (!MySqlQuery::decodeDecimal(text, len, m_decimals[attr], v)) {
+            O3D_ERROR(E_InvalidResult("DECIMAL value out of the 64 bits fixed point range"));
+        }
+
+        memcpy(var.getObjectPtr(), &v, sizeof(Int64));
+        var.setLength(sizeof(Int64));
+        return;
+    } else if (fieldType == MYSQL_TYPE_BIT) {
+        // the text protocol gives the big endian bytes
+        UInt64 v = MySqlQuery::decodeBit((const UInt8*)text, len);
+
+        memcpy(var.getObjectPtr(), &v, sizeof(UInt64));
+        var.setLength(sizeof(UInt64));
+        return;
+    }
+
+    // values are zero terminated, a leading '-' means signed
+    const Bool negative = text[0] == '-';
+
+    switch (var.getIntType()) {
+    case DbVariable::IT_BOOL:
+    case DbVariable::IT_INT8:
+        *(Int8*)var.getObjectPtr() = (Int8)strtol(text, nullptr, 10);
+        var.setLength(1);
+        break;
+
+    case DbVariable::IT_INT16:
+        *(Int16*)var.getObjectPtr() = (Int16)strtol(text, nullptr, 10);
+        var.setLength(2);
+        break;
+
+    case DbVariable::IT_INT32:
+        *(UInt32*)var.getObjectPtr() = negative ? (UInt32)strtol(text, nullptr, 10) : (UInt32)strtoul(text, nullptr, 10);
+        var.setLength(4);
+        break;
+
+    case DbVariable::IT_INT64:
+        *(UInt64*)var.getObjectPtr() = negative ? (UInt64)strtoll(text, nullptr, 10) : (UInt64)strtoull(text, nullptr, 10);
+        var.setLength(8);
+        break;
+
+    case DbVariable::IT_FLOAT:
+        *(Float*)var.getObjectPtr() = strtof(text, nullptr);
+        var.setLength(4);
+        break;
+
+    case DbVariable::IT_DOUBLE:
+        *(Double*)var.getObjectPtr() = strtod(text, nullptr);
+        var.setLength(8);
+        break;
+
+    case DbVariable::IT_ARRAY_CHAR:
+    {
+        ArrayChar *array = (ArrayChar*)var.getObject();
+
+        // add a terminal zero
+        array->setSize(len+1);
+        memcpy(array->getData(), text, len);
+        (*array)[len] = 0;
+
+        var.setLength(len);
+        break;
+    }
+
+    case DbVariable::IT_ARRAY_UINT8:
+    {
+        ArrayUInt8 *array = (ArrayUInt8*)var.getObject();
+
+        array->setSize(len);
+        memcpy(array->getData(), text, len);
+
+        var.setLength(len);
+        break;
+    }
+
+    case DbVariable::IT_DATE:
+    case DbVariable::IT_DATETIME:
+    {
+        MYSQL_TIME *mysqlTime = (MYSQL_TIME*)var.getObjectPtr();
+        memset(mysqlTime, 0, sizeof(MYSQL_TIME));
+
+        unsigned int year = 0, month = 0, day = 0, hour = 0, minute = 0, second = 0;
+        sscanf(text, "%u-%u-%u %u:%u:%u", &year, &month, &day, &hour, &minute, &second);
+
+        mysqlTime->year = year;
+        mysqlTime->month = month;
+        mysqlTime->day = day;
+        mysqlTime->hour = hour;
+        mysqlTime->minute = minute;
+        mysqlTime->second = second;
+        mysqlTime->time_type = MYSQL_TIMESTAMP_DATETIME;
+
+        // fractional seconds of a DATETIME(n), as microseconds
+        const Char *fraction = (const Char*)memchr(text, '.', len);
+        if (fraction) {
+            unsigned long microseconds = 0;
+            UInt32 digits = 0;
+
+            for (const Char *p = fraction + 1; p < text + len && *p >= '0' && *p <= '9' && digits < 6; ++p, ++digits) {
+                microseconds = microseconds * 10 + (*p - '0');
+            }
+
+            for (; digits < 6; ++digits) {
+                microseconds *= 10;
+            }
+
+            mysqlTime->second_part = microseconds;
+        }
+
+        if (var.getIntType() == DbVariable::IT_DATE) {
+            Date *date = (Date*)var.getObject();
+            date->mday = mysqlTime->day;
+            date->month = mysqlTime->month;
+            date->year = mysqlTime->year;
+        } else {
+            DateTime *datetime = (DateTime*)var.getObject();
+            datetime->mday = mysqlTime->day;
+            datetime->hour = mysqlTime->hour;
+            datetime->minute = mysqlTime->minute;
+            datetime->month = mysqlTime->month;
+            datetime->second = mysqlTime->second;
+            datetime->year = mysqlTime->year;
+        }
+
+        var.setLength(sizeof(MYSQL_TIME));
+        break;
+    }
+
+    default:
+        break;
+    }
+}
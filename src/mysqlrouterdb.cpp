@@ -0,0 +1,722 @@
+/**
+ * @file mysqlrouterdb.cpp
+ * @brief Read/write splitting over a primary and many replicas.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#include "o3d/mysql/mysqlrouterdb.h"
+#include "o3d/mysql/mysqlexception.h"
+
+#include <o3d/core/debug.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+
+using namespace o3d;
+using namespace o3d::mysql;
+
+static Int64 routerTimeMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+MySqlRouterDb::MySqlRouterDb() :
+    Database(),
+    m_primary(nullptr),
+    m_maxLag(5),
+    m_lagCheckInterval(1000),
+    m_autoLagCheck(True),
+    m_alpha(0.2f),
+    m_hedgePercentile(0.95f),
+    m_minHedgeDelay(2),
+    m_hedgePool(nullptr)
+{
+    m_primary = new MySqlDb();
+}
+
+MySqlRouterDb::~MySqlRouterDb()
+{
+    disconnect();
+
+    for (Replica &replica : m_replicas) {
+        deletePtr(replica.db);
+    }
+
+    deletePtr(m_primary);
+}
+
+Bool MySqlRouterDb::connect(
+        const String &host,
+        UInt32 port,
+        const String &database,
+        const String &user,
+        const String &password,
+        Bool keepPassord)
+{
+    m_host = host;
+    m_database = database;
+    m_user = user;
+
+    if (keepPassord) {
+        m_password = password;
+    }
+
+    m_primary->connect(host, port, database, user, password, keepPassord);
+    m_isConnected = True;
+
+    return True;
+}
+
+void MySqlRouterDb::disconnect()
+{
+    m_isConnected = False;
+
+    waitHedges();
+
+    for (Replica &replica : m_replicas) {
+        replica.db->disconnect();
+        replica.lag = -1;
+    }
+
+    m_primary->disconnect();
+}
+
+void MySqlRouterDb::pingConnection()
+{
+    m_primary->pingConnection();
+
+    for (Replica &replica : m_replicas) {
+        if (!replica.busy->load()) {
+            replica.db->pingConnection();
+        }
+    }
+}
+
+void MySqlRouterDb::addReplica(const String &host, UInt32 port)
+{
+    if (!m_isConnected) {
+        O3D_ERROR(E_InvalidOperation("The primary must be connected before adding a replica"));
+    }
+
+    MySqlDb *db = new MySqlDb();
+
+    try {
+        db->connect(host, port, m_database, m_user, m_password, m_primary->getConnectOptions());
+    } catch (E_BaseException &) {
+        deletePtr(db);
+        throw;
+    }
+
+    addReplica(db);
+}
+
+void MySqlRouterDb::addReplica(MySqlDb *replica)
+{
+    if (!replica) {
+        O3D_ERROR(E_InvalidParameter("Replica must be valid"));
+    }
+
+    m_replicas.push_back(Replica(replica));
+}
+
+MySqlDb *MySqlRouterDb::getReplica(UInt32 index)
+{
+    if (index >= m_replicas.size()) {
+        O3D_ERROR(E_IndexOutOfRange("Replica index"));
+    }
+
+    return m_replicas[index].db;
+}
+
+DbQuery *MySqlRouterDb::registerReadOnlyQuery(const String &name, const CString &query)
+{
+    // always created by our newDbQuery
+    MySqlRoutedQuery *routedQuery = static_cast<MySqlRoutedQuery*>(registerQuery(name, query));
+    if (routedQuery) {
+        routedQuery->setReadOnly(True);
+    }
+
+    return routedQuery;
+}
+
+DbQuery *MySqlRouterDb::newDbQuery(const String &name, const CString &query)
+{
+    return new MySqlRoutedQuery(this, name, query);
+}
+
+Int32 MySqlRouterDb::selectReplica(Int32 exclude)
+{
+    if (m_autoLagCheck) {
+        checkReplicas();
+    }
+
+    Int32 best = -1;
+    Float bestScore = 0.f;
+
+    for (size_t i = 0; i < m_replicas.size(); ++i) {
+        const Replica &replica = m_replicas[i];
+
+        if ((Int32)i == exclude) {
+            continue;
+        }
+
+        if (replica.lag < 0 || (UInt32)replica.lag > m_maxLag || replica.busy->load() ||
+            !replica.db->isConnected()) {
+            continue;
+        }
+
+        if (best < 0 || replica.latency < bestScore) {
+            best = (Int32)i;
+            bestScore = replica.latency;
+        }
+    }
+
+    return best;
+}
+
+MySqlWorkerPool &MySqlRouterDb::hedgePool()
+{
+    // the router is not thread-safe, so at most the two copies of one execute run,
+    // plus the losers of the previous ones and their cancel
+    if (!m_hedgePool) {
+        m_hedgePool = new MySqlWorkerPool(4);
+    }
+
+    return *m_hedgePool;
+}
+
+void MySqlRouterDb::waitHedges()
+{
+    // the pending tasks are done before the threads leave
+    deletePtr(m_hedgePool);
+}
+
+void MySqlRouterDb::checkReplicas()
+{
+    Int64 now = routerTimeMs();
+
+    for (Replica &replica : m_replicas) {
+        if (now - replica.lastCheck < (Int64)m_lagCheckInterval) {
+            continue;
+        }
+
+        // measured once its hedge is reaped
+        if (replica.busy->load()) {
+            continue;
+        }
+
+        replica.lastCheck = now;
+
+        if (!replica.db->isConnected()) {
+            replica.lag = -1;
+            continue;
+        }
+
+        try {
+            replica.lag = replica.db->getReplicationLag();
+        } catch (E_MySqlError &) {
+            replica.lag = -1;
+        }
+
+        // decay the latency so a replica once slow will be probed again
+        replica.latency *= 0.5f;
+    }
+}
+
+void MySqlRouterDb::reportExecute(Int32 replica, Float latency, Bool failed)
+{
+    Replica &r = m_replicas[replica];
+
+    if (failed) {
+        // excluded until the next lag measure
+        r.lag = -1;
+    } else if (r.latency <= 0.f) {
+        r.latency = latency;
+    } else {
+        r.latency = m_alpha * latency + (1.f - m_alpha) * r.latency;
+    }
+}
+
+//
+// MySqlRoutedQuery
+//
+
+MySqlRoutedQuery::MySqlRoutedQuery(
+        MySqlRouterDb *router,
+        const String &name,
+        const CString &query) :
+    m_router(router),
+    m_name(name),
+    m_query(query),
+    m_readOnly(False),
+    m_paramsVersion(1),
+    m_primaryQuery(nullptr),
+    m_primaryVersion(0),
+    m_current(nullptr),
+    m_currentReplica(-1),
+    m_hedgeBudget(0.f),
+    m_hedgeCredit(0.f),
+    m_numHedges(0),
+    m_numHedgeWins(0),
+    m_latencyPos(0)
+{
+
+}
+
+MySqlRoutedQuery::~MySqlRoutedQuery()
+{
+    // backend queries are owned by their database
+}
+
+void MySqlRoutedQuery::setHedgeBudget(Float budget)
+{
+    if (budget < 0.f || budget > 1.f) {
+        O3D_ERROR(E_InvalidParameter("Hedge budget must be between 0 and 1"));
+    }
+
+    m_hedgeBudget = budget;
+    m_hedgeCredit = 0.f;
+}
+
+void MySqlRoutedQuery::setArrayUInt8(UInt32 attr, const ArrayUInt8 &v)
+{
+    m_params.setArrayUInt8(attr, v);
+    ++m_paramsVersion;
+}
+
+void MySqlRoutedQuery::setSmartArrayUInt8(UInt32 attr, const SmartArrayUInt8 &v)
+{
+    m_params.setSmartArrayUInt8(attr, v);
+    ++m_paramsVersion;
+}
+
+void MySqlRoutedQuery::setInStream(UInt32 attr, const InStream &v)
+{
+    O3D_ERROR(E_InvalidOperation("Not supported by routed queries"));
+}
+
+void MySqlRoutedQuery::setBool(UInt32 attr, Bool v)
+{
+    m_params.setBool(attr, v);
+    ++m_paramsVersion;
+}
+
+void MySqlRoutedQuery::setInt32(UInt32 attr, Int32 v)
+{
+    m_params.setInt32(attr, v);
+    ++m_paramsVersion;
+}
+
+void MySqlRoutedQuery::setUInt32(UInt32 attr, UInt32 v)
+{
+    m_params.setUInt32(attr, v);
+    ++m_paramsVersion;
+}
+
+void MySqlRoutedQuery::setInt64(UInt32 attr, Int64 v)
+{
+    m_params.setInt64(attr, v);
+    ++m_paramsVersion;
+}
+
+void MySqlRoutedQuery::setUInt64(UInt32 attr, UInt64 v)
+{
+    m_params.setUInt64(attr, v);
+    ++m_paramsVersion;
+}
+
+void MySqlRoutedQuery::setFloat(UInt32 attr, Float v)
+{
+    m_params.setFloat(attr, v);
+    ++m_paramsVersion;
+}
+
+void MySqlRoutedQuery::setDouble(UInt32 attr, Double v)
+{
+    m_params.setDouble(attr, v);
+    ++m_paramsVersion;
+}
+
+void MySqlRoutedQuery::setCString(UInt32 attr, const CString &v)
+{
+    m_params.setCString(attr, v);
+    ++m_paramsVersion;
+}
+
+void MySqlRoutedQuery::setDate(UInt32 attr, const Date &date)
+{
+    m_params.setDate(attr, date);
+    ++m_paramsVersion;
+}
+
+void MySqlRoutedQuery::setTimestamp(UInt32 attr, const DateTime &date)
+{
+    m_params.setTimestamp(attr, date);
+    ++m_paramsVersion;
+}
+
+UInt32 MySqlRoutedQuery::getOutAttr(const CString &name)
+{
+    // same metadata on any server
+    return (m_current ? m_current : backendQuery(-1))->getOutAttr(name);
+}
+
+const DbVariable &MySqlRoutedQuery::getOut(const CString &name) const
+{
+    return current()->getOut(name);
+}
+
+const DbVariable &MySqlRoutedQuery::getOut(UInt32 attr) const
+{
+    return current()->getOut(attr);
+}
+
+void MySqlRoutedQuery::execute()
+{
+    Int32 replica = m_readOnly ? m_router->selectReplica() : -1;
+    if (replica < 0) {
+        selectBackend(-1)->execute();
+        return;
+    }
+
+    Float delay = hedgeDelay();
+    if (delay >= 0.f) {
+        executeHedged(replica, delay);
+        return;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    try {
+        selectBackend(replica)->execute();
+    } catch (E_MySqlError &) {
+        m_router->reportExecute(replica, 0.f, True);
+
+        // a read can always be retried on the primary
+        selectBackend(-1)->execute();
+        return;
+    }
+
+    Float latency = std::chrono::duration<Float, std::milli>(
+                std::chrono::steady_clock::now() - start).count();
+
+    m_router->reportExecute(replica, latency, False);
+    recordLatency(latency);
+}
+
+void MySqlRoutedQuery::update()
+{
+    selectBackend(-1)->update();
+}
+
+UInt32 MySqlRoutedQuery::getNumRows()
+{
+    return current()->getNumRows();
+}
+
+UInt64 MySqlRoutedQuery::getGeneratedKey() const
+{
+    return current()->getGeneratedKey();
+}
+
+Bool MySqlRoutedQuery::fetch()
+{
+    return current()->fetch();
+}
+
+UInt32 MySqlRoutedQuery::tellRow()
+{
+    return m_current ? m_current->tellRow() : 0;
+}
+
+void MySqlRoutedQuery::seekRow(UInt32 row)
+{
+    current()->seekRow(row);
+}
+
+void MySqlRoutedQuery::unbind()
+{
+    m_params.clear();
+    ++m_paramsVersion;
+
+    if (m_primaryQuery) {
+        m_primaryQuery->unbind();
+    }
+
+    for (size_t i = 0; i < m_replicaQueries.size(); ++i) {
+        if (!m_replicaQueries[i]) {
+            continue;
+        }
+
+        if (m_router->m_replicas[i].busy->load()) {
+            // running a reaped hedge, unbound by its next prepareBackend
+            m_replicaVersions[i] = 0;
+        } else {
+            m_replicaQueries[i]->unbind();
+        }
+    }
+}
+
+DbQuery *MySqlRoutedQuery::backendQuery(Int32 replica)
+{
+    if (replica < 0) {
+        if (!m_primaryQuery) {
+            m_primaryQuery = m_router->m_primary->registerQuery(m_name, m_query);
+        }
+
+        return m_primaryQuery;
+    }
+
+    if ((size_t)replica >= m_replicaQueries.size()) {
+        m_replicaQueries.resize(m_router->m_replicas.size(), nullptr);
+        m_replicaVersions.resize(m_router->m_replicas.size(), 0);
+    }
+
+    if (!m_replicaQueries[replica]) {
+        m_replicaQueries[replica] = m_router->m_replicas[replica].db->registerQuery(m_name, m_query);
+    }
+
+    return m_replicaQueries[replica];
+}
+
+DbQuery *MySqlRoutedQuery::current() const
+{
+    if (!m_current) {
+        O3D_ERROR(E_InvalidOperation("The query must be executed before"));
+    }
+
+    return m_current;
+}
+
+DbQuery *MySqlRoutedQuery::selectBackend(Int32 replica)
+{
+    DbQuery *query = prepareBackend(replica);
+
+    m_current = query;
+    m_currentReplica = replica;
+
+    return query;
+}
+
+DbQuery *MySqlRoutedQuery::prepareBackend(Int32 replica)
+{
+    DbQuery *query = backendQuery(replica);
+    UInt32 &version = replica < 0 ? m_primaryVersion : m_replicaVersions[replica];
+
+    // replay the inputs only if they changed since the last execute on this server
+    if (version != m_paramsVersion) {
+        if (version == 0) {
+            // never set, or left bound by an unbind during a reaped hedge
+            query->unbind();
+        }
+
+        m_params.apply(*query);
+        version = m_paramsVersion;
+    }
+
+    return query;
+}
+
+void MySqlRoutedQuery::recordLatency(Float latency)
+{
+    if (m_hedgeBudget <= 0.f) {
+        return;
+    }
+
+    if (m_latencies.size() < NUM_LATENCIES) {
+        m_latencies.push_back(latency);
+    } else {
+        m_latencies[m_latencyPos] = latency;
+        m_latencyPos = (m_latencyPos + 1) % NUM_LATENCIES;
+    }
+}
+
+Float MySqlRoutedQuery::hedgeDelay()
+{
+    if (m_hedgeBudget <= 0.f) {
+        return -1.f;
+    }
+
+    // the budget is earned by the executes, one hedge spending a whole unit
+    m_hedgeCredit = std::min(m_hedgeCredit + m_hedgeBudget, 1.f + m_hedgeBudget);
+
+    // too few samples for a meaningful percentile
+    if (m_hedgeCredit < 1.f || m_latencies.size() < NUM_LATENCIES / 8) {
+        return -1.f;
+    }
+
+    m_sorted = m_latencies;
+
+    size_t n = (size_t)(m_router->m_hedgePercentile * (m_sorted.size() - 1));
+    std::nth_element(m_sorted.begin(), m_sorted.begin() + n, m_sorted.end());
+
+    return std::max(m_sorted[n], (Float)m_router->m_minHedgeDelay);
+}
+
+void MySqlRoutedQuery::executeHedged(Int32 replica, Float delay)
+{
+    // the two copies race, the first success wins, shared with the tasks which
+    // can outlive this execute
+    struct Race
+    {
+        std::mutex mutex;
+        std::condition_variable condition;
+        Int32 winner = -1;
+        UInt32 numDone = 0;
+        Bool done[2] = { False, False };
+        std::exception_ptr errors[2];
+
+        DbQuery *queries[2] = { nullptr, nullptr };
+        MySqlDb *dbs[2] = { nullptr, nullptr };
+        std::shared_ptr<std::atomic<Bool>> busy[2];
+
+        Int32 loser = -1;
+        UInt32 reaping = 0;     //!< The loser execute and its cancel, until both end
+
+        //! Free the replica of the loser once reaped, the mutex being locked.
+        void reaped()
+        {
+            if (--reaping == 0) {
+                busy[loser]->store(False);
+            }
+        }
+    };
+
+    std::shared_ptr<Race> race = std::make_shared<Race>();
+    Int32 replicas[2] = { replica, -1 };
+
+    race->queries[0] = prepareBackend(replica);
+    race->dbs[0] = m_router->m_replicas[replica].db;
+    race->busy[0] = m_router->m_replicas[replica].busy;
+
+    auto run = [race] (UInt32 i) {
+        std::exception_ptr error;
+
+        try {
+            race->queries[i]->execute();
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(race->mutex);
+
+            race->errors[i] = error;
+            race->done[i] = True;
+            ++race->numDone;
+
+            if (!error && race->winner < 0) {
+                race->winner = (Int32)i;
+            }
+
+            if (race->loser == (Int32)i) {
+                race->reaped();
+            }
+        }
+
+        race->condition.notify_all();
+    };
+
+    MySqlWorkerPool &pool = m_router->hedgePool();
+    UInt32 numLaunched = 1;
+
+    auto start = std::chrono::steady_clock::now();
+
+    pool.submit([run] () { run(0); });
+
+    std::unique_lock<std::mutex> lock(race->mutex);
+
+    if (!race->condition.wait_for(lock, std::chrono::duration<Float, std::milli>(delay),
+                                  [&race] () { return race->numDone > 0; })) {
+        lock.unlock();
+
+        // slower than usual, send a copy to another replica
+        Int32 other = m_router->selectReplica(replica);
+        if (other >= 0) {
+            race->queries[1] = prepareBackend(other);
+            race->dbs[1] = m_router->m_replicas[other].db;
+            race->busy[1] = m_router->m_replicas[other].busy;
+            replicas[1] = other;
+
+            m_hedgeCredit -= 1.f;
+            ++m_numHedges;
+
+            pool.submit([run] () { run(1); });
+            numLaunched = 2;
+        }
+
+        lock.lock();
+    }
+
+    race->condition.wait(lock, [&race, numLaunched] () {
+        return race->winner >= 0 || race->numDone == numLaunched; });
+
+    Float latency = std::chrono::duration<Float, std::milli>(
+                std::chrono::steady_clock::now() - start).count();
+
+    const Int32 winner = race->winner;
+    Bool reaped[2] = { False, False };
+
+    if (numLaunched == 2 && winner >= 0 && !race->done[1 - winner]) {
+        // the loser is cancelled and waited for in the background, its replica
+        // being skipped until both are done, so the kill can't reach a next query
+        const Int32 loser = 1 - winner;
+
+        race->loser = loser;
+        race->reaping = 2;
+        race->busy[loser]->store(True);
+        reaped[loser] = True;
+
+        pool.submit([race] () {
+            Bool running;
+            {
+                std::lock_guard<std::mutex> lock(race->mutex);
+                running = !race->done[race->loser];
+            }
+
+            if (running) {
+                try {
+                    // opens the side connection on the first cancel of the replica
+                    race->dbs[race->loser]->cancel();
+                } catch (E_BaseException &) {
+                    O3D_WARNING("Unable to cancel a hedged read, its replica is busy until its end");
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(race->mutex);
+            race->reaped();
+        });
+    }
+
+    std::exception_ptr errors[2] = { race->errors[0], race->errors[1] };
+    lock.unlock();
+
+    for (UInt32 i = 0; i < numLaunched; ++i) {
+        if (errors[i] && !reaped[i]) {
+            m_router->reportExecute(replicas[i], 0.f, True);
+        }
+    }
+
+    if (winner < 0) {
+        // a read can always be retried on the primary
+        selectBackend(-1)->execute();
+        return;
+    }
+
+    if (winner == 1) {
+        ++m_numHedgeWins;
+    }
+
+    m_current = race->queries[winner];
+    m_currentReplica = replicas[winner];
+
+    m_router->reportExecute(m_currentReplica, latency, False);
+    recordLatency(latency);
+}
@@ -0,0 +1,210 @@
+/**
+ * @file mysqlrowblock.cpp
+ * @brief Reusable block of rows filled by a batched fetch.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#include "o3d/mysql/mysqlrowblock.h"
+#include "o3d/mysql/mysqldb.h"
+
+#include <o3d/core/debug.h>
+
+#include <cstring>
+
+using namespace o3d;
+using namespace o3d::mysql;
+
+MySqlRowBlock::MySqlRowBlock() :
+    m_numRows(0)
+{
+
+}
+
+DbVariable::IntType MySqlRowBlock::getColumnType(UInt32 col) const
+{
+    if (col >= m_columns.size()) {
+        O3D_ERROR(E_IndexOutOfRange("Column index"));
+    }
+
+    return m_columns[col].intType;
+}
+
+void MySqlRowBlock::outOfRange()
+{
+    O3D_ERROR(E_IndexOutOfRange("Row number or column index"));
+}
+
+Double MySqlRowBlock::asReal(size_t index, UInt32 col) const
+{
+    if (m_columns[col].kind != KIND_REAL) {
+        O3D_ERROR(E_InvalidParameter("Column is not numeric"));
+    }
+
+    Double v;
+    memcpy(&v, &m_slots[index], 8);
+
+    return v;
+}
+
+const UInt8 *MySqlRowBlock::getData(UInt32 row, UInt32 col, UInt32 *length) const
+{
+    size_t i = index(row, col);
+
+    if (m_columns[col].kind != KIND_DATA) {
+        O3D_ERROR(E_InvalidParameter("Column is not a string or a blob"));
+    }
+
+    if (m_nulls[i]) {
+        if (length) {
+            *length = 0;
+        }
+
+        return nullptr;
+    }
+
+    // offset and length
+    UInt64 slot = m_slots[i];
+
+    if (length) {
+        *length = (UInt32)(slot >> 32);
+    }
+
+    return m_heap.data() + (UInt32)slot;
+}
+
+Date MySqlRowBlock::asDate(UInt32 row, UInt32 col) const
+{
+    size_t i = index(row, col);
+
+    if (m_columns[col].kind != KIND_DATE) {
+        O3D_ERROR(E_InvalidParameter("Column is not a date"));
+    }
+
+    UInt64 v = m_slots[i];
+
+    Date date;
+    date.year = (UInt32)(v >> 40);
+    date.month = (v >> 32) & 0xff;
+    date.mday = (v >> 24) & 0xff;
+
+    return date;
+}
+
+DateTime MySqlRowBlock::asDateTime(UInt32 row, UInt32 col) const
+{
+    size_t i = index(row, col);
+
+    if (m_columns[col].kind != KIND_DATE) {
+        O3D_ERROR(E_InvalidParameter("Column is not a date"));
+    }
+
+    UInt64 v = m_slots[i];
+
+    DateTime datetime;
+    datetime.year = (UInt32)(v >> 40);
+    datetime.month = (v >> 32) & 0xff;
+    datetime.mday = (v >> 24) & 0xff;
+    datetime.hour = (v >> 16) & 0xff;
+    datetime.minute = (v >> 8) & 0xff;
+    datetime.second = v & 0xff;
+
+    return datetime;
+}
+
+void MySqlRowBlock::reset(UInt32 numColumns)
+{
+    m_numRows = 0;
+
+    m_columns.resize(numColumns);
+    m_slots.clear();
+    m_nulls.clear();
+    m_heap.clear();
+}
+
+void MySqlRowBlock::setColumn(UInt32 col, DbVariable::IntType intType)
+{
+    Column &column = m_columns[col];
+    column.intType = intType;
+
+    switch (intType) {
+    case DbVariable::IT_BOOL:
+    case DbVariable::IT_INT8:
+    case DbVariable::IT_INT16:
+    case DbVariable::IT_INT32:
+    case DbVariable::IT_INT64:
+        column.kind = KIND_INTEGER;
+        break;
+
+    case DbVariable::IT_FLOAT:
+    case DbVariable::IT_DOUBLE:
+        column.kind = KIND_REAL;
+        break;
+
+    case DbVariable::IT_ARRAY_CHAR:
+    case DbVariable::IT_ARRAY_UINT8:
+        column.kind = KIND_DATA;
+        break;
+
+    case DbVariable::IT_DATE:
+    case DbVariable::IT_DATETIME:
+        column.kind = KIND_DATE;
+        break;
+
+    default:
+        O3D_ERROR(E_InvalidParameter("Unsupported column type for a row block"));
+    }
+}
+
+UInt64 *MySqlRowBlock::appendRow()
+{
+    size_t offset = m_slots.size();
+
+    m_slots.resize(offset + m_columns.size());
+    m_nulls.resize(offset + m_columns.size(), 0);
+
+    ++m_numRows;
+
+    return m_slots.data() + offset;
+}
+
+UInt8 *MySqlRowBlock::allocateData(UInt32 length, UInt64 &slot)
+{
+    if (m_heap.size() + length + 1 > 0xffffffff) {
+        O3D_ERROR(E_InvalidOperation("Row block heap is limited to 4GB"));
+    }
+
+    UInt32 offset = (UInt32)m_heap.size();
+
+    m_heap.resize(offset + length + 1);
+    m_heap[offset + length] = 0;
+
+    slot = ((UInt64)length << 32) | offset;
+
+    return m_heap.data() + offset;
+}
+
+//
+// MySqlBatchRange
+//
+
+MySqlBatchRange::MySqlBatchRange(MySqlQuery &query, UInt32 batchSize) :
+    m_query(&query),
+    m_batchSize(batchSize)
+{
+    if (m_batchSize == 0) {
+        O3D_ERROR(E_InvalidParameter("At least one row per batch is required"));
+    }
+}
+
+MySqlBatchRange::Iterator MySqlBatchRange::begin()
+{
+    return Iterator(next() ? this : nullptr);
+}
+
+Bool MySqlBatchRange::next()
+{
+    return m_query->fetchBatch(m_batchSize, m_block) > 0;
+}
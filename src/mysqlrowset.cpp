@@ -0,0 +1,753 @@
+/**
+ * @file mysqlrowset.cpp
+ * @brief Compact immutable client side copy of a result set.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#include "o3d/mysql/mysqlrowset.h"
+#include "o3d/mysql/mysqldb.h"
+
+#include <o3d/core/debug.h>
+
+#include <mysql/mysql.h>
+
+#include <algorithm>
+#include <cstring>
+#include <istream>
+#include <ostream>
+
+using namespace o3d;
+using namespace o3d::mysql;
+
+static inline Bool isReal(UInt32 intType)
+{
+    return intType == DbVariable::IT_FLOAT || intType == DbVariable::IT_DOUBLE;
+}
+
+static inline Bool isInteger(UInt32 intType)
+{
+    return intType == DbVariable::IT_BOOL || intType == DbVariable::IT_INT8 || intType == DbVariable::IT_INT16 ||
+           intType == DbVariable::IT_INT32 || intType == DbVariable::IT_INT64;
+}
+
+static inline Bool isVarLength(UInt32 intType)
+{
+    return intType == DbVariable::IT_ARRAY_CHAR || intType == DbVariable::IT_ARRAY_UINT8;
+}
+
+MySqlRowSet::MySqlRowSet(std::vector<UInt64> &&storage, UInt64 size) :
+    m_storage(std::move(storage)),
+    m_data((const UInt8*)m_storage.data()),
+    m_size(size),
+    m_header(nullptr),
+    m_columns(nullptr),
+    m_rows(nullptr),
+    m_heap(nullptr)
+{
+    init();
+}
+
+MySqlRowSet::MySqlRowSet(const UInt8 *data, UInt64 size, const std::function<void()> &release) :
+    m_data(data),
+    m_size(size),
+    m_header(nullptr),
+    m_columns(nullptr),
+    m_rows(nullptr),
+    m_heap(nullptr)
+{
+    init();
+
+    // only once valid
+    m_release = release;
+}
+
+std::shared_ptr<const MySqlRowSet> MySqlRowSet::fromBuffer(
+        const UInt8 *data,
+        UInt64 size,
+        const std::function<void()> &release)
+{
+    if (((size_t)data & 7) != 0) {
+        if (release) {
+            release();
+        }
+
+        O3D_ERROR(E_InvalidParameter("Rowset buffer must be 8 bytes aligned"));
+    }
+
+    try {
+        return std::shared_ptr<const MySqlRowSet>(new MySqlRowSet(data, size, release));
+    } catch (...) {
+        if (release) {
+            release();
+        }
+
+        throw;
+    }
+}
+
+MySqlRowSet::~MySqlRowSet()
+{
+    if (m_release) {
+        m_release();
+    }
+}
+
+void MySqlRowSet::init()
+{
+    if (m_size < sizeof(Header)) {
+        O3D_ERROR(E_InvalidFormat("Rowset buffer is too small"));
+    }
+
+    m_header = (const Header*)m_data;
+
+    if (m_header->magic != MAGIC || m_header->version != VERSION) {
+        O3D_ERROR(E_InvalidFormat("Invalid rowset buffer"));
+    }
+
+    const UInt64 numColumns = m_header->numColumns;
+    const UInt64 heapSize = m_header->heapSize;
+
+    // each range within the previous one, without overflow
+    if (m_header->heapOffset > m_size || heapSize > m_size - m_header->heapOffset ||
+        m_header->rowsOffset > m_header->heapOffset ||
+        (UInt64)m_header->numRows * m_header->rowSize > m_header->heapOffset - m_header->rowsOffset ||
+        m_header->columnsOffset < sizeof(Header) || (m_header->columnsOffset & 7) != 0 ||
+        m_header->columnsOffset > m_header->rowsOffset ||
+        numColumns * sizeof(ColumnDesc) > m_header->rowsOffset - m_header->columnsOffset ||
+        (UInt64)m_header->nullSize * 8 < numColumns ||
+        (UInt64)m_header->rowSize < m_header->nullSize + numColumns * 8) {
+        O3D_ERROR(E_InvalidFormat("Corrupted rowset buffer"));
+    }
+
+    m_columns = (const ColumnDesc*)(m_data + m_header->columnsOffset);
+    m_rows = m_data + m_header->rowsOffset;
+    m_heap = m_data + m_header->heapOffset;
+
+    // the names and the values in the heap, zero terminated, so never read out of the buffer
+    auto inHeap = [this, heapSize] (UInt32 offset, UInt32 length) {
+        return (UInt64)offset + length < heapSize && m_heap[(UInt64)offset + length] == 0;
+    };
+
+    std::vector<UInt32> varLengths;
+
+    for (UInt32 i = 0; i < numColumns; ++i) {
+        if (!inHeap(m_columns[i].nameOffset, m_columns[i].nameLength)) {
+            O3D_ERROR(E_InvalidFormat("Corrupted rowset column name"));
+        }
+
+        if (isVarLength(m_columns[i].intType)) {
+            varLengths.push_back(i);
+        }
+    }
+
+    if (!varLengths.empty()) {
+        for (UInt32 row = 0; row < m_header->numRows; ++row) {
+            const UInt8 *ptr = rowPtr(row);
+
+            for (UInt32 col : varLengths) {
+                if ((ptr[col >> 3] >> (col & 7)) & 1) {
+                    continue;
+                }
+
+                UInt32 offset, len;
+                memcpy(&offset, ptr + m_header->nullSize + col * 8, 4);
+                memcpy(&len, ptr + m_header->nullSize + col * 8 + 4, 4);
+
+                if (!inHeap(offset, len)) {
+                    O3D_ERROR(E_InvalidFormat(String("Corrupted rowset value at row ") << row));
+                }
+            }
+        }
+    }
+
+    m_columnNames.clear();
+    for (UInt32 i = 0; i < numColumns; ++i) {
+        m_columnNames.insert(std::make_pair(getColumnName(i), i));
+    }
+}
+
+CString MySqlRowSet::getColumnName(UInt32 col) const
+{
+    if (col >= m_header->numColumns) {
+        O3D_ERROR(E_IndexOutOfRange("Column index"));
+    }
+
+    return CString((const Char*)m_heap + m_columns[col].nameOffset, m_columns[col].nameLength);
+}
+
+DbVariable::IntType MySqlRowSet::getColumnType(UInt32 col) const
+{
+    if (col >= m_header->numColumns) {
+        O3D_ERROR(E_IndexOutOfRange("Column index"));
+    }
+
+    return (DbVariable::IntType)m_columns[col].intType;
+}
+
+DbVariable::VarType MySqlRowSet::getColumnVarType(UInt32 col) const
+{
+    if (col >= m_header->numColumns) {
+        O3D_ERROR(E_IndexOutOfRange("Column index"));
+    }
+
+    return (DbVariable::VarType)m_columns[col].varType;
+}
+
+UInt32 MySqlRowSet::getColumnDecimals(UInt32 col) const
+{
+    if (col >= m_header->numColumns) {
+        O3D_ERROR(E_IndexOutOfRange("Column index"));
+    }
+
+    return m_columns[col].decimals;
+}
+
+UInt32 MySqlRowSet::getColumnIndex(const CString &name) const
+{
+    auto it = m_columnNames.find(name);
+    if (it != m_columnNames.end()) {
+        return it->second;
+    } else {
+        O3D_ERROR(E_InvalidParameter(o3d::String("Unknown column name ") + name));
+    }
+}
+
+const UInt8 *MySqlRowSet::slot(UInt32 row, UInt32 col) const
+{
+    if (row >= m_header->numRows) {
+        O3D_ERROR(E_IndexOutOfRange("Row number"));
+    }
+
+    if (col >= m_header->numColumns) {
+        O3D_ERROR(E_IndexOutOfRange("Column index"));
+    }
+
+    return rowPtr(row) + m_header->nullSize + col * 8;
+}
+
+Bool MySqlRowSet::isNull(UInt32 row, UInt32 col) const
+{
+    if (row >= m_header->numRows) {
+        O3D_ERROR(E_IndexOutOfRange("Row number"));
+    }
+
+    if (col >= m_header->numColumns) {
+        O3D_ERROR(E_IndexOutOfRange("Column index"));
+    }
+
+    return (rowPtr(row)[col >> 3] >> (col & 7)) & 1;
+}
+
+Int64 MySqlRowSet::asInt64(UInt32 row, UInt32 col) const
+{
+    const UInt8 *ptr = slot(row, col);
+    UInt32 intType = m_columns[col].intType;
+
+    if (isInteger(intType)) {
+        Int64 v;
+        memcpy(&v, ptr, 8);
+        return v;
+    } else if (isReal(intType)) {
+        Double v;
+        memcpy(&v, ptr, 8);
+        return (Int64)v;
+    } else {
+        O3D_ERROR(E_InvalidParameter("Column is not numeric"));
+    }
+}
+
+UInt64 MySqlRowSet::asUInt64(UInt32 row, UInt32 col) const
+{
+    return (UInt64)asInt64(row, col);
+}
+
+Double MySqlRowSet::asDouble(UInt32 row, UInt32 col) const
+{
+    const UInt8 *ptr = slot(row, col);
+    UInt32 intType = m_columns[col].intType;
+
+    if (isReal(intType)) {
+        Double v;
+        memcpy(&v, ptr, 8);
+        return v;
+    } else if (isInteger(intType)) {
+        Int64 v;
+        memcpy(&v, ptr, 8);
+        return (Double)v;
+    } else {
+        O3D_ERROR(E_InvalidParameter("Column is not numeric"));
+    }
+}
+
+const UInt8 *MySqlRowSet::getData(UInt32 row, UInt32 col, UInt32 *length) const
+{
+    const UInt8 *ptr = slot(row, col);
+
+    if (!isVarLength(m_columns[col].intType)) {
+        O3D_ERROR(E_InvalidParameter("Column is not a string or a blob"));
+    }
+
+    if (isNull(row, col)) {
+        if (length) {
+            *length = 0;
+        }
+
+        return nullptr;
+    }
+
+    UInt32 offset, len;
+    memcpy(&offset, ptr, 4);
+    memcpy(&len, ptr + 4, 4);
+
+    if (length) {
+        *length = len;
+    }
+
+    return m_heap + offset;
+}
+
+Date MySqlRowSet::asDate(UInt32 row, UInt32 col) const
+{
+    const UInt8 *ptr = slot(row, col);
+    UInt32 intType = m_columns[col].intType;
+
+    if (intType != DbVariable::IT_DATE && intType != DbVariable::IT_DATETIME) {
+        O3D_ERROR(E_InvalidParameter("Column is not a date"));
+    }
+
+    UInt64 v;
+    memcpy(&v, ptr, 8);
+
+    Date date;
+    date.year = (UInt32)(v >> 40);
+    date.month = (v >> 32) & 0xff;
+    date.mday = (v >> 24) & 0xff;
+
+    return date;
+}
+
+DateTime MySqlRowSet::asDateTime(UInt32 row, UInt32 col) const
+{
+    const UInt8 *ptr = slot(row, col);
+    UInt32 intType = m_columns[col].intType;
+
+    if (intType != DbVariable::IT_DATE && intType != DbVariable::IT_DATETIME) {
+        O3D_ERROR(E_InvalidParameter("Column is not a date"));
+    }
+
+    UInt64 v;
+    memcpy(&v, ptr, 8);
+
+    DateTime datetime;
+    datetime.year = (UInt32)(v >> 40);
+    datetime.month = (v >> 32) & 0xff;
+    datetime.mday = (v >> 24) & 0xff;
+    datetime.hour = (v >> 16) & 0xff;
+    datetime.minute = (v >> 8) & 0xff;
+    datetime.second = v & 0xff;
+
+    return datetime;
+}
+
+//
+// MySqlRowSetBuilder
+//
+
+//! Rows and heap kept in memory before a write, in stream mode.
+static const size_t STREAM_FLUSH_SIZE = 1024 * 1024;
+
+MySqlRowSetBuilder::MySqlRowSetBuilder() :
+    m_numRows(0),
+    m_rowSize(0),
+    m_nullSize(0),
+    m_out(nullptr),
+    m_heapOut(nullptr),
+    m_streamStart(0),
+    m_streamStarted(False),
+    m_flushedRows(0),
+    m_flushedHeap(0)
+{
+
+}
+
+void MySqlRowSetBuilder::addColumn(
+        const CString &name,
+        DbVariable::IntType intType,
+        DbVariable::VarType varType,
+        UInt32 decimals)
+{
+    if (m_numRows > 0) {
+        O3D_ERROR(E_InvalidOperation("Columns must be declared before the first row"));
+    }
+
+    Column column;
+    column.name = name;
+    column.intType = intType;
+    column.varType = varType;
+    column.decimals = decimals;
+
+    m_columns.push_back(column);
+
+    // null bitmap padded to 8 bytes, followed by a slot of 8 bytes per column
+    m_nullSize = (((UInt32)m_columns.size() + 7) / 8 + 7) & ~7;
+    m_rowSize = m_nullSize + (UInt32)m_columns.size() * 8;
+}
+
+void MySqlRowSetBuilder::beginRow()
+{
+    if (m_out) {
+        if (!m_streamStarted) {
+            // header and columns reserved, written once the rows are known
+            MySqlRowSet::Header header;
+            std::vector<MySqlRowSet::ColumnDesc> columns;
+            layout(header, columns);
+
+            m_heap.clear();
+
+            std::vector<Char> reserved((size_t)header.rowsOffset, 0);
+            m_out->write(reserved.data(), (std::streamsize)reserved.size());
+
+            m_streamStarted = True;
+        }
+
+        // the previous rows are complete
+        if (m_rows.size() + m_heap.size() >= STREAM_FLUSH_SIZE) {
+            flushStream();
+        }
+    }
+
+    size_t offset = m_rows.size();
+    m_rows.resize(offset + m_rowSize, 0);
+
+    // every value is null until set
+    memset(m_rows.data() + offset, 0xff, m_nullSize);
+
+    ++m_numRows;
+}
+
+UInt8 *MySqlRowSetBuilder::lastSlot(UInt32 col)
+{
+    if (m_numRows == 0) {
+        O3D_ERROR(E_InvalidOperation("No row, beginRow must be called before"));
+    }
+
+    if (col >= m_columns.size()) {
+        O3D_ERROR(E_IndexOutOfRange("Column index"));
+    }
+
+    UInt8 *row = m_rows.data() + (size_t)(m_numRows - 1 - m_flushedRows) * m_rowSize;
+
+    // not null
+    row[col >> 3] &= ~(1 << (col & 7));
+
+    return row + m_nullSize + col * 8;
+}
+
+UInt32 MySqlRowSetBuilder::pushHeap(const void *data, UInt32 length)
+{
+    if (m_flushedHeap + m_heap.size() + length + 1 > 0xffffffff) {
+        O3D_ERROR(E_InvalidOperation("Rowset heap is limited to 4GB"));
+    }
+
+    size_t pos = m_heap.size();
+
+    // with a terminal zero
+    m_heap.resize(pos + length + 1);
+    if (length > 0) {
+        memcpy(m_heap.data() + pos, data, length);
+    }
+    m_heap[pos + length] = 0;
+
+    // relative to the whole heap, in stream mode too
+    return (UInt32)(m_flushedHeap + pos);
+}
+
+void MySqlRowSetBuilder::setData(UInt32 col, const void *data, UInt32 length)
+{
+    if (col < m_columns.size() && !isVarLength(m_columns[col].intType)) {
+        O3D_ERROR(E_InvalidParameter("Column is not a string or a blob"));
+    }
+
+    UInt32 offset = pushHeap(data, length);
+    UInt8 *ptr = lastSlot(col);
+
+    memcpy(ptr, &offset, 4);
+    memcpy(ptr + 4, &length, 4);
+}
+
+void MySqlRowSetBuilder::setValue(UInt32 col, const DbVariable &var)
+{
+    if (var.isNull()) {
+        return;
+    }
+
+    if (col < m_columns.size() && var.getIntType() != m_columns[col].intType) {
+        O3D_ERROR(E_InvalidParameter("Variable type differs from the column type"));
+    }
+
+    const UInt8 *object = var.getObjectPtr();
+
+    switch (var.getIntType()) {
+    case DbVariable::IT_ARRAY_CHAR:
+        setData(col, ((const ArrayChar*)var.getObject())->getData(), var.getLength());
+        return;
+
+    case DbVariable::IT_ARRAY_UINT8:
+        setData(col, ((const ArrayUInt8*)var.getObject())->getData(), var.getLength());
+        return;
+
+    default:
+        break;
+    }
+
+    Int64 i64 = 0;
+    Double f64 = 0;
+    UInt64 u64 = 0;
+
+    UInt8 *ptr = lastSlot(col);
+
+    switch (var.getIntType()) {
+    case DbVariable::IT_BOOL:
+        i64 = *(const Bool*)object ? 1 : 0;
+        memcpy(ptr, &i64, 8);
+        break;
+
+    case DbVariable::IT_INT8:
+        if (var.getType() == DbVariable::UINT8) {
+            i64 = *(const UInt8*)object;
+        } else {
+            i64 = *(const Int8*)object;
+        }
+        memcpy(ptr, &i64, 8);
+        break;
+
+    case DbVariable::IT_INT16:
+        if (var.getType() == DbVariable::UINT16) {
+            i64 = *(const UInt16*)object;
+        } else {
+            i64 = *(const Int16*)object;
+        }
+        memcpy(ptr, &i64, 8);
+        break;
+
+    case DbVariable::IT_INT32:
+        if (var.getType() == DbVariable::UINT32) {
+            i64 = *(const UInt32*)object;
+        } else {
+            i64 = *(const Int32*)object;
+        }
+        memcpy(ptr, &i64, 8);
+        break;
+
+    case DbVariable::IT_INT64:
+        memcpy(ptr, object, 8);
+        break;
+
+    case DbVariable::IT_FLOAT:
+        f64 = *(const Float*)object;
+        memcpy(ptr, &f64, 8);
+        break;
+
+    case DbVariable::IT_DOUBLE:
+        memcpy(ptr, object, 8);
+        break;
+
+    case DbVariable::IT_DATE:
+    case DbVariable::IT_DATETIME:
+        u64 = MySqlQuery::packTime(*(const MYSQL_TIME*)object);
+        memcpy(ptr, &u64, 8);
+        break;
+
+    default:
+        O3D_ERROR(E_InvalidParameter("Unsupported variable type"));
+    }
+}
+
+void MySqlRowSetBuilder::layout(MySqlRowSet::Header &header, std::vector<MySqlRowSet::ColumnDesc> &columns)
+{
+    typedef MySqlRowSet::Header Header;
+    typedef MySqlRowSet::ColumnDesc ColumnDesc;
+
+    // column names at the end of the heap
+    columns.resize(m_columns.size());
+    for (size_t i = 0; i < m_columns.size(); ++i) {
+        columns[i].intType = m_columns[i].intType;
+        columns[i].varType = m_columns[i].varType;
+        columns[i].decimals = m_columns[i].decimals;
+        columns[i].reserved = 0;
+        columns[i].nameLength = (UInt32)m_columns[i].name.length();
+        columns[i].nameOffset = pushHeap(m_columns[i].name.getData(), columns[i].nameLength);
+    }
+
+    memset(&header, 0, sizeof(Header));
+
+    header.magic = MySqlRowSet::MAGIC;
+    header.version = MySqlRowSet::VERSION;
+    header.numRows = m_numRows;
+    header.numColumns = (UInt32)m_columns.size();
+    header.rowSize = m_rowSize;
+    header.nullSize = m_nullSize;
+    header.columnsOffset = (sizeof(Header) + 7) & ~7;
+    header.rowsOffset = (header.columnsOffset + columns.size() * sizeof(ColumnDesc) + 7) & ~7;
+    header.heapOffset = header.rowsOffset + (UInt64)m_numRows * m_rowSize;
+    header.heapSize = m_flushedHeap + m_heap.size();
+}
+
+std::shared_ptr<const MySqlRowSet> MySqlRowSetBuilder::build()
+{
+    typedef MySqlRowSet::Header Header;
+    typedef MySqlRowSet::ColumnDesc ColumnDesc;
+
+    if (m_out) {
+        O3D_ERROR(E_InvalidOperation("Rowset is in stream mode, completed by endStream"));
+    }
+
+    Header header;
+    std::vector<ColumnDesc> columns;
+    layout(header, columns);
+
+    UInt64 size = header.heapOffset + header.heapSize;
+
+    // 8 bytes aligned storage
+    std::vector<UInt64> storage((size_t)((size + 7) / 8), 0);
+    UInt8 *data = (UInt8*)storage.data();
+
+    memcpy(data, &header, sizeof(Header));
+
+    if (!columns.empty()) {
+        memcpy(data + header.columnsOffset, columns.data(), columns.size() * sizeof(ColumnDesc));
+    }
+
+    if (!m_rows.empty()) {
+        memcpy(data + header.rowsOffset, m_rows.data(), m_rows.size());
+    }
+
+    if (!m_heap.empty()) {
+        memcpy(data + header.heapOffset, m_heap.data(), m_heap.size());
+    }
+
+    clear();
+
+    return std::shared_ptr<const MySqlRowSet>(new MySqlRowSet(std::move(storage), size));
+}
+
+void MySqlRowSetBuilder::beginStream(std::ostream &out, std::iostream &heap)
+{
+    if (m_numRows > 0) {
+        O3D_ERROR(E_InvalidOperation("Stream mode must be set before the first row"));
+    }
+
+    m_out = &out;
+    m_heapOut = &heap;
+    m_streamStart = (UInt64)out.tellp();
+    m_streamStarted = False;
+    m_flushedRows = 0;
+    m_flushedHeap = 0;
+}
+
+void MySqlRowSetBuilder::flushStream()
+{
+    if (!m_rows.empty()) {
+        m_out->write((const char*)m_rows.data(), (std::streamsize)m_rows.size());
+        m_flushedRows = m_numRows;
+        m_rows.clear();
+    }
+
+    if (!m_heap.empty()) {
+        m_heapOut->write((const char*)m_heap.data(), (std::streamsize)m_heap.size());
+        m_flushedHeap += m_heap.size();
+        m_heap.clear();
+    }
+
+    if (!*m_out || !*m_heapOut) {
+        O3D_ERROR(E_InvalidResult("Unable to write the rowset stream"));
+    }
+}
+
+UInt64 MySqlRowSetBuilder::endStream()
+{
+    typedef MySqlRowSet::Header Header;
+    typedef MySqlRowSet::ColumnDesc ColumnDesc;
+
+    if (!m_out) {
+        O3D_ERROR(E_InvalidOperation("Rowset is not in stream mode"));
+    }
+
+    if (!m_streamStarted) {
+        Header header;
+        std::vector<ColumnDesc> columns;
+        layout(header, columns);
+
+        m_heap.clear();
+
+        std::vector<Char> reserved((size_t)header.rowsOffset, 0);
+        m_out->write(reserved.data(), (std::streamsize)reserved.size());
+    }
+
+    flushStream();
+
+    // the heap after the rows, by blocks
+    m_heapOut->flush();
+    m_heapOut->seekg(0);
+
+    std::vector<Char> block(64 * 1024);
+    UInt64 remaining = m_flushedHeap;
+
+    while (remaining > 0) {
+        std::streamsize n = (std::streamsize)std::min<UInt64>(remaining, block.size());
+        if (!m_heapOut->read(block.data(), n)) {
+            O3D_ERROR(E_InvalidResult("Unable to read the rowset heap stream"));
+        }
+
+        m_out->write(block.data(), n);
+        remaining -= (UInt64)n;
+    }
+
+    // then the names, ending the heap
+    Header header;
+    std::vector<ColumnDesc> columns;
+    layout(header, columns);
+
+    m_out->write((const char*)m_heap.data(), (std::streamsize)m_heap.size());
+
+    UInt64 end = (UInt64)m_out->tellp();
+
+    m_out->seekp((std::streamoff)m_streamStart);
+    m_out->write((const char*)&header, sizeof(Header));
+
+    if (!columns.empty()) {
+        m_out->seekp((std::streamoff)(m_streamStart + header.columnsOffset));
+        m_out->write((const char*)columns.data(), (std::streamsize)(columns.size() * sizeof(ColumnDesc)));
+    }
+
+    m_out->seekp((std::streamoff)end);
+
+    if (!*m_out) {
+        O3D_ERROR(E_InvalidResult("Unable to write the rowset stream"));
+    }
+
+    clear();
+
+    return header.heapOffset + header.heapSize;
+}
+
+void MySqlRowSetBuilder::clear()
+{
+    m_columns.clear();
+    m_rows.clear();
+    m_heap.clear();
+
+    m_numRows = 0;
+    m_rowSize = 0;
+    m_nullSize = 0;
+
+    m_out = nullptr;
+    m_heapOut = nullptr;
+    m_streamStart = 0;
+    m_streamStarted = False;
+    m_flushedRows = 0;
+    m_flushedHeap = 0;
+}
@@ -0,0 +1,603 @@
+/**
+ * @file mysqlshardeddb.cpp
+ * @brief Hash sharded database over many MySqlDb.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#include "o3d/mysql/mysqlshardeddb.h"
+#include "o3d/mysql/mysqlexception.h"
+
+#include <algorithm>
+
+using namespace o3d;
+using namespace o3d::mysql;
+
+MySqlShardedDb::MySqlShardedDb() :
+    Database(),
+    m_workerPool(nullptr)
+{
+
+}
+
+MySqlShardedDb::~MySqlShardedDb()
+{
+    deletePtr(m_workerPool);
+
+    disconnect();
+
+    for (MySqlDb *&shard : m_shards) {
+        deletePtr(shard);
+    }
+}
+
+Bool MySqlShardedDb::connect(
+        const String &host,
+        UInt32 port,
+        const String &database,
+        const String &user,
+        const String &password,
+        Bool keepPassord)
+{
+    m_host = host;
+    m_database = database;
+    m_user = user;
+
+    if (keepPassord) {
+        m_password = password;
+    }
+
+    MySqlDb *shard = new MySqlDb();
+
+    try {
+        shard->connect(host, port, database, user, password, keepPassord);
+    } catch (E_BaseException &) {
+        deletePtr(shard);
+        throw;
+    }
+
+    addShard(shard);
+    m_isConnected = True;
+
+    return True;
+}
+
+void MySqlShardedDb::disconnect()
+{
+    m_isConnected = False;
+
+    for (MySqlDb *shard : m_shards) {
+        shard->disconnect();
+    }
+}
+
+void MySqlShardedDb::pingConnection()
+{
+    for (MySqlDb *shard : m_shards) {
+        shard->pingConnection();
+    }
+}
+
+void MySqlShardedDb::addShard(const String &host, UInt32 port)
+{
+    if (!m_isConnected) {
+        O3D_ERROR(E_InvalidOperation("The first shard must be connected before adding another"));
+    }
+
+    MySqlDb *shard = new MySqlDb();
+
+    try {
+        shard->connect(host, port, m_database, m_user, m_password, m_shards[0]->getConnectOptions());
+    } catch (E_BaseException &) {
+        deletePtr(shard);
+        throw;
+    }
+
+    addShard(shard);
+}
+
+void MySqlShardedDb::addShard(MySqlDb *shard)
+{
+    if (!shard) {
+        O3D_ERROR(E_InvalidParameter("Shard must be valid"));
+    }
+
+    m_shards.push_back(shard);
+}
+
+MySqlDb *MySqlShardedDb::getShard(UInt32 index)
+{
+    if (index >= m_shards.size()) {
+        O3D_ERROR(E_IndexOutOfRange("Shard index"));
+    }
+
+    return m_shards[index];
+}
+
+DbQuery *MySqlShardedDb::registerShardedQuery(const String &name, const CString &query, UInt32 shardKey)
+{
+    // always created by our newDbQuery
+    MySqlShardedQuery *shardedQuery = static_cast<MySqlShardedQuery*>(registerQuery(name, query));
+    if (shardedQuery) {
+        shardedQuery->setShardKey(shardKey);
+    }
+
+    return shardedQuery;
+}
+
+DbQuery *MySqlShardedDb::newDbQuery(const String &name, const CString &query)
+{
+    return new MySqlShardedQuery(this, name, query, MySqlShardedQuery::NO_SHARD_KEY);
+}
+
+MySqlWorkerPool *MySqlShardedDb::workerPool()
+{
+    if (!m_workerPool || m_workerPool->getNumThreads() < m_shards.size()) {
+        deletePtr(m_workerPool);
+        m_workerPool = new MySqlWorkerPool((UInt32)m_shards.size());
+    }
+
+    return m_workerPool;
+}
+
+//
+// MySqlShardedQuery
+//
+
+// Compare an output value of two queries. Null values are lesser.
+static Int32 compareVariables(const MySqlQuery &qa, const MySqlQuery &qb, UInt32 attr)
+{
+    const DbVariable &a = qa.getOut(attr);
+    const DbVariable &b = qb.getOut(attr);
+
+    if (a.isNull() || b.isNull()) {
+        return (b.isNull() ? 0 : -1) + (a.isNull() ? 0 : 1);
+    }
+
+    switch (a.getIntType()) {
+    case DbVariable::IT_BOOL:
+    case DbVariable::IT_INT8:
+    case DbVariable::IT_INT16:
+    case DbVariable::IT_INT32:
+    case DbVariable::IT_INT64:
+        if (a.getType() == DbVariable::UINT32 || a.getType() == DbVariable::UINT64) {
+            UInt64 x = a.asUInt64(), y = b.asUInt64();
+            return x < y ? -1 : (x > y ? 1 : 0);
+        } else {
+            Int64 x = a.asInt64(), y = b.asInt64();
+            return x < y ? -1 : (x > y ? 1 : 0);
+        }
+
+    case DbVariable::IT_FLOAT:
+    case DbVariable::IT_DOUBLE:
+    {
+        Double x = a.asDouble(), y = b.asDouble();
+        return x < y ? -1 : (x > y ? 1 : 0);
+    }
+
+    case DbVariable::IT_ARRAY_CHAR:
+    case DbVariable::IT_ARRAY_UINT8:
+    {
+        // binary comparison of the fetched data, clamped to the bound buffer or from the arena
+        UInt32 lenA = 0, lenB = 0;
+        const UInt8 *dataA = qa.getOutData(attr, lenA);
+        const UInt8 *dataB = qb.getOutData(attr, lenB);
+
+        Int32 r = std::min(lenA, lenB) > 0 ? memcmp(dataA, dataB, std::min(lenA, lenB)) : 0;
+
+        if (r != 0) {
+            return r < 0 ? -1 : 1;
+        }
+
+        return lenA < lenB ? -1 : (lenA > lenB ? 1 : 0);
+    }
+
+    case DbVariable::IT_DATE:
+    case DbVariable::IT_DATETIME:
+    {
+        const MYSQL_TIME *x = (const MYSQL_TIME*)const_cast<DbVariable&>(a).getObjectPtr();
+        const MYSQL_TIME *y = (const MYSQL_TIME*)const_cast<DbVariable&>(b).getObjectPtr();
+
+        UInt64 vx[2] = { MySqlQuery::packTime(*x), (UInt64)x->second_part };
+        UInt64 vy[2] = { MySqlQuery::packTime(*y), (UInt64)y->second_part };
+
+        if (vx[0] != vy[0]) {
+            return vx[0] < vy[0] ? -1 : 1;
+        }
+
+        return vx[1] < vy[1] ? -1 : (vx[1] > vy[1] ? 1 : 0);
+    }
+
+    default:
+        return 0;
+    }
+}
+
+MySqlShardedQuery::MySqlShardedQuery(
+        MySqlShardedDb *shardedDb,
+        const String &name,
+        const CString &query,
+        UInt32 shardKey) :
+    m_shardedDb(shardedDb),
+    m_name(name),
+    m_query(query),
+    m_shardKey(shardKey),
+    m_paramsVersion(1),
+    m_orderAttr(0),
+    m_descending(False),
+    m_limit(0),
+    m_targetShard(-1),
+    m_numRows(0),
+    m_currRow(0),
+    m_currentShard(-1),
+    m_cursor(0),
+    m_mergeStarted(False)
+{
+
+}
+
+MySqlShardedQuery::~MySqlShardedQuery()
+{
+    // shard queries are owned by their database
+}
+
+void MySqlShardedQuery::setMergeOrder(const CString &column, Bool descending)
+{
+    m_orderColumn = column;
+    m_descending = descending;
+}
+
+void MySqlShardedQuery::setArrayUInt8(UInt32 attr, const ArrayUInt8 &v)
+{
+    m_params.setArrayUInt8(attr, v);
+    ++m_paramsVersion;
+}
+
+void MySqlShardedQuery::setSmartArrayUInt8(UInt32 attr, const SmartArrayUInt8 &v)
+{
+    m_params.setSmartArrayUInt8(attr, v);
+    ++m_paramsVersion;
+}
+
+void MySqlShardedQuery::setInStream(UInt32 attr, const InStream &v)
+{
+    O3D_ERROR(E_InvalidOperation("Not supported by sharded queries"));
+}
+
+void MySqlShardedQuery::setBool(UInt32 attr, Bool v)
+{
+    m_params.setBool(attr, v);
+    ++m_paramsVersion;
+}
+
+void MySqlShardedQuery::setInt32(UInt32 attr, Int32 v)
+{
+    m_params.setInt32(attr, v);
+    ++m_paramsVersion;
+}
+
+void MySqlShardedQuery::setUInt32(UInt32 attr, UInt32 v)
+{
+    m_params.setUInt32(attr, v);
+    ++m_paramsVersion;
+}
+
+void MySqlShardedQuery::setInt64(UInt32 attr, Int64 v)
+{
+    m_params.setInt64(attr, v);
+    ++m_paramsVersion;
+}
+
+void MySqlShardedQuery::setUInt64(UInt32 attr, UInt64 v)
+{
+    m_params.setUInt64(attr, v);
+    ++m_paramsVersion;
+}
+
+void MySqlShardedQuery::setFloat(UInt32 attr, Float v)
+{
+    m_params.setFloat(attr, v);
+    ++m_paramsVersion;
+}
+
+void MySqlShardedQuery::setDouble(UInt32 attr, Double v)
+{
+    m_params.setDouble(attr, v);
+    ++m_paramsVersion;
+}
+
+void MySqlShardedQuery::setCString(UInt32 attr, const CString &v)
+{
+    m_params.setCString(attr, v);
+    ++m_paramsVersion;
+}
+
+void MySqlShardedQuery::setDate(UInt32 attr, const Date &date)
+{
+    m_params.setDate(attr, date);
+    ++m_paramsVersion;
+}
+
+void MySqlShardedQuery::setTimestamp(UInt32 attr, const DateTime &date)
+{
+    m_params.setTimestamp(attr, date);
+    ++m_paramsVersion;
+}
+
+UInt32 MySqlShardedQuery::getOutAttr(const CString &name)
+{
+    // same schema on every shard
+    return shardQuery(0)->getOutAttr(name);
+}
+
+const DbVariable &MySqlShardedQuery::getOut(const CString &name) const
+{
+    return current()->getOut(name);
+}
+
+const DbVariable &MySqlShardedQuery::getOut(UInt32 attr) const
+{
+    return current()->getOut(attr);
+}
+
+void MySqlShardedQuery::execute()
+{
+    run(False);
+}
+
+void MySqlShardedQuery::update()
+{
+    run(True);
+}
+
+UInt32 MySqlShardedQuery::getNumRows()
+{
+    return m_numRows;
+}
+
+UInt64 MySqlShardedQuery::getGeneratedKey() const
+{
+    if (m_targetShard < 0) {
+        O3D_ERROR(E_InvalidOperation("Generated key is only available for a query with shard key"));
+    }
+
+    return m_shardQueries[m_targetShard]->getGeneratedKey();
+}
+
+Bool MySqlShardedQuery::fetch()
+{
+    if (m_limit && m_currRow >= m_limit) {
+        m_currentShard = -1;
+        return False;
+    }
+
+    // single shard
+    if (m_targetShard >= 0) {
+        if (m_shardQueries[m_targetShard]->fetch()) {
+            m_currentShard = m_targetShard;
+            ++m_currRow;
+            return True;
+        }
+
+        m_currentShard = -1;
+        return False;
+    }
+
+    const UInt32 numShards = (UInt32)m_shardQueries.size();
+
+    // unordered merge, shard after shard
+    if (m_orderColumn.isEmpty()) {
+        while (m_cursor < numShards) {
+            if (m_shardQueries[m_cursor]->fetch()) {
+                m_currentShard = (Int32)m_cursor;
+                ++m_currRow;
+                return True;
+            }
+
+            ++m_cursor;
+        }
+
+        m_currentShard = -1;
+        return False;
+    }
+
+    // ordered merge, advance only the shard of the previous row
+    if (!m_mergeStarted) {
+        m_mergeStarted = True;
+        for (UInt32 i = 0; i < numShards; ++i) {
+            m_hasRow[i] = m_shardQueries[i]->fetch();
+        }
+    } else if (m_currentShard >= 0) {
+        m_hasRow[m_currentShard] = m_shardQueries[m_currentShard]->fetch();
+    }
+
+    Int32 best = -1;
+    for (UInt32 i = 0; i < numShards; ++i) {
+        if (m_hasRow[i] && (best < 0 || compareShards(i, (UInt32)best) < 0)) {
+            best = (Int32)i;
+        }
+    }
+
+    m_currentShard = best;
+    if (best < 0) {
+        return False;
+    }
+
+    ++m_currRow;
+    return True;
+}
+
+UInt32 MySqlShardedQuery::tellRow()
+{
+    return m_currRow;
+}
+
+void MySqlShardedQuery::seekRow(UInt32 row)
+{
+    if (m_targetShard >= 0) {
+        m_shardQueries[m_targetShard]->seekRow(row);
+        m_currRow = row;
+        return;
+    }
+
+    if (row != 0) {
+        O3D_ERROR(E_InvalidOperation("Merged results only support seek 0"));
+    }
+
+    for (DbQuery *query : m_shardQueries) {
+        if (query->getNumRows() > 0) {
+            query->seekRow(0);
+        }
+    }
+
+    m_currRow = 0;
+    m_currentShard = -1;
+    m_cursor = 0;
+    m_mergeStarted = False;
+}
+
+void MySqlShardedQuery::unbind()
+{
+    m_params.clear();
+    ++m_paramsVersion;
+
+    for (DbQuery *query : m_shardQueries) {
+        if (query) {
+            query->unbind();
+        }
+    }
+}
+
+DbQuery *MySqlShardedQuery::shardQuery(UInt32 shard)
+{
+    if (shard >= m_shardedDb->m_shards.size()) {
+        O3D_ERROR(E_IndexOutOfRange("Shard index"));
+    }
+
+    if (shard >= m_shardQueries.size()) {
+        m_shardQueries.resize(m_shardedDb->m_shards.size(), nullptr);
+        m_shardVersions.resize(m_shardedDb->m_shards.size(), 0);
+    }
+
+    if (!m_shardQueries[shard]) {
+        m_shardQueries[shard] = m_shardedDb->m_shards[shard]->registerQuery(m_name, m_query);
+    }
+
+    return m_shardQueries[shard];
+}
+
+DbQuery *MySqlShardedQuery::boundShardQuery(UInt32 shard)
+{
+    DbQuery *query = shardQuery(shard);
+
+    // replay the inputs only if they changed since the last run on this shard
+    if (m_shardVersions[shard] != m_paramsVersion) {
+        m_params.apply(*query);
+        m_shardVersions[shard] = m_paramsVersion;
+    }
+
+    return query;
+}
+
+void MySqlShardedQuery::run(Bool update)
+{
+    const UInt32 numShards = m_shardedDb->getNumShards();
+    if (numShards == 0) {
+        O3D_ERROR(E_InvalidOperation("No shard"));
+    }
+
+    m_numRows = 0;
+    m_currRow = 0;
+    m_currentShard = -1;
+    m_cursor = 0;
+    m_mergeStarted = False;
+
+    // routed by key
+    if (m_shardKey != NO_SHARD_KEY) {
+        UInt32 shard = m_shardedDb->getShardIndex(m_params.hash(m_shardKey));
+        DbQuery *query = boundShardQuery(shard);
+
+        m_targetShard = (Int32)shard;
+
+        if (update) {
+            query->update();
+        } else {
+            query->execute();
+        }
+
+        m_numRows = query->getNumRows();
+        return;
+    }
+
+    // scatter on every shard, the inputs are bound before starting the threads
+    m_targetShard = -1;
+
+    for (UInt32 i = 0; i < numShards; ++i) {
+        boundShardQuery(i);
+    }
+
+    if (numShards == 1) {
+        if (update) {
+            m_shardQueries[0]->update();
+        } else {
+            m_shardQueries[0]->execute();
+        }
+    } else {
+        MySqlWorkerPool *workerPool = m_shardedDb->workerPool();
+
+        std::vector<std::future<void>> futures;
+        futures.reserve(numShards);
+
+        for (UInt32 i = 0; i < numShards; ++i) {
+            DbQuery *query = m_shardQueries[i];
+
+            futures.push_back(workerPool->submit([query, update] () {
+                if (update) {
+                    query->update();
+                } else {
+                    query->execute();
+                }
+            }));
+        }
+
+        MySqlWorkerPool::waitAll(futures);
+    }
+
+    // gather
+    for (UInt32 i = 0; i < numShards; ++i) {
+        m_numRows += m_shardQueries[i]->getNumRows();
+    }
+
+    if (!update) {
+        if (m_limit && m_numRows > m_limit) {
+            m_numRows = m_limit;
+        }
+
+        if (!m_orderColumn.isEmpty()) {
+            m_orderAttr = m_shardQueries[0]->getOutAttr(m_orderColumn);
+            m_hasRow.assign(numShards, 0);
+        }
+    }
+}
+
+Int32 MySqlShardedQuery::compareShards(UInt32 a, UInt32 b) const
+{
+    // the shards being MySqlDb, their queries are MySqlQuery
+    Int32 r = compareVariables(
+                  *static_cast<const MySqlQuery*>(m_shardQueries[a]),
+                  *static_cast<const MySqlQuery*>(m_shardQueries[b]),
+                  m_orderAttr);
+
+    return m_descending ? -r : r;
+}
+
+DbQuery *MySqlShardedQuery::current() const
+{
+    if (m_currentShard < 0) {
+        O3D_ERROR(E_InvalidOperation("No current row"));
+    }
+
+    return m_shardQueries[m_currentShard];
+}
@@ -0,0 +1,134 @@
+/**
+ * @file mysqlsingleflight.cpp
+ * @brief Coalescing of identical concurrent reads.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#include "o3d/mysql/mysqlsingleflight.h"
+#include "o3d/mysql/mysqldb.h"
+
+using namespace o3d;
+using namespace o3d::mysql;
+
+MySqlSingleFlight::MySqlSingleFlight()
+{
+    m_stats.executes = 0;
+    m_stats.shared = 0;
+}
+
+MySqlSingleFlight::Result MySqlSingleFlight::execute(MySqlQuery &query, const MySqlParams &params)
+{
+    return execute(query.getName(), params, [&query, &params] () {
+        params.apply(query);
+        query.execute();
+
+        return query.materialize();
+    });
+}
+
+MySqlSingleFlight::Result MySqlSingleFlight::execute(
+        const String &name,
+        const MySqlParams &params,
+        const Loader &loader)
+{
+    UInt64 h = key(name, params);
+
+    std::shared_ptr<Flight> flight;
+    std::promise<Result> promise;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto range = m_flights.equal_range(h);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (same(*it->second, name, params)) {
+                flight = it->second;
+                break;
+            }
+        }
+
+        if (flight) {
+            ++m_stats.shared;
+        } else {
+            flight = std::make_shared<Flight>();
+            flight->name = name;
+            flight->params = params;
+            flight->result = promise.get_future().share();
+
+            m_flights.insert(std::make_pair(h, flight));
+            ++m_stats.executes;
+
+            flight.reset();
+        }
+    }
+
+    // follower, the error of the leader is raised again
+    if (flight) {
+        return flight->result.get();
+    }
+
+    Result result;
+    std::exception_ptr error;
+
+    try {
+        result = loader();
+    } catch (...) {
+        error = std::current_exception();
+    }
+
+    {
+        // removed before completion, so a later read executes again
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto range = m_flights.equal_range(h);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (same(*it->second, name, params)) {
+                m_flights.erase(it);
+                break;
+            }
+        }
+    }
+
+    if (error) {
+        promise.set_exception(error);
+        std::rethrow_exception(error);
+    }
+
+    promise.set_value(result);
+    return result;
+}
+
+UInt32 MySqlSingleFlight::getNumInFlight() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return (UInt32)m_flights.size();
+}
+
+MySqlSingleFlight::Stats MySqlSingleFlight::getStats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+UInt64 MySqlSingleFlight::key(const String &name, const MySqlParams &params)
+{
+    return params.key(name.toUtf8());
+}
+
+Bool MySqlSingleFlight::same(const Flight &flight, const String &name, const MySqlParams &params)
+{
+    if (flight.params.getNumParams() != params.getNumParams() || !(flight.name == name)) {
+        return False;
+    }
+
+    for (UInt32 i = 0; i < params.getNumParams(); ++i) {
+        if (flight.params.getType(i) != params.getType(i) || !flight.params.equal(i, params)) {
+            return False;
+        }
+    }
+
+    return True;
+}
@@ -0,0 +1,305 @@
+/**
+ * @file mysqlsnapshotcache.cpp
+ * @brief On disk memory mapped snapshots of query results.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#include "o3d/mysql/mysqlsnapshotcache.h"
+#include "o3d/mysql/mysqldb.h"
+
+#include <o3d/core/debug.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#ifndef O3D_WINDOWS
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+using namespace o3d;
+using namespace o3d::mysql;
+
+static const Char SNAPSHOT_MAGIC[8] = { 'O', '3', 'D', 'S', 'N', 'A', 'P', 0 };
+
+MySqlSnapshotCache::MySqlSnapshotCache(MySqlDb *db, const String &directory) :
+    m_db(db),
+    m_directory(directory)
+{
+
+}
+
+UInt64 MySqlSnapshotCache::key(const CString &sql, const MySqlParams &params)
+{
+    return params.key(sql);
+}
+
+String MySqlSnapshotCache::getPath(const String &name, const CString &sql, const MySqlParams &params) const
+{
+    Char hex[17];
+    snprintf(hex, sizeof(hex), "%016llx", (unsigned long long)key(sql, params));
+
+    return m_directory + "/" + name + "-" + hex + ".snap";
+}
+
+CString MySqlSnapshotCache::queryVersion(const CString &versionSql)
+{
+    MySqlResult *result = m_db->executeDirect(versionSql);
+    std::string version;
+
+    try {
+        if (result->fetch()) {
+            for (UInt32 i = 0; i < result->getNumColumns(); ++i) {
+                UInt32 length;
+                const Char *text = result->getText(i, length);
+
+                if (i > 0) {
+                    version += '|';
+                }
+
+                if (text) {
+                    version.append(text, length);
+                }
+            }
+        }
+    } catch (...) {
+        deletePtr(result);
+        throw;
+    }
+
+    deletePtr(result);
+
+    return CString(version.c_str(), (UInt32)version.length());
+}
+
+std::shared_ptr<const MySqlRowSet> MySqlSnapshotCache::get(
+        const String &name,
+        const CString &sql,
+        const MySqlParams &params,
+        const CString &versionSql)
+{
+    if (!m_db) {
+        O3D_ERROR(E_InvalidPrecondition("A connection is required to validate a snapshot"));
+    }
+
+    // version read before the data, a change in between gives a newer version next time
+    CString version = queryVersion(versionSql);
+    CString current;
+
+    std::shared_ptr<const MySqlRowSet> rowSet = open(name, sql, params, &current);
+    if (rowSet && current == version) {
+        return rowSet;
+    }
+
+    rowSet.reset();
+
+    String queryName = String("snapshot.") + name;
+    MySqlQuery *query = static_cast<MySqlQuery*>(m_db->registerQuery(queryName, sql));
+
+    try {
+        // rows read one by one from the network, with full length strings and blobs
+        query->setExecuteMode(MySqlQuery::EXEC_STREAM);
+        query->setArenaMode(True);
+
+        params.apply(*query);
+        query->execute();
+
+        write(getPath(name, sql, params), key(sql, params), version, *query);
+    } catch (...) {
+        m_db->unregisterQuery(queryName);
+        throw;
+    }
+
+    m_db->unregisterQuery(queryName);
+
+    // the written file is mapped, the rows having never been held in memory
+    rowSet = open(name, sql, params);
+    if (!rowSet) {
+        O3D_ERROR(E_InvalidResult("Unable to map the written snapshot"));
+    }
+
+    return rowSet;
+}
+
+std::shared_ptr<const MySqlRowSet> MySqlSnapshotCache::open(
+        const String &name,
+        const CString &sql,
+        const MySqlParams &params,
+        CString *version) const
+{
+    String path = getPath(name, sql, params);
+    CString filename = path.toUtf8();
+
+#ifdef O3D_WINDOWS
+    std::ifstream file(filename.getData(), std::ios::binary | std::ios::ate);
+    if (!file) {
+        return nullptr;
+    }
+
+    UInt64 size = (UInt64)file.tellg();
+    file.seekg(0);
+
+    // no mapping, read into a 8 bytes aligned buffer
+    UInt64 *buffer = new UInt64[(size_t)((size + 7) / 8)];
+    if (!file.read((char*)buffer, (std::streamsize)size)) {
+        delete [] buffer;
+        return nullptr;
+    }
+
+    const UInt8 *base = (const UInt8*)buffer;
+    std::function<void()> release = [buffer] () { delete [] buffer; };
+#else
+    int fd = ::open(filename.getData(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(FileHeader)) {
+        ::close(fd);
+        return nullptr;
+    }
+
+    UInt64 size = (UInt64)st.st_size;
+
+    void *mapped = mmap(nullptr, (size_t)size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+
+    if (mapped == MAP_FAILED) {
+        return nullptr;
+    }
+
+    const UInt8 *base = (const UInt8*)mapped;
+    std::function<void()> release = [mapped, size] () { munmap(mapped, (size_t)size); };
+#endif
+
+    const FileHeader *header = (const FileHeader*)base;
+
+    if (size < sizeof(FileHeader) ||
+        memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 ||
+        header->version != VERSION ||
+        header->key != key(sql, params) ||
+        sizeof(FileHeader) + (UInt64)header->versionLength > header->rowSetOffset ||
+        (header->rowSetOffset & 7) != 0 ||
+        header->rowSetOffset + header->rowSetSize > size) {
+        release();
+        return nullptr;
+    }
+
+    if (version) {
+        *version = CString((const Char*)base + sizeof(FileHeader), header->versionLength);
+    }
+
+    try {
+        // the release is owned by the rowset from now
+        return MySqlRowSet::fromBuffer(base + header->rowSetOffset, header->rowSetSize, release);
+    } catch (E_InvalidFormat &) {
+        return nullptr;
+    }
+}
+
+void MySqlSnapshotCache::invalidate(const String &name, const CString &sql, const MySqlParams &params)
+{
+    std::remove(getPath(name, sql, params).toUtf8().getData());
+}
+
+void MySqlSnapshotCache::write(
+        const String &path,
+        UInt64 keyHash,
+        const CString &version,
+        MySqlQuery &query)
+{
+    String tmpPath = path + ".tmp";
+    CString tmpFilename = tmpPath.toUtf8();
+    CString heapFilename = (path + ".heap.tmp").toUtf8();
+
+    FileHeader header;
+    memset(&header, 0, sizeof(FileHeader));
+
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    header.version = VERSION;
+    header.versionLength = version.length();
+    header.key = keyHash;
+    header.rowSetOffset = (sizeof(FileHeader) + version.length() + 7) & ~7;
+    header.rowSetSize = 0;
+
+    std::ofstream file(tmpFilename.getData(), std::ios::binary | std::ios::trunc);
+    if (!file) {
+        O3D_ERROR(E_FileNotFoundOrInvalidRights("Unable to create the snapshot", tmpPath));
+    }
+
+    // strings and blobs, appended after the rows once they are all written
+    std::fstream heap(heapFilename.getData(), std::ios::binary | std::ios::in | std::ios::out | std::ios::trunc);
+    if (!heap) {
+        file.close();
+        std::remove(tmpFilename.getData());
+        O3D_ERROR(E_FileNotFoundOrInvalidRights("Unable to create the snapshot", tmpPath));
+    }
+
+    const Char padding[8] = { 0 };
+
+    file.write((const char*)&header, sizeof(FileHeader));
+    file.write(version.getData(), version.length());
+    file.write(padding, (std::streamsize)(header.rowSetOffset - sizeof(FileHeader) - version.length()));
+
+    try {
+        MySqlRowSetBuilder builder;
+        builder.beginStream(file, heap);
+
+        query.materialize(builder);
+        header.rowSetSize = builder.endStream();
+
+        file.seekp(0);
+        file.write((const char*)&header, sizeof(FileHeader));
+    } catch (...) {
+        file.close();
+        heap.close();
+
+        std::remove(tmpFilename.getData());
+        std::remove(heapFilename.getData());
+        throw;
+    }
+
+    file.close();
+    heap.close();
+    std::remove(heapFilename.getData());
+
+    if (file.fail()) {
+        std::remove(tmpFilename.getData());
+        O3D_ERROR(E_FileNotFoundOrInvalidRights("Unable to write the snapshot", tmpPath));
+    }
+
+#ifndef O3D_WINDOWS
+    // on the disk before it replaces the previous snapshot
+    int fd = ::open(tmpFilename.getData(), O_WRONLY);
+    if (fd < 0 || fsync(fd) != 0) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+
+        std::remove(tmpFilename.getData());
+        O3D_ERROR(E_FileNotFoundOrInvalidRights("Unable to sync the snapshot", tmpPath));
+    }
+
+    ::close(fd);
+#endif
+
+    CString filename = path.toUtf8();
+
+#ifdef O3D_WINDOWS
+    std::remove(filename.getData());
+#endif
+
+    // a mapped previous version remains valid until unmapped
+    if (std::rename(tmpFilename.getData(), filename.getData()) != 0) {
+        std::remove(tmpFilename.getData());
+        O3D_ERROR(E_FileNotFoundOrInvalidRights("Unable to replace the snapshot", path));
+    }
+}
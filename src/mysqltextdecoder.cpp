@@ -0,0 +1,426 @@
+/**
+ * @file mysqltextdecoder.cpp
+ * @brief UTF-8 validation and decoding of text outputs into String.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#include "o3d/mysql/mysqltextdecoder.h"
+#include "o3d/mysql/mysqldb.h"
+#include "o3d/mysql/mysqlrowblock.h"
+
+#include <o3d/core/debug.h>
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define O3D_MYSQL_X86
+    #include <immintrin.h>
+
+    #ifdef _MSC_VER
+        #include <intrin.h>
+        #define O3D_MYSQL_TARGET_AVX2
+    #else
+        #define O3D_MYSQL_TARGET_AVX2 __attribute__((target("avx2")))
+    #endif
+#endif
+
+using namespace o3d;
+using namespace o3d::mysql;
+
+static const UInt32 REPLACEMENT_CHARACTER = 0xFFFD;
+
+//
+// Scalar, 8 bytes at once
+//
+
+static size_t asciiScalar(const UInt8 *data, size_t length)
+{
+    size_t i = 0;
+
+    for (; i + 8 <= length; i += 8) {
+        UInt64 v;
+        memcpy(&v, data + i, 8);
+
+        if (v & 0x8080808080808080ULL) {
+            break;
+        }
+    }
+
+    return i;
+}
+
+static size_t widenScalar(const UInt8 *data, size_t length, WChar *out)
+{
+    size_t n = asciiScalar(data, length);
+
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = (WChar)data[i];
+    }
+
+    return n;
+}
+
+#ifdef O3D_MYSQL_X86
+
+//
+// SSE2, 16 bytes at once
+//
+
+static size_t asciiSse2(const UInt8 *data, size_t length)
+{
+    size_t i = 0;
+
+    for (; i + 16 <= length; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(data + i));
+
+        if (_mm_movemask_epi8(v)) {
+            break;
+        }
+    }
+
+    return i;
+}
+
+static size_t widenSse2(const UInt8 *data, size_t length, WChar *out)
+{
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+
+    for (; i + 16 <= length; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(data + i));
+
+        if (_mm_movemask_epi8(v)) {
+            break;
+        }
+
+        __m128i lo = _mm_unpacklo_epi8(v, zero);
+        __m128i hi = _mm_unpackhi_epi8(v, zero);
+
+        if (sizeof(WChar) == 2) {
+            _mm_storeu_si128((__m128i*)(out + i), lo);
+            _mm_storeu_si128((__m128i*)(out + i + 8), hi);
+        } else {
+            _mm_storeu_si128((__m128i*)(out + i), _mm_unpacklo_epi16(lo, zero));
+            _mm_storeu_si128((__m128i*)(out + i + 4), _mm_unpackhi_epi16(lo, zero));
+            _mm_storeu_si128((__m128i*)(out + i + 8), _mm_unpacklo_epi16(hi, zero));
+            _mm_storeu_si128((__m128i*)(out + i + 12), _mm_unpackhi_epi16(hi, zero));
+        }
+    }
+
+    return i;
+}
+
+//
+// AVX2, 32 bytes at once
+//
+
+O3D_MYSQL_TARGET_AVX2 static size_t asciiAvx2(const UInt8 *data, size_t length)
+{
+    size_t i = 0;
+
+    for (; i + 32 <= length; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(data + i));
+
+        if (_mm256_movemask_epi8(v)) {
+            break;
+        }
+    }
+
+    return i;
+}
+
+O3D_MYSQL_TARGET_AVX2 static size_t widenAvx2(const UInt8 *data, size_t length, WChar *out)
+{
+    size_t i = 0;
+
+    for (; i + 32 <= length; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(data + i));
+
+        if (_mm256_movemask_epi8(v)) {
+            break;
+        }
+
+        __m128i lo = _mm256_castsi256_si128(v);
+        __m128i hi = _mm256_extracti128_si256(v, 1);
+
+        if (sizeof(WChar) == 2) {
+            _mm256_storeu_si256((__m256i*)(out + i), _mm256_cvtepu8_epi16(lo));
+            _mm256_storeu_si256((__m256i*)(out + i + 16), _mm256_cvtepu8_epi16(hi));
+        } else {
+            _mm256_storeu_si256((__m256i*)(out + i), _mm256_cvtepu8_epi32(lo));
+            _mm256_storeu_si256((__m256i*)(out + i + 8), _mm256_cvtepu8_epi32(_mm_srli_si128(lo, 8)));
+            _mm256_storeu_si256((__m256i*)(out + i + 16), _mm256_cvtepu8_epi32(hi));
+            _mm256_storeu_si256((__m256i*)(out + i + 24), _mm256_cvtepu8_epi32(_mm_srli_si128(hi, 8)));
+        }
+    }
+
+    return i;
+}
+
+static Bool cpuHasAvx2()
+{
+#ifdef _MSC_VER
+    int info[4];
+
+    // the OS must save the AVX registers
+    __cpuid(info, 1);
+    if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0) {
+        return False;
+    }
+
+    if ((_xgetbv(0) & 6) != 6) {
+        return False;
+    }
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+
+#endif // O3D_MYSQL_X86
+
+/**
+ * @brief Decode a code point.
+ * @return Number of bytes of the sequence, 0 if invalid.
+ */
+static inline size_t decodeUtf8(const UInt8 *p, size_t available, UInt32 &codePoint)
+{
+    UInt8 c = p[0];
+
+    if (c < 0x80) {
+        codePoint = c;
+        return 1;
+    }
+
+    // continuation or overlong of 2 bytes
+    if (c < 0xC2) {
+        return 0;
+    }
+
+    if (c < 0xE0) {
+        if (available < 2 || (p[1] & 0xC0) != 0x80) {
+            return 0;
+        }
+
+        codePoint = ((c & 0x1F) << 6) | (p[1] & 0x3F);
+        return 2;
+    }
+
+    if (c < 0xF0) {
+        if (available < 3 || (p[1] & 0xC0) != 0x80 || (p[2] & 0xC0) != 0x80) {
+            return 0;
+        }
+
+        // overlong and surrogates
+        if ((c == 0xE0 && p[1] < 0xA0) || (c == 0xED && p[1] >= 0xA0)) {
+            return 0;
+        }
+
+        codePoint = ((c & 0x0F) << 12) | ((p[1] & 0x3F) << 6) | (p[2] & 0x3F);
+        return 3;
+    }
+
+    if (c < 0xF5) {
+        if (available < 4 || (p[1] & 0xC0) != 0x80 || (p[2] & 0xC0) != 0x80 || (p[3] & 0xC0) != 0x80) {
+            return 0;
+        }
+
+        // overlong and above U+10FFFF
+        if ((c == 0xF0 && p[1] < 0x90) || (c == 0xF4 && p[1] >= 0x90)) {
+            return 0;
+        }
+
+        codePoint = ((c & 0x07) << 18) | ((p[1] & 0x3F) << 12) | ((p[2] & 0x3F) << 6) | (p[3] & 0x3F);
+        return 4;
+    }
+
+    return 0;
+}
+
+//! Write a code point, as a surrogate pair above U+FFFF with a 16 bits WChar.
+static inline size_t encodeWChar(UInt32 codePoint, WChar *out)
+{
+    if (sizeof(WChar) == 2 && codePoint > 0xFFFF) {
+        codePoint -= 0x10000;
+        out[0] = (WChar)(0xD800 + (codePoint >> 10));
+        out[1] = (WChar)(0xDC00 + (codePoint & 0x3FF));
+        return 2;
+    }
+
+    out[0] = (WChar)codePoint;
+    return 1;
+}
+
+MySqlTextDecoder::MySqlTextDecoder() :
+    m_isa(ISA_SCALAR),
+    m_ascii(asciiScalar),
+    m_widen(widenScalar),
+    m_strict(False)
+{
+    setIsa(getBestIsa());
+}
+
+MySqlTextDecoder::Isa MySqlTextDecoder::getBestIsa()
+{
+#ifdef O3D_MYSQL_X86
+    static const Isa best = cpuHasAvx2() ? ISA_AVX2 : ISA_SSE2;
+    return best;
+#else
+    return ISA_SCALAR;
+#endif
+}
+
+void MySqlTextDecoder::setIsa(Isa isa)
+{
+    if (isa > getBestIsa()) {
+        O3D_ERROR(E_InvalidParameter("Instruction set not supported by the CPU"));
+    }
+
+    switch (isa) {
+#ifdef O3D_MYSQL_X86
+    case ISA_SSE2:
+        m_ascii = asciiSse2;
+        m_widen = widenSse2;
+        break;
+    case ISA_AVX2:
+        m_ascii = asciiAvx2;
+        m_widen = widenAvx2;
+        break;
+#endif
+    default:
+        m_ascii = asciiScalar;
+        m_widen = widenScalar;
+        break;
+    }
+
+    m_isa = isa;
+}
+
+Bool MySqlTextDecoder::isAscii(const Char *data, size_t length) const
+{
+    const UInt8 *p = (const UInt8*)data;
+    size_t i = m_ascii(p, length);
+
+    for (; i < length; ++i) {
+        if (p[i] & 0x80) {
+            return False;
+        }
+    }
+
+    return True;
+}
+
+Bool MySqlTextDecoder::validate(const Char *data, size_t length) const
+{
+    const UInt8 *p = (const UInt8*)data;
+    size_t pos = 0;
+
+    while (pos < length) {
+        pos += m_ascii(p + pos, length - pos);
+
+        // a block of scalar decoding, until the next run of ASCII
+        size_t blockEnd = pos + 16 < length ? pos + 16 : length;
+
+        while (pos < blockEnd) {
+            UInt32 codePoint;
+            size_t n = decodeUtf8(p + pos, length - pos, codePoint);
+            if (n == 0) {
+                return False;
+            }
+
+            pos += n;
+        }
+    }
+
+    return True;
+}
+
+const WChar *MySqlTextDecoder::decode(const Char *data, size_t length, UInt32 &outLength)
+{
+    // a WChar at most per byte, even as surrogate pairs, and the terminal zero
+    if (m_buffer.size() < length + 1) {
+        m_buffer.resize(length + 1);
+    }
+
+    const UInt8 *p = (const UInt8*)data;
+    WChar *out = m_buffer.data();
+
+    size_t pos = 0;
+    size_t outPos = 0;
+
+    while (pos < length) {
+        size_t n = m_widen(p + pos, length - pos, out + outPos);
+        pos += n;
+        outPos += n;
+
+        size_t blockEnd = pos + 16 < length ? pos + 16 : length;
+
+        while (pos < blockEnd) {
+            UInt32 codePoint;
+            n = decodeUtf8(p + pos, length - pos, codePoint);
+
+            if (n == 0) {
+                if (m_strict) {
+                    O3D_ERROR(E_InvalidFormat(String("Invalid UTF-8 sequence at byte ") << (UInt32)pos));
+                }
+
+                // a single byte skipped, to resynchronize on the next one
+                codePoint = REPLACEMENT_CHARACTER;
+                n = 1;
+            }
+
+            pos += n;
+            outPos += encodeWChar(codePoint, out + outPos);
+        }
+    }
+
+    out[outPos] = 0;
+    outLength = (UInt32)outPos;
+
+    return out;
+}
+
+void MySqlTextDecoder::decode(const Char *data, size_t length, String &out)
+{
+    UInt32 outLength = 0;
+    const WChar *text = decode(data, length, outLength);
+
+    out.set(text, outLength);
+}
+
+Bool MySqlTextDecoder::decodeOutput(const MySqlQuery &query, UInt32 attr, String &out)
+{
+    UInt32 length = 0;
+    const UInt8 *data = query.getOutData(attr, length);
+
+    if (!data) {
+        out = String();
+        return False;
+    }
+
+    decode((const Char*)data, length, out);
+    return True;
+}
+
+void MySqlTextDecoder::decodeColumn(const MySqlRowBlock &block, UInt32 col, std::vector<String> &out)
+{
+    UInt32 numRows = block.getNumRows();
+    out.resize(numRows);
+
+    for (UInt32 row = 0; row < numRows; ++row) {
+        UInt32 length = 0;
+        const UInt8 *data = block.getData(row, col, &length);
+
+        if (data) {
+            decode((const Char*)data, length, out[row]);
+        } else {
+            out[row] = String();
+        }
+    }
+}
@@ -0,0 +1,177 @@
+/**
+ * @file mysqlwatchdog.cpp
+ * @brief Deadlines of the running queries.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#include "o3d/mysql/mysqlwatchdog.h"
+#include "o3d/mysql/mysqldb.h"
+
+#include <o3d/core/debug.h>
+
+#include <mysql/mysql.h>
+
+using namespace o3d;
+using namespace o3d::mysql;
+
+MySqlWatchdog &MySqlWatchdog::instance()
+{
+    static MySqlWatchdog watchdog;
+    return watchdog;
+}
+
+MySqlWatchdog::MySqlWatchdog() :
+    m_nextId(1),
+    m_running(False)
+{
+
+}
+
+MySqlWatchdog::~MySqlWatchdog()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = False;
+    }
+
+    m_condition.notify_all();
+
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+UInt64 MySqlWatchdog::arm(MySqlDb *db, UInt32 timeout)
+{
+    // else the deadline would silently fail to cancel
+    if (!db->isPasswordKept()) {
+        O3D_ERROR(E_InvalidPrecondition("A timeout needs the password to have been kept at connect"));
+    }
+
+    UInt64 id;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (!m_running) {
+            m_running = True;
+            m_thread = std::thread(&MySqlWatchdog::run, this);
+        }
+
+        id = m_nextId++;
+
+        Deadline deadline;
+        deadline.db = db;
+        deadline.time = Clock::now() + std::chrono::milliseconds(timeout);
+        deadline.firing = False;
+        deadline.fired = False;
+
+        m_deadlines.insert(std::make_pair(id, deadline));
+    }
+
+    m_condition.notify_all();
+    return id;
+}
+
+Bool MySqlWatchdog::disarm(UInt64 id)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    auto it = m_deadlines.find(id);
+    if (it == m_deadlines.end()) {
+        return False;
+    }
+
+    // the kill must not reach a next query
+    m_condition.wait(lock, [&] () { return !it->second.firing; });
+
+    Bool fired = it->second.fired;
+    m_deadlines.erase(it);
+
+    return fired;
+}
+
+void MySqlWatchdog::run()
+{
+    // the cancels use the client library from this thread
+    mysql_thread_init();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (m_running) {
+        auto next = m_deadlines.end();
+        for (auto it = m_deadlines.begin(); it != m_deadlines.end(); ++it) {
+            if (!it->second.fired && !it->second.firing &&
+                (next == m_deadlines.end() || it->second.time < next->second.time)) {
+                next = it;
+            }
+        }
+
+        if (next == m_deadlines.end()) {
+            m_condition.wait(lock);
+            continue;
+        }
+
+        if (next->second.time > Clock::now()) {
+            m_condition.wait_until(lock, next->second.time);
+            continue;
+        }
+
+        UInt64 id = next->first;
+        MySqlDb *db = next->second.db;
+        next->second.firing = True;
+
+        lock.unlock();
+
+        try {
+            db->cancel();
+        } catch (E_BaseException &) {
+            O3D_WARNING("Unable to cancel a query once its deadline passed");
+        }
+
+        lock.lock();
+
+        // kept until disarmed
+        Deadline &deadline = m_deadlines[id];
+        deadline.firing = False;
+        deadline.fired = True;
+
+        m_condition.notify_all();
+    }
+
+    lock.unlock();
+    mysql_thread_end();
+}
+
+//
+// MySqlDeadline
+//
+
+MySqlDeadline::MySqlDeadline(MySqlDb *db, UInt32 timeout) :
+    m_id(0),
+    m_armed(False),
+    m_expired(False)
+{
+    if (timeout > 0) {
+        m_id = MySqlWatchdog::instance().arm(db, timeout);
+        m_armed = True;
+    }
+}
+
+MySqlDeadline::~MySqlDeadline()
+{
+    expired();
+}
+
+Bool MySqlDeadline::expired()
+{
+    if (m_armed) {
+        m_expired = MySqlWatchdog::instance().disarm(m_id);
+        m_armed = False;
+    }
+
+    return m_expired;
+}
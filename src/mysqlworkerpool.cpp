@@ -0,0 +1,104 @@
+/**
+ * @file mysqlworkerpool.cpp
+ * @brief Fixed pool of worker threads for the parallel statements.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#include "o3d/mysql/mysqlworkerpool.h"
+
+#include <mysql/mysql.h>
+
+#include <exception>
+
+using namespace o3d;
+using namespace o3d::mysql;
+
+MySqlWorkerPool::MySqlWorkerPool(UInt32 numThreads) :
+    m_running(True)
+{
+    if (numThreads == 0) {
+        numThreads = 1;
+    }
+
+    m_threads.reserve(numThreads);
+    for (UInt32 i = 0; i < numThreads; ++i) {
+        m_threads.push_back(std::thread(&MySqlWorkerPool::run, this));
+    }
+}
+
+MySqlWorkerPool::~MySqlWorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = False;
+    }
+
+    m_condition.notify_all();
+
+    for (std::thread &thread : m_threads) {
+        thread.join();
+    }
+}
+
+std::future<void> MySqlWorkerPool::submit(const std::function<void()> &task)
+{
+    std::packaged_task<void()> packagedTask(task);
+    std::future<void> future = packagedTask.get_future();
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.push_back(std::move(packagedTask));
+    }
+
+    m_condition.notify_one();
+    return future;
+}
+
+void MySqlWorkerPool::waitAll(std::vector<std::future<void>> &futures)
+{
+    std::exception_ptr error;
+
+    for (std::future<void> &future : futures) {
+        try {
+            future.get();
+        } catch (...) {
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void MySqlWorkerPool::run()
+{
+    // the tasks use the client library from this thread
+    mysql_thread_init();
+
+    for (;;) {
+        std::packaged_task<void()> task;
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this] { return !m_running || !m_tasks.empty(); });
+
+            // pending tasks are processed before leaving
+            if (m_tasks.empty()) {
+                break;
+            }
+
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+        }
+
+        task();
+    }
+
+    mysql_thread_end();
+}
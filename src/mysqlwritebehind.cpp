@@ -0,0 +1,412 @@
+/**
+ * @file mysqlwritebehind.cpp
+ * @brief Coalescing buffer of the upserts of hot rows.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#include "o3d/mysql/mysqlwritebehind.h"
+#include "o3d/mysql/mysqldb.h"
+#include "o3d/mysql/mysqlexception.h"
+
+#include <o3d/core/debug.h>
+
+#include <mysql/mysql.h>
+
+#include <string>
+
+using namespace o3d;
+using namespace o3d::mysql;
+
+MySqlWriteBehind::MySqlWriteBehind(
+        MySqlDb *db,
+        const CString &table,
+        UInt32 interval,
+        UInt32 maxRows,
+        UInt32 batchSize) :
+    m_db(db),
+    m_table(table),
+    m_interval(interval),
+    m_maxRows(maxRows),
+    m_batchSize(batchSize),
+    m_failing(False),
+    m_running(False)
+{
+    if (!db) {
+        O3D_ERROR(E_InvalidParameter("Null connection"));
+    }
+
+    if (maxRows == 0 || batchSize == 0) {
+        O3D_ERROR(E_InvalidParameter("Max rows and batch size must be greater than 0"));
+    }
+
+    m_stats.writes = 0;
+    m_stats.coalesced = 0;
+    m_stats.rows = 0;
+    m_stats.statements = 0;
+    m_stats.failures = 0;
+
+    if (interval > 0) {
+        m_running = True;
+        m_thread = std::thread(&MySqlWriteBehind::run, this);
+    }
+}
+
+MySqlWriteBehind::~MySqlWriteBehind()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = False;
+    }
+
+    m_condition.notify_all();
+
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void MySqlWriteBehind::addColumn(const CString &name, Merge merge)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_stats.writes > 0) {
+        O3D_ERROR(E_InvalidOperation("Columns must be added before any write"));
+    }
+
+    if (merge == MERGE_KEY) {
+        m_keys.push_back((UInt32)m_columns.size());
+    }
+
+    Column column;
+    column.name = name;
+    column.merge = merge;
+
+    m_columns.push_back(column);
+}
+
+void MySqlWriteBehind::write(const MySqlParams &row)
+{
+    Bool full;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (m_error) {
+            std::exception_ptr error = m_error;
+            m_error = nullptr;
+            std::rethrow_exception(error);
+        }
+
+        if (m_keys.empty()) {
+            O3D_ERROR(E_InvalidOperation("At least one key column must be added"));
+        }
+
+        if (row.getNumParams() != m_columns.size()) {
+            O3D_ERROR(E_InvalidParameter("Every column of the row must be set"));
+        }
+
+        for (UInt32 i = 0; i < m_columns.size(); ++i) {
+            MySqlParams::Type type = row.getType(i);
+
+            if (type == MySqlParams::T_UNDEFINED) {
+                O3D_ERROR(E_InvalidParameter(String("Undefined column ") << i));
+            }
+
+            // merged later with MySqlParams::add, which must not fail
+            if (m_columns[i].merge == MERGE_ADD &&
+                (type < MySqlParams::T_INT32 || type > MySqlParams::T_DOUBLE)) {
+                O3D_ERROR(E_InvalidParameter(String("Counter column must be numeric ") << i));
+            }
+        }
+
+        // bounded while the flushes fail, the pending keys being still merged
+        if (m_failing && m_pending.rows.size() >= m_maxRows && find(row, hashKey(row)) < 0) {
+            O3D_ERROR(E_MySqlOverload("Write behind is full and its last flush failed"));
+        }
+
+        ++m_stats.writes;
+        if (merge(row, False)) {
+            ++m_stats.coalesced;
+        }
+
+        full = m_pending.rows.size() >= m_maxRows;
+    }
+
+    if (full) {
+        flush();
+    }
+}
+
+void MySqlWriteBehind::flush()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_flushMutex);
+        flushPending();
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_error) {
+        std::exception_ptr error = m_error;
+        m_error = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+UInt32 MySqlWriteBehind::getNumPending() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return (UInt32)m_pending.rows.size();
+}
+
+MySqlWriteBehind::Stats MySqlWriteBehind::getStats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+CString MySqlWriteBehind::getStatement(UInt32 numRows) const
+{
+    std::string sql = "INSERT INTO ";
+    sql += m_table.getData();
+    sql += " (";
+
+    for (size_t i = 0; i < m_columns.size(); ++i) {
+        if (i > 0) {
+            sql += ", ";
+        }
+
+        sql += m_columns[i].name.getData();
+    }
+
+    sql += ") VALUES ";
+
+    std::string values = "(";
+    for (size_t i = 0; i < m_columns.size(); ++i) {
+        values += i > 0 ? ", ?" : "?";
+    }
+    values += ")";
+
+    for (UInt32 i = 0; i < numRows; ++i) {
+        if (i > 0) {
+            sql += ", ";
+        }
+
+        sql += values;
+    }
+
+    std::string update;
+    for (const Column &column : m_columns) {
+        if (column.merge == MERGE_KEY) {
+            continue;
+        }
+
+        if (!update.empty()) {
+            update += ", ";
+        }
+
+        update += column.name.getData();
+        update += " = ";
+
+        if (column.merge == MERGE_ADD) {
+            update += column.name.getData();
+            update += " + ";
+        }
+
+        update += "VALUES(";
+        update += column.name.getData();
+        update += ")";
+    }
+
+    if (update.empty()) {
+        // only keys, a no-op update keeps the existing rows
+        const CString &key = m_columns[m_keys[0]].name;
+        update = std::string(key.getData()) + " = " + key.getData();
+    }
+
+    sql += " ON DUPLICATE KEY UPDATE ";
+    sql += update;
+
+    return CString(sql.c_str(), (UInt32)sql.length());
+}
+
+UInt64 MySqlWriteBehind::hashKey(const MySqlParams &row) const
+{
+    UInt64 h = 14695981039346656037ULL;
+
+    for (UInt32 attr : m_keys) {
+        h = (h ^ row.hash(attr)) * 1099511628211ULL;
+    }
+
+    return h;
+}
+
+Int32 MySqlWriteBehind::find(const MySqlParams &row, UInt64 h) const
+{
+    auto range = m_pending.index.equal_range(h);
+    for (auto it = range.first; it != range.second; ++it) {
+        const MySqlParams &pending = m_pending.rows[it->second];
+
+        Bool same = True;
+        for (UInt32 attr : m_keys) {
+            if (!pending.equal(attr, row)) {
+                same = False;
+                break;
+            }
+        }
+
+        if (same) {
+            return (Int32)it->second;
+        }
+    }
+
+    return -1;
+}
+
+Bool MySqlWriteBehind::merge(const MySqlParams &row, Bool older)
+{
+    UInt64 h = hashKey(row);
+    Int32 index = find(row, h);
+
+    if (index >= 0) {
+        MySqlParams &pending = m_pending.rows[index];
+
+        if (older) {
+            // the pending values are newer, only the increments are summed
+            for (UInt32 i = 0; i < m_columns.size(); ++i) {
+                if (m_columns[i].merge == MERGE_ADD) {
+                    pending.add(i, row);
+                }
+            }
+        } else {
+            MySqlParams merged = row;
+
+            for (UInt32 i = 0; i < m_columns.size(); ++i) {
+                if (m_columns[i].merge == MERGE_ADD) {
+                    merged.add(i, pending);
+                }
+            }
+
+            pending = std::move(merged);
+        }
+
+        return True;
+    }
+
+    m_pending.index.insert(std::make_pair(h, (UInt32)m_pending.rows.size()));
+    m_pending.rows.push_back(row);
+
+    return False;
+}
+
+void MySqlWriteBehind::flushPending()
+{
+    Pending pending;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::swap(pending, m_pending);
+    }
+
+    if (pending.rows.empty()) {
+        return;
+    }
+
+    size_t numSent = 0;
+
+    try {
+        send(pending.rows, numSent);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_failing = False;
+    } catch (E_BaseException &) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_error = std::current_exception();
+        m_failing = True;
+        ++m_stats.failures;
+
+        O3D_WARNING("Write behind flush failed, the rows are kept");
+
+        // the executed statements are committed, the others are retried later
+        for (size_t i = numSent; i < pending.rows.size(); ++i) {
+            merge(pending.rows[i], True);
+        }
+    }
+}
+
+void MySqlWriteBehind::send(const std::vector<MySqlParams> &rows, size_t &numSent)
+{
+    const UInt32 numColumns = (UInt32)m_columns.size();
+
+    while (numSent < rows.size()) {
+        size_t remaining = rows.size() - numSent;
+        UInt32 numRows = m_batchSize;
+
+        // the remainder by powers of two, to prepare at most log2 statements more
+        if (remaining < m_batchSize) {
+            numRows = 1;
+            while ((size_t)numRows * 2 <= remaining) {
+                numRows *= 2;
+            }
+        }
+
+        DbQuery *q = query(numRows);
+
+        for (UInt32 i = 0; i < numRows; ++i) {
+            rows[numSent + i].apply(*q, i * numColumns);
+        }
+
+        q->update();
+        numSent += numRows;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stats.rows += numRows;
+        ++m_stats.statements;
+    }
+}
+
+DbQuery *MySqlWriteBehind::query(UInt32 numRows)
+{
+    auto it = m_queries.find(numRows);
+    if (it != m_queries.end()) {
+        return it->second;
+    }
+
+    std::string name = std::string("o3d.writebehind.") + m_table.getData() + "." + std::to_string(numRows);
+    DbQuery *q = m_db->registerQuery(String(name.c_str()), getStatement(numRows));
+
+    m_queries[numRows] = q;
+    return q;
+}
+
+void MySqlWriteBehind::run()
+{
+    // the flushes use the client library from this thread
+    mysql_thread_init();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (m_running) {
+        m_condition.wait_for(lock, m_interval);
+
+        if (!m_running) {
+            break;
+        }
+
+        lock.unlock();
+
+        {
+            std::lock_guard<std::mutex> flushLock(m_flushMutex);
+            flushPending();
+        }
+
+        lock.lock();
+    }
+
+    lock.unlock();
+    mysql_thread_end();
+}
@@ -14,6 +14,8 @@
 
 #include <o3d/mysql/mysqldb.h>
 
+#include "unittest.h"
+
 #include <cstdio>
 #include <iostream>
 
@@ -29,6 +31,14 @@ static Int32 main()
 {
     MySql::init();
 
+    // first the tests without server
+    if (unittest::runAll() > 0) {
+        std::cout << "Unit tests failed" << std::endl;
+
+        MySql::quit();
+        return -1;
+    }
+
     MySqlDb *mysql = new MySqlDb();
 
 	std::cout << "Connecting to the MySql db..." << std::endl;
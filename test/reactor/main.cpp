@@ -0,0 +1,201 @@
+/**
+ * @file main.cpp
+ * @brief Smoke test of MySqlReactor, with its handlers and its C++20 coroutines.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details Built as C++20 so the coroutine awaiters of the reactor are compiled,
+ * the module itself being C++14. Needs the o3dtest database of the mysql sample.
+ */
+
+#include <o3d/core/memorymanager.h>
+
+#include <o3d/core/appwindow.h>
+#include <o3d/core/main.h>
+
+#include <o3d/mysql/mysqldb.h>
+#include <o3d/mysql/mysqlreactor.h>
+
+#include <cstdlib>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <memory>
+
+#ifndef O3D_MYSQL_REACTOR
+#error "The reactor needs Linux and libmysqlclient 8.0.16 or above"
+#endif
+
+#ifndef O3D_MYSQL_COROUTINE
+#error "The coroutine awaiters of the reactor need C++20 and <coroutine>"
+#endif
+
+using namespace o3d;
+using namespace o3d::mysql;
+
+static UInt32 failures = 0;
+
+#define CHECK(EXPR) \
+    do { \
+        if (!(EXPR)) { \
+            ++failures; \
+            std::cout << "  " << __FILE__ << ":" << __LINE__ << ": check failed: " << #EXPR << std::endl; \
+        } \
+    } while (0)
+
+//! Coroutine started at once, and destroyed at its end.
+struct Task
+{
+    struct promise_type
+    {
+        Task get_return_object() { return Task(); }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+//! Sum of the integer values of the first column, fetched through the reactor.
+static Task sumRows(MySqlReactor &reactor, MySqlDb &db, Int32 &sum, Bool &done)
+{
+    try {
+        co_await reactor.connectAsync(db, "localhost", 3306, "o3dtest", "o3dtest", "o3dtest");
+
+        // buffered, fetched without wait
+        std::unique_ptr<MySqlResult> buffered = co_await reactor.executeAsync(db, "SELECT 10");
+        while (buffered->fetch()) {
+            UInt32 length;
+            sum += atoi(buffered->getText(0, length));
+        }
+
+        co_await reactor.updateAsync(db, "CREATE TEMPORARY TABLE reactor_smoke (id INT)");
+        UInt32 inserted = co_await reactor.updateAsync(db, "INSERT INTO reactor_smoke VALUES (1), (2)");
+        CHECK(inserted == 2);
+
+        // unbuffered, each row read by a poll
+        std::unique_ptr<MySqlResult> rows = co_await reactor.executeAsync(db, "SELECT id FROM reactor_smoke", False);
+        while (co_await reactor.fetchAsync(*rows)) {
+            UInt32 length;
+            sum += atoi(rows->getText(0, length));
+        }
+    } catch (E_BaseException &) {
+        std::cout << "  the coroutine failed" << std::endl;
+        ++failures;
+    }
+
+    done = True;
+}
+
+class MySqlReactorTest
+{
+public:
+
+static Int32 main()
+{
+    MySql::init();
+
+    MySqlReactor reactor;
+
+    // refused connection, reported through poll
+    {
+        MySqlDb db;
+        Bool called = False;
+        std::exception_ptr error;
+
+        reactor.connect(db, "127.0.0.1", 1, "o3dtest", "o3dtest", "o3dtest", True,
+                        [&called, &error] (std::exception_ptr e) {
+            called = True;
+            error = e;
+        });
+
+        reactor.run();
+
+        CHECK(called);
+        CHECK(error != nullptr);
+        CHECK(reactor.getNumPending() == 0);
+    }
+
+    // connect, execute and fetch with handlers, each step started by the previous one
+    {
+        MySqlDb db;
+        std::unique_ptr<MySqlResult> result;
+        Int32 sum = 0;
+        Bool ended = False;
+
+        std::function<void(Bool, std::exception_ptr)> onRow;
+        onRow = [&] (Bool hasRow, std::exception_ptr error) {
+            CHECK(error == nullptr);
+
+            if (error || !hasRow) {
+                ended = True;
+                return;
+            }
+
+            UInt32 length;
+            sum += atoi(result->getText(0, length));
+
+            reactor.fetch(*result, onRow);
+        };
+
+        reactor.connect(db, "localhost", 3306, "o3dtest", "o3dtest", "o3dtest", True,
+                        [&] (std::exception_ptr error) {
+            if (error) {
+                std::cout << "Unable to connect to the DB" << std::endl;
+                ended = True;
+                return;
+            }
+
+            reactor.execute(db, "SELECT 1 UNION ALL SELECT 2", False,
+                            [&] (MySqlResult *r, std::exception_ptr error) {
+                CHECK(error == nullptr);
+                result.reset(r);
+
+                if (error) {
+                    ended = True;
+                    return;
+                }
+
+                reactor.fetch(*result, onRow);
+            });
+        });
+
+        reactor.run();
+
+        CHECK(ended);
+        CHECK(sum == 3);
+    }
+
+    // the same through the coroutines
+    {
+        MySqlDb db;
+        Int32 sum = 0;
+        Bool done = False;
+
+        sumRows(reactor, db, sum, done);
+        reactor.run();
+
+        CHECK(done);
+        CHECK(sum == 13);
+    }
+
+    std::cout << (failures == 0 ? "Reactor ok" : "Reactor FAILED") << std::endl;
+
+    MySql::quit();
+    return failures == 0 ? 0 : -1;
+}
+};
+
+class MyAppSettings : public AppSettings
+{
+public:
+
+    MyAppSettings() : AppSettings()
+    {
+        useDisplay = false;
+        clearLog = false;
+    }
+};
+
+// We Call our application in console mode
+O3D_CONSOLE_MAIN(MySqlReactorTest, MyAppSettings)
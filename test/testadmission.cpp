@@ -0,0 +1,183 @@
+/**
+ * @file testadmission.cpp
+ * @brief Unit test of the limits and of the shedding of MySqlAdmission.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#include "unittest.h"
+
+#include <o3d/mysql/mysqladmission.h>
+#include <o3d/mysql/mysqlexception.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+using namespace o3d;
+using namespace o3d::mysql;
+
+//! Wait until a condition holds, False after a second.
+template <class F>
+static Bool waitFor(F condition)
+{
+    for (Int32 i = 0; i < 1000; ++i) {
+        if (condition()) {
+            return True;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    return False;
+}
+
+void unittest::testAdmission()
+{
+    const String select("select");
+    const String update("update");
+
+    O3D_CHECK_THROW(MySqlAdmission(0, 8), E_InvalidParameter);
+    O3D_CHECK_THROW(MySqlAdmission(8, 4), E_InvalidParameter);
+
+    // fail fast without queue, per class
+    {
+        MySqlAdmission admission(1, 4, 0, 10);
+
+        O3D_CHECK(admission.getStats(select).limit == 1.f);
+
+        MySqlAdmission::Permit running(&admission, select);
+        O3D_CHECK_THROW(MySqlAdmission::Permit(&admission, select), E_MySqlOverload);
+
+        // another class has its own limit
+        MySqlAdmission::Permit other(&admission, update);
+
+        MySqlAdmission::Stats stats = admission.getStats(select);
+        O3D_CHECK(stats.inFlight == 1);
+        O3D_CHECK(stats.admitted == 1);
+        O3D_CHECK(stats.rejected == 1);
+        O3D_CHECK(admission.getStats(update).rejected == 0);
+
+        // a null admission always admits
+        MySqlAdmission::Permit unlimited(nullptr, select);
+        unlimited.succeeded();
+    }
+
+    // a queued call is admitted once a slot is released, else rejected after max wait
+    {
+        MySqlAdmission admission(1, 4, 1, 1000);
+
+        std::unique_ptr<MySqlAdmission::Permit> running(new MySqlAdmission::Permit(&admission, select));
+
+        std::atomic<Bool> admitted(False);
+        std::thread waiting([&] () {
+            MySqlAdmission::Permit permit(&admission, select);
+            admitted = True;
+        });
+
+        O3D_CHECK(waitFor([&] () { return admission.getStats(select).queued == 1; }));
+
+        // the queue is full
+        O3D_CHECK_THROW(MySqlAdmission::Permit(&admission, select), E_MySqlOverload);
+
+        running.reset();
+        waiting.join();
+
+        O3D_CHECK(admitted);
+
+        MySqlAdmission::Stats stats = admission.getStats(select);
+        O3D_CHECK(stats.admitted == 2);
+        O3D_CHECK(stats.rejected == 1);
+        O3D_CHECK(stats.inFlight == 0 && stats.queued == 0);
+
+        // released without success, no latency sample
+        O3D_CHECK(stats.latency == 0.f && stats.limit == 1.f);
+    }
+
+    {
+        MySqlAdmission admission(1, 4, 1, 20);
+
+        MySqlAdmission::Permit running(&admission, select);
+
+        auto start = std::chrono::steady_clock::now();
+        O3D_CHECK_THROW(MySqlAdmission::Permit(&admission, select), E_MySqlOverload);
+        O3D_CHECK(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(20));
+
+        O3D_CHECK(admission.getStats(select).queued == 0);
+    }
+
+    // multiplicative decrease on timeout, once per window of limit statements
+    {
+        MySqlAdmission admission(4, 16, 0, 0);
+        admission.setBackoff(0.5f);
+        admission.setMinLimit(2);
+
+        for (Int32 i = 0; i < 3; ++i) {
+            MySqlAdmission::Permit permit(&admission, select);
+            permit.overloaded();
+        }
+
+        O3D_CHECK(admission.getStats(select).limit == 4.f);
+
+        {
+            MySqlAdmission::Permit permit(&admission, select);
+            permit.overloaded();
+        }
+
+        O3D_CHECK(admission.getStats(select).limit == 2.f);
+
+        // down to the min limit
+        for (Int32 i = 0; i < 4; ++i) {
+            MySqlAdmission::Permit permit(&admission, select);
+            permit.overloaded();
+        }
+
+        O3D_CHECK(admission.getStats(select).limit == 2.f);
+
+        O3D_CHECK_THROW(admission.setBackoff(1.f), E_InvalidParameter);
+        O3D_CHECK_THROW(admission.setTolerance(1.f), E_InvalidParameter);
+        O3D_CHECK_THROW(admission.setMinLimit(17), E_InvalidParameter);
+    }
+
+    // additive increase while the limit is used, the first sample being the baseline
+    {
+        MySqlAdmission admission(2, 8, 0, 0);
+
+        MySqlAdmission::Permit first(&admission, select);
+        MySqlAdmission::Permit second(&admission, select);
+
+        first.succeeded();
+
+        MySqlAdmission::Stats stats = admission.getStats(select);
+        O3D_CHECK(stats.limit == 2.5f);
+        O3D_CHECK(stats.latency > 0.f && stats.latency == stats.baseline);
+
+        // a second call of the permit is ignored
+        first.succeeded();
+        O3D_CHECK(admission.getStats(select).inFlight == 1);
+    }
+
+    {
+        // bounded by the max limit
+        MySqlAdmission admission(2, 2, 0, 0);
+
+        MySqlAdmission::Permit first(&admission, select);
+        MySqlAdmission::Permit second(&admission, select);
+
+        first.succeeded();
+        O3D_CHECK(admission.getStats(select).limit == 2.f);
+    }
+
+    {
+        // not increased while the limit is not used
+        MySqlAdmission admission(2, 8, 0, 0);
+
+        MySqlAdmission::Permit permit(&admission, select);
+        permit.succeeded();
+
+        O3D_CHECK(admission.getStats(select).limit == 2.f);
+    }
+}
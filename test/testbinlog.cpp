@@ -0,0 +1,311 @@
+/**
+ * @file testbinlog.cpp
+ * @brief Unit test of the decoding of the binary log events of MySqlBinlogClient.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#include "unittest.h"
+
+#include <o3d/mysql/mysqlbinlogclient.h>
+#include <o3d/mysql/mysqldb.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace o3d;
+using namespace o3d::mysql;
+
+static const UInt8 ROTATE_EVENT = 4;
+static const UInt8 TABLE_MAP_EVENT = 19;
+static const UInt8 WRITE_ROWS_EVENT = 30;
+static const UInt8 UPDATE_ROWS_EVENT = 31;
+static const UInt8 DELETE_ROWS_EVENT = 32;
+
+//! Bytes of an event, little endian.
+struct Bytes
+{
+    std::vector<UInt8> data;
+
+    Bytes& u8(UInt8 v) { data.push_back(v); return *this; }
+    Bytes& le(UInt64 v, size_t size) { for (size_t i = 0; i < size; ++i) data.push_back((UInt8)(v >> (8 * i))); return *this; }
+    Bytes& str(const std::string &v) { data.insert(data.end(), v.begin(), v.end()); return *this; }
+    Bytes& add(const Bytes &v) { data.insert(data.end(), v.data.begin(), v.data.end()); return *this; }
+};
+
+//! Event with its header, without checksum.
+static Bytes event(UInt8 type, const Bytes &body, UInt32 nextPosition)
+{
+    Bytes e;
+    e.le(0, 4).u8(type).le(1, 4).le(19 + body.data.size(), 4).le(nextPosition, 4).le(0, 2);
+    e.add(body);
+
+    return e;
+}
+
+static void process(MySqlBinlogClient &client, const Bytes &e)
+{
+    client.processEvent(e.data.data(), e.data.size());
+}
+
+/**
+ * Table test.users, its id being unsigned:
+ * id BIGINT UNSIGNED, name VARCHAR(64), score DECIMAL(10,2), created DATETIME(3),
+ * code CHAR(4), flags BIT(10), notes BLOB.
+ */
+static Bytes usersMap(UInt64 tableId)
+{
+    Bytes body;
+    body.le(tableId, 6).le(0, 2);
+    body.u8(4).str("test").u8(0);
+    body.u8(5).str("users").u8(0);
+
+    // types
+    body.u8(7);
+    body.u8(MYSQL_TYPE_LONGLONG).u8(MYSQL_TYPE_VARCHAR).u8(MYSQL_TYPE_NEWDECIMAL)
+        .u8(MYSQL_TYPE_DATETIME2).u8(MYSQL_TYPE_STRING).u8(MYSQL_TYPE_BIT).u8(MYSQL_TYPE_BLOB);
+
+    // metadata: varchar max length, decimal precision and scale, fraction digits,
+    // real type and length, bits and bytes, length size
+    Bytes metadata;
+    metadata.le(64, 2).u8(10).u8(2).u8(3).u8(MYSQL_TYPE_STRING).u8(4).u8(2).u8(1).u8(2);
+
+    body.u8((UInt8)metadata.data.size()).add(metadata);
+
+    // nullable columns
+    body.u8(0x7e);
+
+    // signedness of the numeric columns id and score
+    body.u8(1).u8(1).u8(0x80);
+
+    return body;
+}
+
+/**
+ * Table test.scores: day VARCHAR(300), user INT, a key of (user, day).
+ */
+static Bytes scoresMap(UInt64 tableId)
+{
+    Bytes body;
+    body.le(tableId, 6).le(0, 2);
+    body.u8(4).str("test").u8(0);
+    body.u8(6).str("scores").u8(0);
+
+    body.u8(2).u8(MYSQL_TYPE_VARCHAR).u8(MYSQL_TYPE_LONG);
+    body.u8(2).le(300, 2);
+    body.u8(0);
+
+    return body;
+}
+
+//! Every column of a users row.
+static Bytes usersImage(UInt64 id, const std::string &name)
+{
+    Bytes image;
+
+    // null bitmap of the present columns, notes being null
+    image.u8(0x40);
+    image.le(id, 8);
+    image.u8((UInt8)name.size()).str(name);
+    image.le(0x8000000001ull, 5);     // decimal
+    image.le(0, 5).le(0, 2);          // datetime with milliseconds
+    image.u8(2).str("ab");
+    image.le(0x3ff, 2);
+
+    return image;
+}
+
+//! Body of a rows event of version 2, the rows following.
+static Bytes rowsHeader(UInt64 tableId, size_t numColumns, UInt8 present, Int32 presentAfter = -1)
+{
+    Bytes body;
+    body.le(tableId, 6).le(0, 2).le(2, 2);
+    body.u8((UInt8)numColumns).u8(present);
+
+    if (presentAfter >= 0) {
+        body.u8((UInt8)presentAfter);
+    }
+
+    return body;
+}
+
+static void testValueSize()
+{
+    UInt8 buffer[16];
+    memset(buffer, 0, sizeof(buffer));
+
+    const UInt8 *end = buffer + sizeof(buffer);
+
+    O3D_CHECK(MySqlBinlogClient::valueSize(MYSQL_TYPE_TINY, 0, buffer, end) == 1);
+    O3D_CHECK(MySqlBinlogClient::valueSize(MYSQL_TYPE_INT24, 0, buffer, end) == 3);
+    O3D_CHECK(MySqlBinlogClient::valueSize(MYSQL_TYPE_LONGLONG, 0, buffer, end) == 8);
+
+    // fraction digits on (digits + 1) / 2 bytes
+    O3D_CHECK(MySqlBinlogClient::valueSize(MYSQL_TYPE_TIMESTAMP2, 0, buffer, end) == 4);
+    O3D_CHECK(MySqlBinlogClient::valueSize(MYSQL_TYPE_DATETIME2, 3, buffer, end) == 7);
+    O3D_CHECK(MySqlBinlogClient::valueSize(MYSQL_TYPE_TIME2, 6, buffer, end) == 6);
+
+    // 9 digits on 4 bytes, the others on 1 to 4
+    O3D_CHECK(MySqlBinlogClient::valueSize(MYSQL_TYPE_NEWDECIMAL, (10 << 8) | 2, buffer, end) == 5);
+    O3D_CHECK(MySqlBinlogClient::valueSize(MYSQL_TYPE_NEWDECIMAL, (20 << 8) | 0, buffer, end) == 9);
+    O3D_CHECK(MySqlBinlogClient::valueSize(MYSQL_TYPE_NEWDECIMAL, (18 << 8) | 9, buffer, end) == 8);
+
+    // bytes then remaining bits
+    O3D_CHECK(MySqlBinlogClient::valueSize(MYSQL_TYPE_BIT, (1 << 8) | 2, buffer, end) == 2);
+    O3D_CHECK(MySqlBinlogClient::valueSize(MYSQL_TYPE_BIT, (1 << 8) | 0, buffer, end) == 1);
+
+    // one or two bytes of length
+    buffer[0] = 5;
+    O3D_CHECK(MySqlBinlogClient::valueSize(MYSQL_TYPE_VARCHAR, 64, buffer, end) == 6);
+    O3D_CHECK(MySqlBinlogClient::valueSize(MYSQL_TYPE_VARCHAR, 300, buffer, end) == 7);
+
+    // CHAR(4), ENUM as a string, and CHAR(300) of which the high bits of the length
+    // are stored into the real type
+    O3D_CHECK(MySqlBinlogClient::valueSize(MYSQL_TYPE_STRING, (MYSQL_TYPE_STRING << 8) | 4, buffer, end) == 6);
+    O3D_CHECK(MySqlBinlogClient::valueSize(MYSQL_TYPE_STRING, (MYSQL_TYPE_ENUM << 8) | 1, buffer, end) == 1);
+    O3D_CHECK(MySqlBinlogClient::valueSize(MYSQL_TYPE_STRING, (0xee << 8) | 0x2c, buffer, end) == 7);
+
+    // length size in the metadata
+    O3D_CHECK(MySqlBinlogClient::valueSize(MYSQL_TYPE_BLOB, 2, buffer, end) == 7);
+
+    // beyond the event, or of an unknown type
+    buffer[0] = 200;
+    O3D_CHECK_THROW(MySqlBinlogClient::valueSize(MYSQL_TYPE_VARCHAR, 64, buffer, end), E_InvalidFormat);
+    O3D_CHECK_THROW(MySqlBinlogClient::valueSize(MYSQL_TYPE_LONGLONG, 0, end - 4, end), E_InvalidFormat);
+    O3D_CHECK_THROW(MySqlBinlogClient::valueSize(200, 0, buffer, end), E_InvalidFormat);
+}
+
+void unittest::testBinlog()
+{
+    testValueSize();
+
+    MySqlDb db;
+    MySqlBinlogClient client(&db, 1001);
+
+    std::vector<MySqlBinlogClient::Change> users;
+    std::vector<MySqlBinlogClient::Change> scores;
+
+    client.subscribe("test", "users", { 0 }, [&users] (const MySqlBinlogClient::Change &c) {
+        users.push_back(c);
+    });
+
+    client.subscribe("test", "scores", { 1, 0 }, [&scores] (const MySqlBinlogClient::Change &c) {
+        scores.push_back(c);
+    });
+
+    process(client, event(TABLE_MAP_EVENT, usersMap(70), 200));
+    process(client, event(TABLE_MAP_EVENT, scoresMap(71), 300));
+
+    O3D_CHECK(client.getPosition().offset == 300);
+
+    // rows of an unknown table id, a transaction started before the stream
+    process(client, event(WRITE_ROWS_EVENT, rowsHeader(99, 7, 0x7f).add(usersImage(1, "x")), 350));
+    O3D_CHECK(users.empty());
+    O3D_CHECK(client.getPosition().offset == 350);
+
+    // two inserted rows, an unsigned key above the signed range
+    const UInt64 big = ((UInt64)1 << 63) + 5;
+
+    process(client, event(WRITE_ROWS_EVENT,
+                          rowsHeader(70, 7, 0x7f).add(usersImage(big, "alice")).add(usersImage(2, "")),
+                          400));
+
+    O3D_CHECK(users.size() == 2);
+    if (users.size() == 2) {
+        MySqlParams expected;
+        expected.setUInt64(0, big);
+
+        O3D_CHECK(users[0].operation == MySqlBinlogClient::OP_INSERT);
+        O3D_CHECK(users[0].database == "test" && users[0].table == "users");
+        O3D_CHECK(users[0].key.getType(0) == MySqlParams::T_UINT64);
+        O3D_CHECK(users[0].key.equal(0, expected));
+        O3D_CHECK(users[0].newKey.equal(0, expected));
+
+        expected.setUInt64(0, 2);
+        O3D_CHECK(users[1].key.equal(0, expected));
+    }
+
+    // update of the key, with full images
+    users.clear();
+    process(client, event(UPDATE_ROWS_EVENT,
+                          rowsHeader(70, 7, 0x7f, 0x7f).add(usersImage(2, "bob")).add(usersImage(3, "bob")),
+                          500));
+
+    O3D_CHECK(users.size() == 1);
+    if (users.size() == 1) {
+        MySqlParams before, after;
+        before.setUInt64(0, 2);
+        after.setUInt64(0, 3);
+
+        O3D_CHECK(users[0].operation == MySqlBinlogClient::OP_UPDATE);
+        O3D_CHECK(users[0].key.equal(0, before));
+        O3D_CHECK(users[0].newKey.equal(0, after));
+    }
+
+    // minimal images: the key before, only the changed name after
+    users.clear();
+
+    Bytes minimal = rowsHeader(70, 7, 0x01, 0x02);
+    minimal.u8(0).le(7, 8);
+    minimal.u8(0).u8(3).str("eve");
+
+    process(client, event(UPDATE_ROWS_EVENT, minimal, 600));
+
+    O3D_CHECK(users.size() == 1);
+    if (users.size() == 1) {
+        MySqlParams expected;
+        expected.setUInt64(0, 7);
+
+        O3D_CHECK(users[0].key.equal(0, expected));
+        O3D_CHECK(users[0].newKey.equal(0, expected));
+    }
+
+    // a before image without the key
+    Bytes keyless = rowsHeader(70, 7, 0x02);
+    keyless.u8(0).u8(3).str("eve");
+
+    O3D_CHECK_THROW(process(client, event(DELETE_ROWS_EVENT, keyless, 700)), E_InvalidFormat);
+
+    // a compound key in the order of the subscription, a signed integer
+    Bytes deleted = rowsHeader(71, 2, 0x03);
+    deleted.u8(0).le(10, 2).str("2026-10-19").le((UInt32)-7, 4);
+
+    process(client, event(DELETE_ROWS_EVENT, deleted, 800));
+
+    O3D_CHECK(scores.size() == 1);
+    if (scores.size() == 1) {
+        MySqlParams expected;
+        expected.setInt32(0, -7);
+        expected.setCString(1, "2026-10-19");
+
+        O3D_CHECK(scores[0].operation == MySqlBinlogClient::OP_DELETE);
+        O3D_CHECK(scores[0].key.getNumParams() == 2);
+        O3D_CHECK(scores[0].key.equal(0, expected));
+        O3D_CHECK(scores[0].key.equal(1, expected));
+    }
+
+    // a row going beyond its event
+    Bytes truncated = rowsHeader(71, 2, 0x03);
+    truncated.u8(0).le(20, 2).str("2026");
+
+    O3D_CHECK_THROW(process(client, event(DELETE_ROWS_EVENT, truncated, 900)), E_InvalidFormat);
+
+    // a truncated table map
+    Bytes map = scoresMap(72);
+    map.data.resize(12);
+
+    O3D_CHECK_THROW(process(client, event(TABLE_MAP_EVENT, map, 1000)), E_InvalidFormat);
+
+    // the table ids are only valid in their file
+    process(client, event(ROTATE_EVENT, Bytes().le(4, 8).str("binlog.000002"), 0));
+
+    O3D_CHECK(client.getPosition().file == "binlog.000002");
+    O3D_CHECK(client.getPosition().offset == 4);
+
+    scores.clear();
+    process(client, event(DELETE_ROWS_EVENT, deleted, 1100));
+    O3D_CHECK(scores.empty());
+}
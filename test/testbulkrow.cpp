@@ -0,0 +1,63 @@
+/**
+ * @file testbulkrow.cpp
+ * @brief Unit test of the MySqlBulkRow encoding.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#include "unittest.h"
+
+#include <o3d/mysql/mysqlbulkloader.h>
+
+#include <string>
+
+using namespace o3d;
+using namespace o3d::mysql;
+
+void unittest::testBulkRow()
+{
+    // default terminators
+    {
+        std::string buffer;
+        MySqlBulkRow row(buffer, '\t', '\n');
+
+        row.addInt32(-12);
+        row.addUInt64(18446744073709551615ULL);
+        row.addNull();
+        row.addBool(True);
+        row.addCString("a\tb\nc\\d\re");
+
+        const UInt8 data[] = { 'x', 0, 'y' };
+        row.addData(data, sizeof(data));
+
+        // empty, distinct of null
+        row.addCString("");
+
+        O3D_CHECK(row.getNumFields() == 7);
+        O3D_CHECK(buffer == "-12\t18446744073709551615\t\\N\t1\ta\\tb\\nc\\\\d\\re\tx\\0y\t");
+    }
+
+    // custom terminators are escaped within the values
+    {
+        std::string buffer("previous;");
+        MySqlBulkRow row(buffer, ',', ';');
+
+        row.addCString("1,2;3");
+        row.addInt64(-9223372036854775807LL - 1);
+
+        O3D_CHECK(row.getNumFields() == 2);
+        O3D_CHECK(buffer == "previous;1\\,2\\;3,-9223372036854775808");
+    }
+
+    // a value with the bit 7 set is not a terminator
+    {
+        std::string buffer;
+        MySqlBulkRow row(buffer, '\t', '\n');
+
+        row.addCString("\xc3\xa9t\xc3\xa9");
+
+        O3D_CHECK(buffer == "\xc3\xa9t\xc3\xa9");
+    }
+}
@@ -0,0 +1,103 @@
+/**
+ * @file testdecoder.cpp
+ * @brief Unit test of the DECIMAL, BIT and date conversions of MySqlQuery.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#include "unittest.h"
+
+#include <o3d/mysql/mysqldb.h>
+
+#include <cstring>
+
+using namespace o3d;
+using namespace o3d::mysql;
+
+//! Decode a DECIMAL text, returning False if rejected.
+static Bool decimal(const Char *text, UInt32 scale, Int64 &value)
+{
+    value = 0x5a5a;
+    return MySqlQuery::decodeDecimal(text, strlen(text), scale, value);
+}
+
+void unittest::testDecoder()
+{
+    Int64 v;
+
+    // DECIMAL scaled by its decimals
+    O3D_CHECK(decimal("0", 0, v) && v == 0);
+    O3D_CHECK(decimal("123.45", 2, v) && v == 12345);
+    O3D_CHECK(decimal("-123.45", 2, v) && v == -12345);
+    O3D_CHECK(decimal("+7.5", 1, v) && v == 75);
+    O3D_CHECK(decimal("-0.01", 2, v) && v == -1);
+    O3D_CHECK(decimal(".5", 1, v) && v == 5);
+
+    // missing decimals are zeros, extra decimals are truncated
+    O3D_CHECK(decimal("42", 3, v) && v == 42000);
+    O3D_CHECK(decimal("1.2", 4, v) && v == 12000);
+    O3D_CHECK(decimal("1.23456", 2, v) && v == 123);
+    O3D_CHECK(decimal("-1.239", 2, v) && v == -123);
+
+    // Int64 limits
+    O3D_CHECK(decimal("9223372036854775807", 0, v) && v == 9223372036854775807LL);
+    O3D_CHECK(decimal("-9223372036854775808", 0, v) && v == -9223372036854775807LL - 1);
+    O3D_CHECK(decimal("92233720368547758.07", 2, v) && v == 9223372036854775807LL);
+    O3D_CHECK(!decimal("9223372036854775808", 0, v));
+    O3D_CHECK(!decimal("-9223372036854775809", 0, v));
+    O3D_CHECK(!decimal("92233720368547758.08", 2, v));
+    O3D_CHECK(!decimal("1", 19, v));
+    O3D_CHECK(!decimal("99999999999999999999999999999999999999", 0, v));
+
+    // not a number
+    O3D_CHECK(!decimal("12a", 0, v));
+    O3D_CHECK(!decimal("1e5", 0, v));
+    O3D_CHECK(!decimal(" 1", 0, v));
+
+    // only the given length
+    O3D_CHECK(MySqlQuery::decodeDecimal("12.349", 5, 2, v) && v == 1234);
+
+    // BIT big endian
+    const UInt8 bits[] = { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09 };
+
+    O3D_CHECK(MySqlQuery::decodeBit(bits, 0) == 0);
+    O3D_CHECK(MySqlQuery::decodeBit(bits, 1) == 0x01);
+    O3D_CHECK(MySqlQuery::decodeBit(bits, 3) == 0x010203);
+    O3D_CHECK(MySqlQuery::decodeBit(bits, 8) == 0x0102030405060708ULL);
+    O3D_CHECK(MySqlQuery::decodeBit(bits, 9) == 0x0203040506070809ULL);
+
+    const UInt8 ones[] = { 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff };
+    O3D_CHECK(MySqlQuery::decodeBit(ones, 8) == 0xffffffffffffffffULL);
+
+    // packed dates are ordered as the dates
+    MYSQL_TIME t;
+    memset(&t, 0, sizeof(MYSQL_TIME));
+    t.year = 2024;
+    t.month = 2;
+    t.day = 29;
+    t.hour = 23;
+    t.minute = 59;
+    t.second = 58;
+    t.time_type = MYSQL_TIMESTAMP_DATETIME;
+
+    const UInt64 packed = MySqlQuery::packTime(t);
+    O3D_CHECK(packed == ((2024ULL << 40) | (2ULL << 32) | (29ULL << 24) | (23 << 16) | (59 << 8) | 58));
+
+    t.second = 59;
+    O3D_CHECK(MySqlQuery::packTime(t) > packed);
+
+    t.year = 2023;
+    t.month = 12;
+    t.day = 31;
+    O3D_CHECK(MySqlQuery::packTime(t) < packed);
+
+    // a TIME duration is not packed
+    t.hour = 100;
+    O3D_CHECK_THROW(MySqlQuery::packTime(t), E_InvalidResult);
+
+    t.hour = 1;
+    t.neg = True;
+    O3D_CHECK_THROW(MySqlQuery::packTime(t), E_InvalidResult);
+}
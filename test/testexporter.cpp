@@ -0,0 +1,277 @@
+/**
+ * @file testexporter.cpp
+ * @brief Unit test of the CSV and columnar output of MySqlExporter.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#include "unittest.h"
+
+#include <o3d/mysql/mysqlexporter.h>
+#include <o3d/mysql/mysqldb.h>
+#include <o3d/mysql/mysqldbvariable.h>
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace o3d;
+using namespace o3d::mysql;
+
+//! Field written by an exporter.
+static std::string csvField(MySqlExporter &exporter, const std::string &text)
+{
+    std::ostringstream out;
+    exporter.writeCsvField(text.data(), text.size(), out);
+    return out.str();
+}
+
+namespace {
+
+//! A value of a row, raw bytes of the variable or string data.
+struct Cell
+{
+    Bool null;
+    std::string bytes;
+};
+
+template <class T>
+static Cell cell(T value)
+{
+    return Cell { False, std::string((const char*)&value, sizeof(T)) };
+}
+
+static Cell text(const std::string &value)
+{
+    return Cell { False, value };
+}
+
+static const Cell NULL_CELL = { True, std::string() };
+
+//! Rows given in memory, as a query fetching them.
+class RowSource : public MySqlExporter::Source
+{
+public:
+
+    void addColumn(const CString &name, DbVariable::IntType intType, DbVariable::VarType varType,
+                   UInt32 size, UInt32 decimals = 0)
+    {
+        m_names.push_back(name);
+        m_decimals.push_back(decimals);
+        m_vars.emplace_back(new MySqlDbVariable(intType, varType, size));
+    }
+
+    void addRow(const std::vector<Cell> &row) { m_rows.push_back(row); }
+
+    virtual UInt32 getNumColumns() const override { return (UInt32)m_vars.size(); }
+    virtual CString getColumnName(UInt32 col) const override { return m_names[col]; }
+    virtual UInt32 getColumnDecimals(UInt32 col) const override { return m_decimals[col]; }
+
+    virtual Bool next() override
+    {
+        if (m_row >= m_rows.size()) {
+            return False;
+        }
+
+        const std::vector<Cell> &row = m_rows[m_row++];
+
+        for (size_t i = 0; i < m_vars.size(); ++i) {
+            MySqlDbVariable &var = *m_vars[i];
+            const Cell &c = row[i];
+
+            var.setNull(c.null);
+
+            const DbVariable::IntType intType = var.getIntType();
+            if (!c.null && intType != DbVariable::IT_ARRAY_CHAR && intType != DbVariable::IT_ARRAY_UINT8) {
+                memcpy(var.getObjectPtr(), c.bytes.data(), c.bytes.size());
+                var.setLength((UInt32)c.bytes.size());
+            }
+        }
+
+        return True;
+    }
+
+    virtual const DbVariable& getOut(UInt32 col) const override { return *m_vars[col]; }
+
+    virtual const UInt8* getOutData(UInt32 col, UInt32 &length) const override
+    {
+        const Cell &c = m_rows[m_row - 1][col];
+        length = (UInt32)c.bytes.size();
+        return c.null ? nullptr : (const UInt8*)c.bytes.data();
+    }
+
+private:
+
+    std::vector<CString> m_names;
+    std::vector<UInt32> m_decimals;
+    std::vector<std::unique_ptr<MySqlDbVariable>> m_vars;
+    std::vector<std::vector<Cell>> m_rows;
+    size_t m_row = 0;
+};
+
+//! Expected bytes of a columnar file.
+struct Bytes
+{
+    std::string data;
+
+    Bytes& u8(UInt8 v) { data.push_back((char)v); return *this; }
+    Bytes& u32(UInt32 v) { data.append((const char*)&v, 4); return *this; }
+    Bytes& i32(Int32 v) { data.append((const char*)&v, 4); return *this; }
+    Bytes& str(const std::string &v) { data.append(v); return *this; }
+};
+
+static MYSQL_TIME mysqlTime(enum_mysql_timestamp_type type,
+                            UInt32 year, UInt32 month, UInt32 day,
+                            UInt32 hour, UInt32 minute, UInt32 second, Bool neg = False)
+{
+    MYSQL_TIME t;
+    memset(&t, 0, sizeof(MYSQL_TIME));
+
+    t.year = year; t.month = month; t.day = day;
+    t.hour = hour; t.minute = minute; t.second = second;
+    t.neg = neg;
+    t.time_type = type;
+
+    return t;
+}
+
+} // anonymous namespace
+
+//! CSV of every value type, a row per line.
+static void testExporterCsv()
+{
+    RowSource source;
+
+    source.addColumn("i64", DbVariable::IT_INT64, DbVariable::INT64, 8);
+    source.addColumn("u64", DbVariable::IT_INT64, DbVariable::UINT64, 8);
+    source.addColumn("price", DbVariable::IT_INT64, DbVariable::INT64, 8, 2);
+    source.addColumn("delta", DbVariable::IT_INT64, DbVariable::INT64, 8, 1);
+    source.addColumn("day", DbVariable::IT_DATE, DbVariable::TIMESTAMP, sizeof(MYSQL_TIME));
+    source.addColumn("at", DbVariable::IT_DATETIME, DbVariable::TIMESTAMP, sizeof(MYSQL_TIME));
+    source.addColumn("name", DbVariable::IT_ARRAY_CHAR, DbVariable::VARCHAR, 16);
+    source.addColumn("blob", DbVariable::IT_ARRAY_UINT8, DbVariable::ARRAY, 16);
+
+    source.addRow({
+        cell<Int64>(INT64_MIN),
+        cell<UInt64>((UInt64)INT64_MAX + 1),
+        cell<Int64>(5),
+        cell<Int64>(-5),
+        cell(mysqlTime(MYSQL_TIMESTAMP_DATE, 2026, 1, 2, 0, 0, 0)),
+        cell(mysqlTime(MYSQL_TIMESTAMP_DATETIME, 2026, 10, 19, 8, 5, 9)),
+        text("a,b"),
+        text(std::string("\x00\xab", 2)) });
+
+    source.addRow({
+        cell<Int64>(INT64_MAX),
+        cell<UInt64>(UINT64_MAX),
+        cell<Int64>(-12345),
+        cell<Int64>(0),
+        NULL_CELL,
+        cell(mysqlTime(MYSQL_TIMESTAMP_TIME, 0, 0, 0, 838, 59, 59, True)),
+        NULL_CELL,
+        text("") });
+
+    MySqlExporter exporter;
+    exporter.setNullText("\\N");
+
+    std::ostringstream out;
+    MySqlExporter::Stats stats = exporter.exportSource(source, out);
+
+    O3D_CHECK(stats.rows == 2);
+    O3D_CHECK(stats.bytes == out.str().size());
+    O3D_CHECK(out.str() ==
+              "i64,u64,price,delta,day,at,name,blob\r\n"
+              "-9223372036854775808,9223372036854775808,0.05,-0.5,2026-01-02,2026-10-19 08:05:09,\"a,b\",00ab\r\n"
+              "9223372036854775807,18446744073709551615,-123.45,0.0,\\N,-838:59:59,\\N,\r\n");
+
+    // without header nor row
+    RowSource empty;
+    empty.addColumn("id", DbVariable::IT_INT32, DbVariable::INT32, 4);
+
+    exporter.setHeader(False);
+
+    std::ostringstream none;
+    O3D_CHECK(exporter.exportSource(empty, none).rows == 0);
+    O3D_CHECK(none.str().empty());
+}
+
+//! Columnar header, row groups with their null bitmaps and offsets, terminator.
+static void testExporterColumnar()
+{
+    RowSource source;
+
+    source.addColumn("id", DbVariable::IT_INT32, DbVariable::INT32, 4);
+    source.addColumn("name", DbVariable::IT_ARRAY_CHAR, DbVariable::VARCHAR, 16);
+
+    source.addRow({ cell<Int32>(1), text("ab") });
+    source.addRow({ NULL_CELL, text("c") });
+    source.addRow({ cell<Int32>(-3), NULL_CELL });
+
+    MySqlExporter exporter(MySqlExporter::FORMAT_COLUMNAR);
+    exporter.setRowGroupSize(2);
+
+    std::ostringstream out;
+    MySqlExporter::Stats stats = exporter.exportSource(source, out);
+
+    Bytes expected;
+
+    // header
+    expected.str(std::string("O3DCOL\0\0", 8)).u32(1).u32(2)
+            .u8(DbVariable::IT_INT32).u8(0).u32(2).str("id")
+            .u8(DbVariable::IT_ARRAY_CHAR).u8(0).u32(4).str("name");
+
+    // rows 1 and 2, the second id being null
+    expected.u32(2)
+            .u8(0x02).i32(1).i32(0)
+            .u8(0x00).u32(0).u32(2).u32(3).str("abc");
+
+    // row 3, a null name
+    expected.u32(1)
+            .u8(0x00).i32(-3)
+            .u8(0x01).u32(0).u32(0);
+
+    // end of file
+    expected.u32(0);
+
+    O3D_CHECK(stats.rows == 3);
+    O3D_CHECK(stats.bytes == expected.data.size());
+    O3D_CHECK(out.str() == expected.data);
+}
+
+void unittest::testExporter()
+{
+    testExporterCsv();
+    testExporterColumnar();
+
+    MySqlExporter exporter;
+
+    // as is
+    O3D_CHECK(csvField(exporter, "") == "");
+    O3D_CHECK(csvField(exporter, "plain text") == "plain text");
+    O3D_CHECK(csvField(exporter, "semi;colon") == "semi;colon");
+    O3D_CHECK(csvField(exporter, "\xc3\xa9t\xc3\xa9") == "\xc3\xa9t\xc3\xa9");
+
+    // quoted
+    O3D_CHECK(csvField(exporter, "a,b") == "\"a,b\"");
+    O3D_CHECK(csvField(exporter, "line\nbreak") == "\"line\nbreak\"");
+    O3D_CHECK(csvField(exporter, "cr\r") == "\"cr\r\"");
+    O3D_CHECK(csvField(exporter, "say \"hi\"") == "\"say \"\"hi\"\"\"");
+    O3D_CHECK(csvField(exporter, "\"") == "\"\"\"\"");
+
+    // with another delimiter
+    exporter.setDelimiter(';');
+    O3D_CHECK(csvField(exporter, "a,b") == "a,b");
+    O3D_CHECK(csvField(exporter, "semi;colon") == "\"semi;colon\"");
+
+    // longer than the write buffer
+    exporter.setBufferSize(16);
+    std::string large(100, 'q');
+    large[50] = '"';
+    const std::string expected = "\"" + large.substr(0, 51) + "\"" + large.substr(51) + "\"";
+    O3D_CHECK(csvField(exporter, large) == expected);
+}
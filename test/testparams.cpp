@@ -0,0 +1,114 @@
+/**
+ * @file testparams.cpp
+ * @brief Unit test of the hash, comparison and sum of MySqlParams.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#include "unittest.h"
+
+#include <o3d/mysql/mysqlparams.h>
+
+using namespace o3d;
+using namespace o3d::mysql;
+
+void unittest::testParams()
+{
+    // integers compare as 64 bits values, whatever their type
+    {
+        MySqlParams a, b;
+        a.setInt32(0, 42);
+        b.setInt64(0, 42);
+
+        O3D_CHECK(a.hash(0) == b.hash(0));
+        O3D_CHECK(a.equal(0, b) && b.equal(0, a));
+
+        b.setUInt32(0, 42);
+        O3D_CHECK(a.hash(0) == b.hash(0));
+        O3D_CHECK(a.equal(0, b));
+
+        b.setInt64(0, 43);
+        O3D_CHECK(a.hash(0) != b.hash(0));
+        O3D_CHECK(!a.equal(0, b));
+
+        // a negative Int32 is sign extended
+        a.setInt32(0, -1);
+        b.setInt64(0, -1);
+        O3D_CHECK(a.hash(0) == b.hash(0));
+        O3D_CHECK(a.equal(0, b));
+    }
+
+    // a float and a double of same value
+    {
+        MySqlParams a, b;
+        a.setFloat(0, 1.5f);
+        b.setDouble(0, 1.5);
+
+        O3D_CHECK(a.hash(0) == b.hash(0));
+        O3D_CHECK(a.equal(0, b));
+
+        // not an integer
+        b.setInt32(0, 1);
+        O3D_CHECK(!a.equal(0, b));
+    }
+
+    // strings and bytes
+    {
+        MySqlParams a, b;
+        a.setCString(0, "key");
+        b.setCString(0, "key");
+
+        O3D_CHECK(a.hash(0) == b.hash(0));
+        O3D_CHECK(a.equal(0, b));
+
+        b.setCString(0, "kez");
+        O3D_CHECK(a.hash(0) != b.hash(0));
+        O3D_CHECK(!a.equal(0, b));
+
+        // same bytes, not the same type
+        const UInt8 bytes[] = { 'k', 'e', 'y' };
+        b.setBytes(0, bytes, sizeof(bytes));
+        O3D_CHECK(!a.equal(0, b));
+
+        a.setBytes(0, bytes, sizeof(bytes));
+        O3D_CHECK(a.hash(0) == b.hash(0));
+        O3D_CHECK(a.equal(0, b));
+
+        a.setBytes(0, bytes, 2);
+        O3D_CHECK(!a.equal(0, b));
+    }
+
+    // sums keep the type of the destination
+    {
+        MySqlParams a, b, c;
+        a.setInt32(0, -2);
+        b.setUInt64(0, 5);
+        a.add(0, b);
+
+        c.setInt64(0, 3);
+        O3D_CHECK(a.getType(0) == MySqlParams::T_INT32);
+        O3D_CHECK(a.equal(0, c));
+
+        a.setDouble(0, 0.5);
+        a.add(0, b);
+        c.setDouble(0, 5.5);
+        O3D_CHECK(a.equal(0, c));
+
+        b.setCString(0, "5");
+        O3D_CHECK_THROW(a.add(0, b), E_InvalidParameter);
+    }
+
+    // undefined attributes
+    {
+        MySqlParams a, b;
+        a.setInt32(1, 0);
+        b.setInt32(1, 0);
+
+        O3D_CHECK(a.getNumParams() == 2);
+        O3D_CHECK(a.getType(0) == MySqlParams::T_UNDEFINED);
+        O3D_CHECK_THROW(a.hash(0), E_InvalidParameter);
+        O3D_CHECK_THROW(a.equal(0, b), E_InvalidParameter);
+    }
+}
@@ -0,0 +1,279 @@
+/**
+ * @file testrowset.cpp
+ * @brief Unit test of MySqlRowSetBuilder and MySqlRowSet.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#include "unittest.h"
+
+#include <o3d/mysql/mysqlrowset.h>
+#include <o3d/mysql/mysqldbvariable.h>
+
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace o3d;
+using namespace o3d::mysql;
+
+//! Fill a fetched variable.
+template <class T>
+static void setVar(MySqlDbVariable &var, T value)
+{
+    memcpy(var.getObjectPtr(), &value, sizeof(T));
+    var.setLength(sizeof(T));
+    var.setNull(False);
+}
+
+void unittest::testRowSet()
+{
+    MySqlRowSetBuilder builder;
+
+    builder.addColumn("i8", DbVariable::IT_INT8, DbVariable::INT8);
+    builder.addColumn("u8", DbVariable::IT_INT8, DbVariable::UINT8);
+    builder.addColumn("i16", DbVariable::IT_INT16, DbVariable::INT16);
+    builder.addColumn("u16", DbVariable::IT_INT16, DbVariable::UINT16);
+    builder.addColumn("u32", DbVariable::IT_INT32, DbVariable::UINT32);
+    builder.addColumn("u64", DbVariable::IT_INT64, DbVariable::UINT64);
+    builder.addColumn("price", DbVariable::IT_INT64, DbVariable::INT64, 2);
+    builder.addColumn("ratio", DbVariable::IT_DOUBLE, DbVariable::FLOAT64);
+    builder.addColumn("name", DbVariable::IT_ARRAY_CHAR, DbVariable::VARCHAR);
+    builder.addColumn("blob", DbVariable::IT_ARRAY_UINT8, DbVariable::ARRAY);
+
+    MySqlDbVariable i8(DbVariable::IT_INT8, DbVariable::INT8, 1);
+    MySqlDbVariable u8(DbVariable::IT_INT8, DbVariable::UINT8, 1);
+    MySqlDbVariable i16(DbVariable::IT_INT16, DbVariable::INT16, 2);
+    MySqlDbVariable u16(DbVariable::IT_INT16, DbVariable::UINT16, 2);
+    MySqlDbVariable u32(DbVariable::IT_INT32, DbVariable::UINT32, 4);
+    MySqlDbVariable u64(DbVariable::IT_INT64, DbVariable::UINT64, 8);
+    MySqlDbVariable price(DbVariable::IT_INT64, DbVariable::INT64, 8);
+    MySqlDbVariable ratio(DbVariable::IT_DOUBLE, DbVariable::FLOAT64, 8);
+
+    const UInt64 bigU64 = 0x8000000000000005ULL;
+    const UInt8 blob[] = { 1, 0, 255, 0, 7 };
+    const std::string longName(100000, 'x');
+
+    // row 0 : limits of the signed and unsigned types
+    setVar<Int8>(i8, -5);
+    setVar<UInt8>(u8, 200);
+    setVar<Int16>(i16, -30000);
+    setVar<UInt16>(u16, 40000);
+    setVar<UInt32>(u32, 4000000000U);
+    setVar<UInt64>(u64, bigU64);
+    setVar<Int64>(price, -12345);
+    setVar<Double>(ratio, 0.25);
+
+    builder.beginRow();
+    builder.setValue(0, i8);
+    builder.setValue(1, u8);
+    builder.setValue(2, i16);
+    builder.setValue(3, u16);
+    builder.setValue(4, u32);
+    builder.setValue(5, u64);
+    builder.setValue(6, price);
+    builder.setValue(7, ratio);
+    builder.setData(8, "hello", 5);
+    builder.setData(9, blob, sizeof(blob));
+
+    // row 1 : null values, given by a null variable or by nothing
+    i8.setNull(True);
+
+    builder.beginRow();
+    builder.setValue(0, i8);
+
+    // row 2 : a value larger than any slot, and an empty one
+    builder.beginRow();
+    builder.setData(8, longName.data(), (UInt32)longName.size());
+    builder.setData(9, blob, 0);
+
+    // mismatching variable type
+    O3D_CHECK_THROW(builder.setValue(1, i16), E_InvalidParameter);
+
+    std::shared_ptr<const MySqlRowSet> rowset = builder.build();
+    O3D_CHECK(builder.getNumRows() == 0);
+
+    // a copy of the buffer must read the same, as a mapped snapshot does
+    std::vector<UInt64> copy((size_t)(rowset->getBufferSize() + 7) / 8);
+    memcpy(copy.data(), rowset->getBuffer(), (size_t)rowset->getBufferSize());
+
+    Bool released = False;
+    std::shared_ptr<const MySqlRowSet> mapped = MySqlRowSet::fromBuffer(
+                (const UInt8*)copy.data(), rowset->getBufferSize(), [&released] () { released = True; });
+
+    for (const std::shared_ptr<const MySqlRowSet> &rs : { rowset, mapped }) {
+        O3D_CHECK(rs->getNumRows() == 3);
+        O3D_CHECK(rs->getNumColumns() == 10);
+
+        O3D_CHECK(rs->getColumnName(3) == "u16");
+        O3D_CHECK(rs->getColumnIndex("name") == 8);
+        O3D_CHECK(rs->getColumnType(9) == DbVariable::IT_ARRAY_UINT8);
+        O3D_CHECK(rs->getColumnVarType(1) == DbVariable::UINT8);
+        O3D_CHECK(rs->getColumnDecimals(6) == 2);
+        O3D_CHECK(rs->getColumnDecimals(5) == 0);
+
+        O3D_CHECK(rs->asInt64(0, 0) == -5);
+        O3D_CHECK(rs->asInt64(0, 1) == 200);
+        O3D_CHECK(rs->asInt64(0, 2) == -30000);
+        O3D_CHECK(rs->asInt64(0, 3) == 40000);
+        O3D_CHECK(rs->asUInt32(0, 4) == 4000000000U);
+        O3D_CHECK(rs->asUInt64(0, 5) == bigU64);
+        O3D_CHECK(rs->asInt64(0, 6) == -12345);
+        O3D_CHECK(rs->asDouble(0, 7) == 0.25);
+
+        UInt32 length = 0;
+        const UInt8 *data = rs->getData(0, 8, &length);
+        O3D_CHECK(length == 5 && memcmp(data, "hello", 5) == 0);
+        O3D_CHECK(strcmp(rs->asCString(0, 8), "hello") == 0);
+
+        data = rs->getData(0, 9, &length);
+        O3D_CHECK(length == sizeof(blob) && memcmp(data, blob, sizeof(blob)) == 0);
+
+        for (UInt32 col = 0; col < 10; ++col) {
+            O3D_CHECK(!rs->isNull(0, col));
+            O3D_CHECK(rs->isNull(1, col));
+        }
+
+        data = rs->getData(2, 8, &length);
+        O3D_CHECK(length == longName.size() && memcmp(data, longName.data(), length) == 0);
+        O3D_CHECK(!rs->isNull(2, 9));
+        rs->getData(2, 9, &length);
+        O3D_CHECK(length == 0);
+
+        O3D_CHECK_THROW(rs->asInt64(3, 0), E_IndexOutOfRange);
+        O3D_CHECK_THROW(rs->getColumnDecimals(10), E_IndexOutOfRange);
+    }
+
+    mapped.reset();
+    O3D_CHECK(released);
+
+    // the header offsets, as written by build
+    UInt8 *buffer = (UInt8*)copy.data();
+    UInt32 nullSize;
+    UInt64 columnsOffset, rowsOffset;
+    memcpy(&nullSize, buffer + 20, 4);
+    memcpy(&columnsOffset, buffer + 24, 8);
+    memcpy(&rowsOffset, buffer + 32, 8);
+
+    // a value or a name out of the heap is rejected
+    {
+        UInt8 *slot = buffer + rowsOffset + nullSize + 8 * 8;
+        UInt32 offset, corrupted = 0xfffffff0;
+
+        memcpy(&offset, slot, 4);
+        memcpy(slot, &corrupted, 4);
+
+        O3D_CHECK_THROW(MySqlRowSet::fromBuffer(
+                            (const UInt8*)copy.data(), rowset->getBufferSize(), nullptr),
+                        E_InvalidFormat);
+
+        // length up to the end of the heap, without terminal zero
+        memcpy(slot, &offset, 4);
+        memcpy(slot + 4, &corrupted, 4);
+
+        O3D_CHECK_THROW(MySqlRowSet::fromBuffer(
+                            (const UInt8*)copy.data(), rowset->getBufferSize(), nullptr),
+                        E_InvalidFormat);
+
+        UInt32 length = 5;
+        memcpy(slot + 4, &length, 4);
+
+        UInt8 *name = buffer + columnsOffset + 8;
+        memcpy(&offset, name, 4);
+        memcpy(name, &corrupted, 4);
+
+        O3D_CHECK_THROW(MySqlRowSet::fromBuffer(
+                            (const UInt8*)copy.data(), rowset->getBufferSize(), nullptr),
+                        E_InvalidFormat);
+
+        memcpy(name, &offset, 4);
+
+        // restored
+        O3D_CHECK(MySqlRowSet::fromBuffer((const UInt8*)copy.data(), rowset->getBufferSize(), nullptr)->getNumRows() == 3);
+
+        // truncated, as a partially written snapshot
+        O3D_CHECK_THROW(MySqlRowSet::fromBuffer(
+                            (const UInt8*)copy.data(), rowset->getBufferSize() - 8, nullptr),
+                        E_InvalidFormat);
+    }
+
+    // a buffer of another format is rejected, and released
+    copy[0] ^= 1;
+    released = False;
+    O3D_CHECK_THROW(MySqlRowSet::fromBuffer(
+                        (const UInt8*)copy.data(), rowset->getBufferSize(), [&released] () { released = True; }),
+                    E_InvalidFormat);
+    O3D_CHECK(released);
+
+    // stream mode, flushing the rows and the heap while they are appended
+    {
+        const UInt32 numRows = 3000;
+        const std::string text(1000, 't');
+
+        std::stringstream out, heap;
+        out.write("12345678", 8);
+
+        MySqlRowSetBuilder streamed;
+        streamed.beginStream(out, heap);
+        streamed.addColumn("id", DbVariable::IT_INT32, DbVariable::UINT32);
+        streamed.addColumn("text", DbVariable::IT_ARRAY_CHAR, DbVariable::VARCHAR);
+
+        for (UInt32 i = 0; i < numRows; ++i) {
+            setVar<UInt32>(u32, i);
+
+            streamed.beginRow();
+            streamed.setValue(0, u32);
+
+            if (i % 7 != 0) {
+                streamed.setData(1, text.data(), i % 1000);
+            }
+        }
+
+        O3D_CHECK_THROW(streamed.build(), E_InvalidOperation);
+
+        UInt64 size = streamed.endStream();
+
+        std::string written = out.str();
+        O3D_CHECK(written.size() == 8 + size);
+
+        std::vector<UInt64> aligned((size_t)(size + 7) / 8);
+        memcpy(aligned.data(), written.data() + 8, (size_t)size);
+
+        std::shared_ptr<const MySqlRowSet> rs = MySqlRowSet::fromBuffer((const UInt8*)aligned.data(), size, nullptr);
+
+        O3D_CHECK(rs->getNumRows() == numRows);
+        O3D_CHECK(rs->getColumnName(1) == "text");
+
+        Bool same = True;
+        for (UInt32 i = 0; i < numRows; ++i) {
+            UInt32 length = 0;
+            const UInt8 *data = rs->getData(i, 1, &length);
+
+            same = same && rs->asUInt32(i, 0) == i;
+
+            if (i % 7 == 0) {
+                same = same && rs->isNull(i, 1);
+            } else {
+                same = same && length == i % 1000 && memcmp(data, text.data(), length) == 0 && data[length] == 0;
+            }
+        }
+
+        O3D_CHECK(same);
+
+        // without any row
+        std::stringstream emptyOut, emptyHeap;
+        streamed.beginStream(emptyOut, emptyHeap);
+        streamed.addColumn("id", DbVariable::IT_INT32, DbVariable::INT32);
+        size = streamed.endStream();
+
+        written = emptyOut.str();
+        aligned.assign((size_t)(size + 7) / 8, 0);
+        memcpy(aligned.data(), written.data(), (size_t)size);
+
+        rs = MySqlRowSet::fromBuffer((const UInt8*)aligned.data(), size, nullptr);
+        O3D_CHECK(rs->getNumRows() == 0 && rs->getNumColumns() == 1);
+    }
+}
@@ -0,0 +1,185 @@
+/**
+ * @file testsingleflight.cpp
+ * @brief Unit test of the coalescing of MySqlSingleFlight.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#include "unittest.h"
+
+#include <o3d/mysql/mysqlsingleflight.h>
+#include <o3d/mysql/mysqlexception.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace o3d;
+using namespace o3d::mysql;
+
+static const UInt32 NUM_FOLLOWERS = 4;
+
+//! Wait until a condition holds, False after a second.
+template <class F>
+static Bool waitFor(F condition)
+{
+    for (Int32 i = 0; i < 1000; ++i) {
+        if (condition()) {
+            return True;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    return False;
+}
+
+static MySqlSingleFlight::Result makeResult()
+{
+    MySqlRowSetBuilder builder;
+    builder.addColumn("id", DbVariable::IT_INT32, DbVariable::INT32);
+
+    return builder.build();
+}
+
+void unittest::testSingleFlight()
+{
+    MySqlParams params;
+    params.setInt32(0, 7);
+
+    // the key of the name and the parameters
+    {
+        MySqlParams other;
+        other.setInt64(0, 7);
+
+        O3D_CHECK(MySqlSingleFlight::key("byId", params) == params.key("byId"));
+        O3D_CHECK(MySqlSingleFlight::key("byId", params) == MySqlSingleFlight::key("byId", other));
+        O3D_CHECK(MySqlSingleFlight::key("byId", params) != MySqlSingleFlight::key("byName", params));
+
+        other.setInt64(0, 8);
+        O3D_CHECK(MySqlSingleFlight::key("byId", params) != MySqlSingleFlight::key("byId", other));
+    }
+
+    // the concurrent reads wait for the leader and share its result
+    {
+        MySqlSingleFlight flight;
+        MySqlSingleFlight::Result expected = makeResult();
+
+        std::atomic<Bool> started(False);
+        std::atomic<Bool> release(False);
+        std::atomic<UInt32> numLoads(0);
+
+        auto loader = [&] () {
+            ++numLoads;
+            started = True;
+
+            while (!release) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+
+            return expected;
+        };
+
+        std::vector<MySqlSingleFlight::Result> results(NUM_FOLLOWERS + 1);
+        std::vector<std::thread> threads;
+
+        threads.emplace_back([&] () { results[0] = flight.execute("byId", params, loader); });
+        O3D_CHECK(waitFor([&] () { return started.load(); }));
+
+        for (UInt32 i = 1; i <= NUM_FOLLOWERS; ++i) {
+            threads.emplace_back([&, i] () { results[i] = flight.execute("byId", params, loader); });
+        }
+
+        O3D_CHECK(waitFor([&] () { return flight.getStats().shared == NUM_FOLLOWERS; }));
+        O3D_CHECK(flight.getNumInFlight() == 1);
+
+        release = True;
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+
+        O3D_CHECK(numLoads == 1);
+        O3D_CHECK(flight.getStats().executes == 1);
+        O3D_CHECK(flight.getNumInFlight() == 0);
+
+        for (const MySqlSingleFlight::Result &result : results) {
+            O3D_CHECK(result == expected);
+        }
+
+        // once done, a read loads again
+        flight.execute("byId", params, loader);
+        O3D_CHECK(numLoads == 2);
+        O3D_CHECK(flight.getStats().executes == 2);
+    }
+
+    // the error of the leader is raised to every waiting read
+    {
+        MySqlSingleFlight flight;
+
+        std::atomic<Bool> started(False);
+        std::atomic<Bool> release(False);
+
+        auto loader = [&] () -> MySqlSingleFlight::Result {
+            started = True;
+
+            while (!release) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+
+            O3D_ERROR(E_MySqlError("Lost connection"));
+        };
+
+        std::atomic<UInt32> numErrors(0);
+        std::vector<std::thread> threads;
+
+        auto read = [&] () {
+            try {
+                flight.execute("byId", params, loader);
+            } catch (E_MySqlError &) {
+                ++numErrors;
+            }
+        };
+
+        threads.emplace_back(read);
+        O3D_CHECK(waitFor([&] () { return started.load(); }));
+
+        for (UInt32 i = 0; i < NUM_FOLLOWERS; ++i) {
+            threads.emplace_back(read);
+        }
+
+        O3D_CHECK(waitFor([&] () { return flight.getStats().shared == NUM_FOLLOWERS; }));
+
+        release = True;
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+
+        O3D_CHECK(numErrors == NUM_FOLLOWERS + 1);
+        O3D_CHECK(flight.getNumInFlight() == 0);
+
+        // not kept, the next read loads again
+        O3D_CHECK_THROW(flight.execute("byId", params, loader), E_MySqlError);
+        O3D_CHECK(flight.getStats().executes == 2);
+    }
+
+    // other parameters are another read
+    {
+        MySqlSingleFlight flight;
+        MySqlParams other;
+        other.setInt32(0, 8);
+
+        MySqlSingleFlight::Result inner;
+
+        MySqlSingleFlight::Result outer = flight.execute("byId", params, [&] () {
+            inner = flight.execute("byId", other, [] () { return makeResult(); });
+            return makeResult();
+        });
+
+        O3D_CHECK(inner && outer && inner != outer);
+        O3D_CHECK(flight.getStats().executes == 2);
+        O3D_CHECK(flight.getStats().shared == 0);
+    }
+}
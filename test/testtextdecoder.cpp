@@ -0,0 +1,191 @@
+/**
+ * @file testtextdecoder.cpp
+ * @brief Unit test of the UTF-8 validation and decoding of MySqlTextDecoder.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#include "unittest.h"
+
+#include <o3d/mysql/mysqltextdecoder.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace o3d;
+using namespace o3d::mysql;
+
+static const WChar REPLACEMENT = 0xFFFD;
+
+//! Decode a text, returning the decoded characters.
+static std::vector<WChar> decodeText(MySqlTextDecoder &decoder, const std::string &text)
+{
+    UInt32 length = 0;
+    const WChar *out = decoder.decode(text.data(), text.length(), length);
+
+    return std::vector<WChar>(out, out + length);
+}
+
+//! Check that every instruction set gives the same results as the scalar one.
+static void checkIsas(const std::string &text)
+{
+    MySqlTextDecoder scalar;
+    scalar.setIsa(MySqlTextDecoder::ISA_SCALAR);
+
+    MySqlTextDecoder decoder;
+
+    for (Int32 isa = MySqlTextDecoder::ISA_SSE2; isa <= MySqlTextDecoder::getBestIsa(); ++isa) {
+        decoder.setIsa((MySqlTextDecoder::Isa)isa);
+
+        // every offset and length, crossing the 16 and 32 bytes blocks
+        for (size_t begin = 0; begin < 40 && begin < text.length(); ++begin) {
+            for (size_t end = begin; end <= text.length(); end += 7) {
+                std::string part = text.substr(begin, end - begin);
+
+                O3D_CHECK(decoder.isAscii(part.data(), part.length()) ==
+                          scalar.isAscii(part.data(), part.length()));
+                O3D_CHECK(decoder.validate(part.data(), part.length()) ==
+                          scalar.validate(part.data(), part.length()));
+                O3D_CHECK(decodeText(decoder, part) == decodeText(scalar, part));
+            }
+        }
+    }
+}
+
+void unittest::testTextDecoder()
+{
+    MySqlTextDecoder decoder;
+
+    O3D_CHECK(!decoder.isStrict());
+    O3D_CHECK(decoder.getIsa() == MySqlTextDecoder::getBestIsa());
+
+    // an unsupported instruction set is rejected
+    if (MySqlTextDecoder::getBestIsa() < MySqlTextDecoder::ISA_AVX2) {
+        O3D_CHECK_THROW(decoder.setIsa(MySqlTextDecoder::ISA_AVX2), E_InvalidParameter);
+    }
+
+    // 1 to 4 bytes sequences, the 4 bytes one above U+FFFF
+    {
+        std::string text("a\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80z");
+        std::vector<WChar> out = decodeText(decoder, text);
+
+        std::vector<WChar> expected = { 'a', 0xE9, 0x20AC };
+        if (sizeof(WChar) == 2) {
+            // as a surrogate pair
+            expected.push_back((WChar)0xD83D);
+            expected.push_back((WChar)0xDE00);
+        } else {
+            expected.push_back((WChar)0x1F600);
+        }
+        expected.push_back('z');
+
+        O3D_CHECK(out == expected);
+        O3D_CHECK(decoder.validate(text.data(), text.length()));
+        O3D_CHECK(!decoder.isAscii(text.data(), text.length()));
+    }
+
+    // bounds of the valid ranges
+    {
+        const Char *valid[] = {
+            "\x7f",                 // U+007F
+            "\xc2\x80",             // U+0080
+            "\xed\x9f\xbf",         // U+D7FF, below the surrogates
+            "\xee\x80\x80",         // U+E000, above the surrogates
+            "\xef\xbf\xbf",         // U+FFFF
+            "\xf0\x90\x80\x80",     // U+10000
+            "\xf4\x8f\xbf\xbf"      // U+10FFFF
+        };
+
+        for (const Char *text : valid) {
+            O3D_CHECK(decoder.validate(text, strlen(text)));
+        }
+
+        std::vector<WChar> out = decodeText(decoder, "\xf4\x8f\xbf\xbf");
+        if (sizeof(WChar) == 2) {
+            O3D_CHECK(out.size() == 2 && out[0] == (WChar)0xDBFF && out[1] == (WChar)0xDFFF);
+        } else {
+            O3D_CHECK(out.size() == 1 && out[0] == (WChar)0x10FFFF);
+        }
+    }
+
+    // invalid, overlong, surrogates, out of range and truncated sequences
+    {
+        const Char *invalid[] = {
+            "\x80",                 // lone continuation
+            "\xc0\xaf",             // overlong '/'
+            "\xc1\xbf",             // overlong U+007F
+            "\xe0\x80\xaf",         // overlong '/' on 3 bytes
+            "\xe0\x9f\xbf",         // overlong U+07FF
+            "\xf0\x80\x80\xaf",     // overlong '/' on 4 bytes
+            "\xf0\x8f\xbf\xbf",     // overlong U+FFFF
+            "\xed\xa0\x80",         // high surrogate U+D800
+            "\xed\xbf\xbf",         // low surrogate U+DFFF
+            "\xf4\x90\x80\x80",     // U+110000
+            "\xf5\x80\x80\x80",
+            "\xff",
+            "\xe2\x82",             // truncated
+            "\xc3"
+        };
+
+        MySqlTextDecoder strict;
+        strict.setStrict(True);
+
+        for (const Char *text : invalid) {
+            size_t length = strlen(text);
+
+            O3D_CHECK(!decoder.validate(text, length));
+
+            // within runs of ASCII, passing through the wide blocks
+            std::string padded = std::string(37, 'x') + text + std::string(41, 'y');
+            O3D_CHECK(!decoder.validate(padded.data(), padded.length()));
+
+            // each byte of an invalid sequence replaced, resynchronizing on the next one
+            std::vector<WChar> out = decodeText(decoder, text);
+            O3D_CHECK(out.size() == length);
+
+            for (WChar c : out) {
+                O3D_CHECK(c == REPLACEMENT);
+            }
+
+            out = decodeText(decoder, padded);
+            O3D_CHECK(out.size() == padded.length());
+            O3D_CHECK(out[36] == 'x' && out[37] == REPLACEMENT && out[37 + length] == 'y');
+
+            UInt32 outLength;
+            O3D_CHECK_THROW(strict.decode(text, length, outLength), E_InvalidFormat);
+            O3D_CHECK_THROW(strict.decode(padded.data(), padded.length(), outLength), E_InvalidFormat);
+        }
+    }
+
+    // empty text
+    {
+        UInt32 outLength = 1;
+        const WChar *out = decoder.decode("", 0, outLength);
+
+        O3D_CHECK(outLength == 0 && out[0] == 0);
+        O3D_CHECK(decoder.isAscii("", 0) && decoder.validate("", 0));
+    }
+
+    // the wide instruction sets agree with the scalar one
+    {
+        std::string text;
+        for (Int32 i = 0; i < 4; ++i) {
+            text += "The quick brown fox jumps over the lazy dog, 0123456789. ";
+            text += "caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x80";
+            text += std::string(i * 5, '-');
+        }
+
+        checkIsas(text);
+        checkIsas(std::string(100, 'a'));
+
+        // an invalid byte after a run of ASCII, at every place of a block
+        for (size_t pos = 0; pos < 40; pos += 3) {
+            std::string broken(80, 'b');
+            broken[pos] = (Char)0x80;
+            checkIsas(broken);
+        }
+    }
+}
@@ -0,0 +1,176 @@
+/**
+ * @file testwritebehind.cpp
+ * @brief Unit test of the merges of MySqlWriteBehind.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#include "unittest.h"
+
+#include <o3d/mysql/mysqlwritebehind.h>
+#include <o3d/mysql/mysqldb.h>
+#include <o3d/mysql/mysqlexception.h>
+
+#include <vector>
+
+using namespace o3d;
+using namespace o3d::mysql;
+
+//! Record the sent rows in place of the server, failing once failAt rows are sent.
+class RecordingWriteBehind : public MySqlWriteBehind
+{
+public:
+
+    RecordingWriteBehind(MySqlDb *db, UInt32 maxRows) :
+        MySqlWriteBehind(db, "counters", 0, maxRows),
+        failAt(-1),
+        concurrent(False)
+    {
+        addColumn("id", MERGE_KEY);
+        addColumn("name", MERGE_REPLACE);
+        addColumn("hits", MERGE_ADD);
+    }
+
+    Int32 failAt;               //!< -1 to never fail
+    Bool concurrent;            //!< Write newerRow during the next send
+    MySqlParams newerRow;
+    std::vector<MySqlParams> sent;
+
+protected:
+
+    virtual void send(const std::vector<MySqlParams> &rows, size_t &numSent) override
+    {
+        if (concurrent) {
+            concurrent = False;
+            write(newerRow);
+        }
+
+        while (numSent < rows.size()) {
+            if (failAt >= 0 && numSent == (size_t)failAt) {
+                O3D_ERROR(E_MySqlError("Lost connection"));
+            }
+
+            sent.push_back(rows[numSent]);
+            ++numSent;
+        }
+    }
+};
+
+static MySqlParams makeRow(Int32 id, const Char *name, Int32 hits)
+{
+    MySqlParams row;
+    row.setInt32(0, id);
+    row.setCString(1, name);
+    row.setInt32(2, hits);
+    return row;
+}
+
+static Bool sameRow(const MySqlParams &row, Int32 id, const Char *name, Int64 hits)
+{
+    MySqlParams expected;
+    expected.setInt64(0, id);
+    expected.setCString(1, name);
+    expected.setInt64(2, hits);
+
+    return row.equal(0, expected) && row.equal(1, expected) && row.equal(2, expected);
+}
+
+void unittest::testWriteBehind()
+{
+    MySqlDb db;
+
+    // the last name replaces, the hits are summed
+    {
+        RecordingWriteBehind wb(&db, 100);
+
+        wb.write(makeRow(1, "a", 1));
+        wb.write(makeRow(2, "b", 5));
+        wb.write(makeRow(1, "c", 2));
+
+        O3D_CHECK(wb.getNumPending() == 2);
+        O3D_CHECK(wb.getStats().writes == 3);
+        O3D_CHECK(wb.getStats().coalesced == 1);
+
+        wb.flush();
+
+        O3D_CHECK(wb.getNumPending() == 0);
+        O3D_CHECK(wb.sent.size() == 2);
+        O3D_CHECK(sameRow(wb.sent[0], 1, "c", 3));
+        O3D_CHECK(sameRow(wb.sent[1], 2, "b", 5));
+    }
+
+    // the unsent rows of a failed flush are merged back under the newer writes
+    {
+        RecordingWriteBehind wb(&db, 100);
+
+        wb.write(makeRow(1, "a", 1));
+        wb.write(makeRow(2, "b", 1));
+        wb.write(makeRow(3, "c", 1));
+
+        wb.failAt = 1;
+        wb.concurrent = True;
+        wb.newerRow = makeRow(2, "x", 10);
+
+        O3D_CHECK_THROW(wb.flush(), E_MySqlError);
+
+        // the first row is committed, the second takes the newer name and sums the hits
+        O3D_CHECK(wb.sent.size() == 1);
+        O3D_CHECK(sameRow(wb.sent[0], 1, "a", 1));
+        O3D_CHECK(wb.getNumPending() == 2);
+        O3D_CHECK(wb.getStats().failures == 1);
+
+        wb.failAt = -1;
+        wb.sent.clear();
+        wb.flush();
+
+        O3D_CHECK(wb.sent.size() == 2);
+        O3D_CHECK(sameRow(wb.sent[0], 2, "x", 11));
+        O3D_CHECK(sameRow(wb.sent[1], 3, "c", 1));
+        O3D_CHECK(wb.getNumPending() == 0);
+    }
+
+    // bounded while the flushes fail
+    {
+        RecordingWriteBehind wb(&db, 2);
+        wb.failAt = 0;
+
+        wb.write(makeRow(1, "a", 1));
+
+        // reaching max rows flushes, failing
+        O3D_CHECK_THROW(wb.write(makeRow(2, "b", 1)), E_MySqlError);
+        O3D_CHECK(wb.getNumPending() == 2);
+
+        // a new key is rejected, the pending ones are still merged
+        O3D_CHECK_THROW(wb.write(makeRow(3, "c", 1)), E_MySqlOverload);
+        O3D_CHECK(wb.getNumPending() == 2);
+
+        O3D_CHECK_THROW(wb.write(makeRow(1, "a", 4)), E_MySqlError);
+        O3D_CHECK(wb.getNumPending() == 2);
+
+        // accepted again once a flush succeeded
+        wb.failAt = -1;
+        wb.flush();
+
+        O3D_CHECK(wb.sent.size() == 2);
+        O3D_CHECK(sameRow(wb.sent[0], 1, "a", 5));
+
+        wb.write(makeRow(3, "c", 1));
+        O3D_CHECK(wb.getNumPending() == 1);
+    }
+
+    // a row must set every column, the counters being numeric
+    {
+        RecordingWriteBehind wb(&db, 100);
+
+        MySqlParams row;
+        row.setInt32(0, 1);
+        row.setCString(1, "a");
+
+        O3D_CHECK_THROW(wb.write(row), E_InvalidParameter);
+
+        row.setCString(2, "1");
+        O3D_CHECK_THROW(wb.write(row), E_InvalidParameter);
+    }
+}
@@ -0,0 +1,63 @@
+/**
+ * @file unittest.cpp
+ * @brief Unit tests of the parts of the module running without server.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#include "unittest.h"
+
+#include <iostream>
+
+using namespace o3d;
+using namespace o3d::mysql;
+
+static UInt32 failures = 0;
+
+void unittest::fail(const Char *file, Int32 line, const Char *expr)
+{
+    ++failures;
+    std::cout << "  " << file << ":" << line << ": check failed: " << expr << std::endl;
+}
+
+struct Test
+{
+    const Char *name;
+    void (*run)();
+};
+
+static const Test TESTS[] = {
+    { "rowset", unittest::testRowSet },
+    { "bulkrow", unittest::testBulkRow },
+    { "exporter", unittest::testExporter },
+    { "decoder", unittest::testDecoder },
+    { "params", unittest::testParams },
+    { "admission", unittest::testAdmission },
+    { "singleflight", unittest::testSingleFlight },
+    { "textdecoder", unittest::testTextDecoder },
+    { "writebehind", unittest::testWriteBehind },
+    { "binlog", unittest::testBinlog }
+};
+
+UInt32 unittest::runAll()
+{
+    failures = 0;
+
+    for (const Test &test : TESTS) {
+        std::cout << "Unit test " << test.name << "..." << std::endl;
+
+        UInt32 previous = failures;
+
+        try {
+            test.run();
+        } catch (...) {
+            fail(test.name, 0, "unexpected exception");
+        }
+
+        std::cout << (failures == previous ? "  ok" : "  FAILED") << std::endl;
+    }
+
+    return failures;
+}
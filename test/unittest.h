@@ -0,0 +1,66 @@
+/**
+ * @file unittest.h
+ * @brief Unit tests of the parts of the module running without server.
+ * @author Frederic SCHERMA (frederic.scherma@dreamoverflow.org)
+ * @date 2026-10-19
+ * @copyright Copyright (c) 2001-2017 Dream Overflow. All rights reserved.
+ * @details
+ */
+
+#ifndef _O3D_MYSQLUNITTEST_H
+#define _O3D_MYSQLUNITTEST_H
+
+#include <o3d/core/base.h>
+
+namespace o3d {
+namespace mysql {
+namespace unittest {
+
+//! Report a failed check.
+void fail(const Char *file, Int32 line, const Char *expr);
+
+/**
+ * @brief Run every unit test, each one going on after a failed check.
+ * @return The number of failed checks.
+ */
+UInt32 runAll();
+
+// one per tested module
+void testRowSet();
+void testBulkRow();
+void testExporter();
+void testDecoder();
+void testParams();
+void testAdmission();
+void testSingleFlight();
+void testTextDecoder();
+void testWriteBehind();
+void testBinlog();
+
+} // namespace unittest
+} // namespace mysql
+} // namespace o3d
+
+//! Check an expression, reporting it if false.
+#define O3D_CHECK(EXPR) \
+    do { \
+        if (!(EXPR)) { \
+            o3d::mysql::unittest::fail(__FILE__, __LINE__, #EXPR); \
+        } \
+    } while (0)
+
+//! Check that a statement throws a given exception.
+#define O3D_CHECK_THROW(STATEMENT, EXCEPTION) \
+    do { \
+        o3d::Bool _thrown = o3d::False; \
+        try { \
+            STATEMENT; \
+        } catch (EXCEPTION &) { \
+            _thrown = o3d::True; \
+        } \
+        if (!_thrown) { \
+            o3d::mysql::unittest::fail(__FILE__, __LINE__, #STATEMENT " throws " #EXCEPTION); \
+        } \
+    } while (0)
+
+#endif // _O3D_MYSQLUNITTEST_H